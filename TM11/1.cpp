@@ -1,676 +1,10998 @@
-#include <iostream>
-#include <vector>
-#include <memory>
-#include <string>
-#include <algorithm>
-#include <iomanip>
-#include <map>
-
-using namespace std;
-
-// ===========================
-// KELAS ITEM (BASE CLASS)
-// ===========================
-class Item {
-protected:
-    string id;
-    string judul;
-    bool tersedia;
-
-public:
-    // konstruktor yang lit
-    Item(string id, string judul) : id(id), judul(judul), tersedia(true) {}
-    
-    virtual ~Item() = default;
-
-    // getter setter biar encapsulation on point
-    string getId() const { return id; }
-    string getJudul() const { return judul; }
-    bool isTersedia() const { return tersedia; }
-    void setTersedia(bool status) { tersedia = status; }
-
-    // method virtual pure biar anak2nya wajib override - no cap
-    virtual int maxHariPinjam() const = 0;
-    virtual double hitungDenda(int hariTerlambat) const = 0;
-    virtual unique_ptr<Item> clone() const = 0;
-    virtual string getTipe() const = 0;
-
-    // operator overload buat sorting katalog - ez clap
-    bool operator<(const Item& lain) const {
-        return id < lain.id;
-    }
-
-    virtual void tampilInfo() const {
-        cout << "ID: " << id << " | Judul: " << judul 
-             << " | Status: " << (tersedia ? "Tersedia" : "Dipinjam") << endl;
-    }
-};
-
-// ===========================
-// KELAS BOOK (CHILD CLASS)
-// ===========================
-class Book : public Item {
-private:
-    string penulis;
-    bool langka;
-
-public:
-    Book(string id, string judul, string penulis, bool langka = false)
-        : Item(id, judul), penulis(penulis), langka(langka) {}
-
-    // override method - buku langka beda treatment cuy
-    int maxHariPinjam() const override {
-        return langka ? 3 : 14;  // buku langka cuma 3 hari, biasa 14 hari
-    }
-
-    double hitungDenda(int hariTerlambat) const override {
-        return 1000.0 * hariTerlambat;  // denda 1000 per hari - sabi
-    }
-
-    unique_ptr<Item> clone() const override {
-        return make_unique<Book>(*this);
-    }
-
-    string getTipe() const override { return "Book"; }
-
-    void tampilInfo() const override {
-        Item::tampilInfo();
-        cout << "  Penulis: " << penulis << " | Langka: " << (langka ? "Ya" : "Tidak") << endl;
-    }
-};
-
-// ===========================
-// KELAS MAGAZINE (CHILD CLASS)
-// ===========================
-class Magazine : public Item {
-private:
-    string edisi;
-
-public:
-    Magazine(string id, string judul, string edisi)
-        : Item(id, judul), edisi(edisi) {}
-
-    int maxHariPinjam() const override {
-        return 7;  // majalah cuma seminggu - standar lah
-    }
-
-    double hitungDenda(int hariTerlambat) const override {
-        return 500.0 * hariTerlambat;  // lebih murah dari buku
-    }
-
-    unique_ptr<Item> clone() const override {
-        return make_unique<Magazine>(*this);
-    }
-
-    string getTipe() const override { return "Magazine"; }
-
-    void tampilInfo() const override {
-        Item::tampilInfo();
-        cout << "  Edisi: " << edisi << endl;
-    }
-};
-
-// ===========================
-// KELAS DVD (CHILD CLASS)
-// ===========================
-class DVD : public Item {
-private:
-    string sutradara;
-
-public:
-    DVD(string id, string judul, string sutradara)
-        : Item(id, judul), sutradara(sutradara) {}
-
-    int maxHariPinjam() const override {
-        return 3;  // DVD cepet banget - 3 hari doang
-    }
-
-    // method biasa
-    double hitungDenda(int hariTerlambat) const override {
-        return 2000.0 * hariTerlambat;  // paling mahal dendanya bossku
-    }
-
-    // OVERLOAD method - ini yang diminta soal, bisa tambah biaya rusak
-    double hitungDenda(int hariTerlambat, bool rusak) const {
-        double dendaDasar = hitungDenda(hariTerlambat);
-        if (rusak) {
-            return dendaDasar + 50000.0;  // rusak langsung +50k - sakit
-        }
-        return dendaDasar;
-    }
-
-    unique_ptr<Item> clone() const override {
-        return make_unique<DVD>(*this);
-    }
-
-    string getTipe() const override { return "DVD"; }
-
-    void tampilInfo() const override {
-        Item::tampilInfo();
-        cout << "  Sutradara: " << sutradara << endl;
-    }
-};
-
-// ===========================
-// KELAS MEMBER
-// ===========================
-class Member {
-private:
-    string id;
-    string nama;
-    int level;
-    int kreditGratis;
-    int totalPinjaman;
-    int pinjamanSukses;
-
-public:
-    Member(string id, string nama) 
-        : id(id), nama(nama), level(0), kreditGratis(0), 
-          totalPinjaman(0), pinjamanSukses(0) {}
-
-    // getter buat ngecek status member
-    string getId() const { return id; }
-    string getNama() const { return nama; }
-    int getLevel() const { return level; }
-    int getKreditGratis() const { return kreditGratis; }
-    int getTotalPinjaman() const { return totalPinjaman; }
-
-    // method borrow yang basic - no kredit dipakai
-    bool pinjam(Item& item, int hariDiminta) {
-        if (!item.isTersedia()) {
-            cout << "❌ Waduh, item lagi dipinjam orang lain bro!" << endl;
-            return false;
-        }
-
-        if (hariDiminta > item.maxHariPinjam()) {
-            cout << "❌ Kebanyakan hari cuy! Max cuma " << item.maxHariPinjam() 
-                 << " hari untuk item ini" << endl;
-            return false;
-        }
-
-        if (hariDiminta <= 0) {
-            cout << "❌ Hari pinjam harus lebih dari 0 lah!" << endl;
-            return false;
-        }
-
-        item.setTersedia(false);
-        totalPinjaman++;
-        cout << "✅ Sip, berhasil pinjam! Jangan lupa balikin ya~" << endl;
-        return true;
-    }
-
-    // OVERLOAD method borrow - bisa pake kredit gratis nih
-    bool pinjam(Item& item, int hariDiminta, bool pakeKredit) {
-        if (pakeKredit && kreditGratis > 0) {
-            cout << "🎁 Pake kredit gratis nih! Sisa: " << (kreditGratis - 1) << endl;
-            kreditGratis--;
-            // tetep harus validasi dulu sebelum pake kredit
-            if (!item.isTersedia()) {
-                cout << "❌ Item lagi dipinjam, kredit balik deh" << endl;
-                kreditGratis++;
-                return false;
-            }
-            item.setTersedia(false);
-            totalPinjaman++;
-            return true;
-        }
-        return pinjam(item, hariDiminta);
-    }
-
-    // method buat balikin item + hitung denda kalo telat
-    double balikinItem(Item& item, int hariAktual) {
-        if (item.isTersedia()) {
-            cout << "❌ Lah, item ini ga dipinjam kok!" << endl;
-            return 0.0;
-        }
-
-        item.setTersedia(true);
-        pinjamanSukses++;
-        
-        int hariTerlambat = hariAktual - item.maxHariPinjam();
-        double denda = 0.0;
-
-        if (hariTerlambat > 0) {
-            denda = item.hitungDenda(hariTerlambat);
-            cout << "⚠️  Telat " << hariTerlambat << " hari! Denda: Rp" 
-                 << fixed << setprecision(0) << denda << endl;
-        } else {
-            cout << "✅ Tepat waktu! Good job bro 👍" << endl;
-        }
-
-        // cek upgrade level - ini logika level upnya
-        cekUpgradeLevel();
-        
-        return denda;
-    }
-
-    // method buat balikin DVD dengan opsi rusak - overload hitungDenda dipake disini
-    double balikinDVD(DVD& dvd, int hariAktual, bool rusak) {
-        if (dvd.isTersedia()) {
-            cout << "❌ DVD ini ga dipinjam!" << endl;
-            return 0.0;
-        }
-
-        dvd.setTersedia(true);
-        pinjamanSukses++;
-
-        int hariTerlambat = hariAktual - dvd.maxHariPinjam();
-        double denda = 0.0;
-
-        if (hariTerlambat > 0 || rusak) {
-            // pake overload method - yang ada parameter rusak
-            denda = dvd.hitungDenda(max(0, hariTerlambat), rusak);
-            cout << "⚠️  Denda total: Rp" << fixed << setprecision(0) << denda;
-            if (rusak) cout << " (termasuk biaya rusak Rp50.000)";
-            cout << endl;
-        } else {
-            cout << "✅ Mantap, DVD balik dalam kondisi aman!" << endl;
-        }
-
-        cekUpgradeLevel();
-        return denda;
-    }
-
-private:
-    // method internal buat naik level - system reward gitu
-    void cekUpgradeLevel() {
-        int levelLama = level;
-        
-        // Level 0 -> 1: butuh 5 pinjaman sukses
-        if (level == 0 && pinjamanSukses >= 5) {
-            level = 1;
-            kreditGratis += 1;  // bonus 1 kredit
-        }
-        // Level 1 -> 2: butuh 10 pinjaman sukses total
-        else if (level == 1 && pinjamanSukses >= 10) {
-            level = 2;
-            kreditGratis += 3;  // bonus 3 kredit - mantap
-        }
-
-        // kasih notif kalo naik level
-        if (level > levelLama) {
-            cout << "🎉 LEVEL UP! Sekarang level " << level 
-                 << "! Dapet " << (level == 1 ? 1 : 3) 
-                 << " kredit gratis!" << endl;
-        }
-    }
-
-public:
-    void tampilInfo() const {
-        cout << "\n👤 Member Info:" << endl;
-        cout << "ID: " << id << " | Nama: " << nama << endl;
-        cout << "Level: " << level << " | Kredit Gratis: " << kreditGratis << endl;
-        cout << "Total Pinjaman: " << totalPinjaman 
-             << " | Sukses: " << pinjamanSukses << endl;
-    }
-};
-
-// ===========================
-// KELAS PERPUSTAKAAN (MAIN SYSTEM)
-// ===========================
-class Perpustakaan {
-private:
-    vector<unique_ptr<Item>> katalog;
-    vector<unique_ptr<Member>> daftarMember;
-    
-    // statistik bulanan - buat laporan
-    map<string, int> pinjamanPerTipe;
-    double totalDendaBulanIni;
-    int totalKreditTerpakai;
-
-public:
-    Perpustakaan() : totalDendaBulanIni(0.0), totalKreditTerpakai(0) {}
-
-    // tambah item ke katalog
-    void tambahItem(unique_ptr<Item> item) {
-        if (cariItemById(item->getId()) != nullptr) {
-            cout << "❌ ID udah ada cuy! Pake ID lain dong" << endl;
-            return;
-        }
-        katalog.push_back(move(item));
-        cout << "✅ Item berhasil ditambah ke katalog!" << endl;
-    }
-
-    // register member baru
-    void registerMember(unique_ptr<Member> member) {
-        if (cariMemberById(member->getId()) != nullptr) {
-            cout << "❌ ID member udah kepake!" << endl;
-            return;
-        }
-        daftarMember.push_back(move(member));
-        cout << "✅ Member berhasil terdaftar!" << endl;
-    }
-
-    // cari item by ID
-    Item* cariItemById(const string& id) {
-        for (auto& item : katalog) {
-            if (item->getId() == id) {
-                return item.get();
-            }
-        }
-        return nullptr;
-    }
-
-    // cari member by ID
-    Member* cariMemberById(const string& id) {
-        for (auto& member : daftarMember) {
-            if (member->getId() == id) {
-                return member.get();
-            }
-        }
-        return nullptr;
-    }
-
-    // sorting katalog by ID - pake operator overload yang udah dibuat
-    void sortKatalog() {
-        sort(katalog.begin(), katalog.end(), 
-            [](const unique_ptr<Item>& a, const unique_ptr<Item>& b) {
-                return *a < *b;
-            });
-        cout << "✅ Katalog udah di-sort!" << endl;
-    }
-
-    // tampilkan semua katalog
-    void tampilkanKatalog() const {
-        cout << "\n📚 === KATALOG PERPUSTAKAAN ===" << endl;
-        if (katalog.empty()) {
-            cout << "Kosong bro, belum ada item" << endl;
-            return;
-        }
-        for (const auto& item : katalog) {
-            item->tampilInfo();
-            cout << "---" << endl;
-        }
-    }
-
-    // tampilkan semua member
-    void tampilkanMember() const {
-        cout << "\n👥 === DAFTAR MEMBER ===" << endl;
-        if (daftarMember.empty()) {
-            cout << "Belum ada member yang daftar nih" << endl;
-            return;
-        }
-        for (const auto& member : daftarMember) {
-            member->tampilInfo();
-            cout << "---" << endl;
-        }
-    }
-
-    // proses peminjaman
-    void prosesPinjam(const string& idMember, const string& idItem, 
-                      int hari, bool pakeKredit = false) {
-        Member* member = cariMemberById(idMember);
-        Item* item = cariItemById(idItem);
-
-        if (!member) {
-            cout << "❌ Member ga ketemu!" << endl;
-            return;
-        }
-        if (!item) {
-            cout << "❌ Item ga ada di katalog!" << endl;
-            return;
-        }
-
-        bool sukses = member->pinjam(*item, hari, pakeKredit);
-        if (sukses) {
-            pinjamanPerTipe[item->getTipe()]++;
-            if (pakeKredit) totalKreditTerpakai++;
-        }
-    }
-
-    // proses pengembalian item biasa
-    void prosesKembali(const string& idMember, const string& idItem, int hariAktual) {
-        Member* member = cariMemberById(idMember);
-        Item* item = cariItemById(idItem);
-
-        if (!member || !item) {
-            cout << "❌ Member atau item ga ketemu!" << endl;
-            return;
-        }
-
-        double denda = member->balikinItem(*item, hariAktual);
-        totalDendaBulanIni += denda;
-    }
-
-    // proses pengembalian DVD dengan cek rusak
-    void prosesKembaliDVD(const string& idMember, const string& idDVD, 
-                          int hariAktual, bool rusak) {
-        Member* member = cariMemberById(idMember);
-        Item* item = cariItemById(idDVD);
-
-        if (!member || !item) {
-            cout << "❌ Member atau DVD ga ketemu!" << endl;
-            return;
-        }
-
-        DVD* dvd = dynamic_cast<DVD*>(item);
-        if (!dvd) {
-            cout << "❌ Item bukan DVD cuy!" << endl;
-            return;
-        }
-
-        double denda = member->balikinDVD(*dvd, hariAktual, rusak);
-        totalDendaBulanIni += denda;
-    }
-
-    // laporan bulanan - statistik lengkap
-    void laporanBulanan() const {
-        cout << "\n📊 === LAPORAN BULANAN PERPUSTAKAAN ===" << endl;
-        cout << "\n📖 Peminjaman per Tipe:" << endl;
-        if (pinjamanPerTipe.empty()) {
-            cout << "  Belum ada peminjaman bulan ini" << endl;
-        } else {
-            for (const auto& pair : pinjamanPerTipe) {
-                cout << "  " << pair.first << ": " << pair.second << " kali" << endl;
-            }
-        }
-        
-        cout << "\n💰 Total Denda Bulan Ini: Rp" 
-             << fixed << setprecision(0) << totalDendaBulanIni << endl;
-        cout << "🎁 Total Kredit Gratis Terpakai: " << totalKreditTerpakai << endl;
-        cout << "\n📚 Total Item di Katalog: " << katalog.size() << endl;
-        cout << "👥 Total Member Terdaftar: " << daftarMember.size() << endl;
-    }
-
-    // reset statistik bulanan - panggil tiap awal bulan
-    void resetStatistikBulanan() {
-        pinjamanPerTipe.clear();
-        totalDendaBulanIni = 0.0;
-        totalKreditTerpakai = 0;
-        cout << "✅ Statistik bulanan di-reset!" << endl;
-    }
-};
-
-// ===========================
-// MENU INTERFACE
-// ===========================
-void tampilkanMenu() {
-    cout << "\n╔════════════════════════════════════╗" << endl;
-    cout << "║   SISTEM PERPUSTAKAAN AMBIS 📚    ║" << endl;
-    cout << "╚════════════════════════════════════╝" << endl;
-    cout << "1. Tambah Item (Book/Magazine/DVD)" << endl;
-    cout << "2. Register Member" << endl;
-    cout << "3. Tampilkan Katalog" << endl;
-    cout << "4. Tampilkan Member" << endl;
-    cout << "5. Pinjam Item" << endl;
-    cout << "6. Kembalikan Item" << endl;
-    cout << "7. Kembalikan DVD (dengan cek rusak)" << endl;
-    cout << "8. Sort Katalog" << endl;
-    cout << "9. Laporan Bulanan" << endl;
-    cout << "10. Reset Statistik Bulanan" << endl;
-    cout << "0. Exit" << endl;
-    cout << "Pilih menu: ";
-}
-
-// ===========================
-// FUNGSI TEST CASES
-// ===========================
-void runTestCases(Perpustakaan& perpus) {
-    cout << "\n🧪 === RUNNING TEST CASES ===" << endl;
-    cout << "Test cases dari file testcases.txt\n" << endl;
-
-    // Test 1: Tambah 3 item berbeda
-    cout << "\n[TEST 1] Tambah 3 item berbeda" << endl;
-    perpus.tambahItem(make_unique<Book>("B001", "Laskar Pelangi", "Andrea Hirata", false));
-    perpus.tambahItem(make_unique<Magazine>("M001", "National Geographic", "Edisi Januari 2025"));
-    perpus.tambahItem(make_unique<DVD>("D001", "Pengabdi Setan 2", "Joko Anwar"));
-    perpus.sortKatalog();
-
-    // Test 2: Register member dan pinjam
-    cout << "\n[TEST 2] Register member dan pinjam Book" << endl;
-    perpus.registerMember(make_unique<Member>("MEM001", "Budi Santoso"));
-    perpus.prosesPinjam("MEM001", "B001", 10, false);
-
-    // Test 3: Pinjam DVD dan kembalikan telat dengan rusak
-    cout << "\n[TEST 3] Pinjam DVD dan balikin telat + rusak" << endl;
-    perpus.prosesPinjam("MEM001", "D001", 3, false);
-    perpus.prosesKembaliDVD("MEM001", "D001", 5, true);  // telat 2 hari + rusak
-
-    // Test 4: Tambah member baru, pinjam sampe level up
-    cout << "\n[TEST 4] Member baru, pinjam sampai level up" << endl;
-    perpus.registerMember(make_unique<Member>("MEM002", "Siti Nurhaliza"));
-    perpus.tambahItem(make_unique<Book>("B002", "Harry Potter", "JK Rowling", false));
-    perpus.tambahItem(make_unique<Magazine>("M002", "Tempo", "Edisi Februari"));
-    perpus.tambahItem(make_unique<Book>("B003", "Ronggeng Dukuh Paruk", "Ahmad Tohari", true));
-    
-    // Pinjam 5 kali buat naik ke level 1
-    for (int i = 0; i < 5; i++) {
-        perpus.prosesPinjam("MEM002", "M002", 5, false);
-        perpus.prosesKembali("MEM002", "M002", 5);
-    }
-
-    // Test 5: Pake kredit gratis
-    cout << "\n[TEST 5] Pake kredit gratis hasil level up" << endl;
-    perpus.prosesPinjam("MEM002", "B002", 10, true);  // pake kredit
-    perpus.prosesKembali("MEM002", "B002", 10);
-
-    // Test 6: Coba pinjam buku langka lebih dari max hari
-    cout << "\n[TEST 6] Coba pinjam buku langka melebihi max hari" << endl;
-    perpus.prosesPinjam("MEM001", "B003", 10, false);  // buku langka max 3 hari
-
-    // Test 7: Kembalikan tepat waktu
-    cout << "\n[TEST 7] Pinjam dan kembalikan tepat waktu" << endl;
-    perpus.prosesPinjam("MEM001", "B003", 3, false);
-    perpus.prosesKembali("MEM001", "B003", 3);
-
-    // Test 8: Generate laporan bulanan
-    cout << "\n[TEST 8] Generate laporan bulanan" << endl;
-    perpus.laporanBulanan();
-
-    cout << "\n✅ Semua test cases selesai!\n" << endl;
-}
-
-// ===========================
-// MAIN FUNCTION
-// ===========================
-int main() {
-    Perpustakaan perpus;
-    int pilihan;
-
-    // Auto-run test cases
-    cout << "Mau langsung run test cases? (1=Ya, 0=Tidak): ";
-    int runTest;
-    cin >> runTest;
-    cin.ignore();
-
-    if (runTest == 1) {
-        runTestCases(perpus);
-    }
-
-    // Main menu loop
-    while (true) {
-        tampilkanMenu();
-        cin >> pilihan;
-        cin.ignore();
-
-        if (pilihan == 0) {
-            cout << "Makasih udah pake sistem perpustakaan! Bye~" << endl;
-            break;
-        }
-
-        switch (pilihan) {
-            case 1: {  // Tambah item
-                cout << "Tipe item (1=Book, 2=Magazine, 3=DVD): ";
-                int tipe;
-                cin >> tipe;
-                cin.ignore();
-
-                string id, judul;
-                cout << "ID: "; getline(cin, id);
-                cout << "Judul: "; getline(cin, judul);
-
-                if (tipe == 1) {
-                    string penulis;
-                    bool langka;
-                    cout << "Penulis: "; getline(cin, penulis);
-                    cout << "Langka? (1=Ya, 0=Tidak): "; cin >> langka;
-                    perpus.tambahItem(make_unique<Book>(id, judul, penulis, langka));
-                } else if (tipe == 2) {
-                    string edisi;
-                    cout << "Edisi: "; getline(cin, edisi);
-                    perpus.tambahItem(make_unique<Magazine>(id, judul, edisi));
-                } else if (tipe == 3) {
-                    string sutradara;
-                    cout << "Sutradara: "; getline(cin, sutradara);
-                    perpus.tambahItem(make_unique<DVD>(id, judul, sutradara));
-                }
-                break;
-            }
-            case 2: {  // Register member
-                string id, nama;
-                cout << "ID Member: "; getline(cin, id);
-                cout << "Nama: "; getline(cin, nama);
-                perpus.registerMember(make_unique<Member>(id, nama));
-                break;
-            }
-            case 3:  // Tampilkan katalog
-                perpus.tampilkanKatalog();
-                break;
-            case 4:  // Tampilkan member
-                perpus.tampilkanMember();
-                break;
-            case 5: {  // Pinjam item
-                string idMember, idItem;
-                int hari, pakeKredit;
-                cout << "ID Member: "; getline(cin, idMember);
-                cout << "ID Item: "; getline(cin, idItem);
-                cout << "Berapa hari: "; cin >> hari;
-                cout << "Pake kredit gratis? (1=Ya, 0=Tidak): "; cin >> pakeKredit;
-                perpus.prosesPinjam(idMember, idItem, hari, pakeKredit == 1);
-                break;
-            }
-            case 6: {  // Kembalikan item
-                string idMember, idItem;
-                int hariAktual;
-                cout << "ID Member: "; getline(cin, idMember);
-                cout << "ID Item: "; getline(cin, idItem);
-                cout << "Berapa hari actual pinjam: "; cin >> hariAktual;
-                perpus.prosesKembali(idMember, idItem, hariAktual);
-                break;
-            }
-            case 7: {  // Kembalikan DVD dengan cek rusak
-                string idMember, idDVD;
-                int hariAktual, rusak;
-                cout << "ID Member: "; getline(cin, idMember);
-                cout << "ID DVD: "; getline(cin, idDVD);
-                cout << "Berapa hari actual: "; cin >> hariAktual;
-                cout << "Rusak? (1=Ya, 0=Tidak): "; cin >> rusak;
-                perpus.prosesKembaliDVD(idMember, idDVD, hariAktual, rusak == 1);
-                break;
-            }
-            case 8:  // Sort katalog
-                perpus.sortKatalog();
-                break;
-            case 9:  // Laporan bulanan
-                perpus.laporanBulanan();
-                break;
-            case 10:  // Reset statistik
-                perpus.resetStatistikBulanan();
-                break;
-            default:
-                cout << "Pilihan ga valid bro!" << endl;
-        }
-    }
-
-    return 0;
-}
+#include <iostream>
+#include <vector>
+#include <memory>
+#include <string>
+#include <algorithm>
+#include <iomanip>
+#include <map>
+#include <unordered_map>
+#include <deque>
+#include <string_view>
+#include <cstdint>
+#include <chrono>
+#include <random>
+#include <cstring>
+#include <cstdio>
+#include <fstream>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <shared_mutex>
+#include <atomic>
+#include <array>
+#include <functional>
+#include <memory_resource>
+#include <new>
+#include <cstdlib>
+#include <charconv>
+#include <sstream>
+#include <cerrno>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#define PERPUS_POSIX 1
+#endif
+
+#if defined(__linux__)
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <csignal>
+#define PERPUS_EPOLL 1
+#endif
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define PERPUS_X86_SIMD 1
+#endif
+
+using namespace std;
+
+// ===========================
+// SERIALISASI BINER
+// ===========================
+// format snapshot: semua angka little-endian native, string = u32 panjang + byte.
+// penulis nampung ke buffer dulu, baru ditulis sekali jalan ke file
+class PenulisBiner {
+private:
+    string buf;
+
+public:
+    template <typename T>
+    void tulis(T nilai) {
+        buf.append(reinterpret_cast<const char*>(&nilai), sizeof(T));
+    }
+
+    void tulisString(string_view s) {
+        tulis<uint32_t>(static_cast<uint32_t>(s.size()));
+        buf.append(s.data(), s.size());
+    }
+
+    // timpa nilai yang udah ditulis sebelumnya (buat header panjang)
+    template <typename T>
+    void timpa(size_t offset, T nilai) {
+        memcpy(&buf[offset], &nilai, sizeof(T));
+    }
+
+    // byte yang udah jadi (misal potongan serialisasi yang disiapin duluan)
+    void tulisMentah(string_view s) { buf.append(s.data(), s.size()); }
+
+    size_t posisi() const { return buf.size(); }
+    const string& data() const { return buf; }
+    void clear() { buf.clear(); }
+};
+
+// pembaca nyisir buffer (biasanya hasil mmap) tanpa copy.
+// kalo datanya kepotong, `ok` jadi false dan semua bacaan berikutnya nol
+class PembacaBiner {
+private:
+    const char* p;
+    const char* akhir;
+    bool ok;
+
+public:
+    PembacaBiner(const char* data, size_t n) : p(data), akhir(data + n), ok(true) {}
+
+    template <typename T>
+    T baca() {
+        T nilai{};
+        if (!ok || static_cast<size_t>(akhir - p) < sizeof(T)) {
+            ok = false;
+            return nilai;
+        }
+        memcpy(&nilai, p, sizeof(T));
+        p += sizeof(T);
+        return nilai;
+    }
+
+    // string_view nunjuk langsung ke buffer - jangan dipake abis buffer ditutup
+    string_view bacaString() {
+        uint32_t n = baca<uint32_t>();
+        if (!ok || static_cast<size_t>(akhir - p) < n) {
+            ok = false;
+            return {};
+        }
+        string_view s(p, n);
+        p += n;
+        return s;
+    }
+
+    bool isOk() const { return ok; }
+    size_t sisa() const { return akhir - p; }
+};
+
+// file read-only yang dipetakan ke memori. di POSIX pake mmap,
+// selain itu fallback baca biasa ke buffer
+class FileTerpeta {
+private:
+    const char* ptr;
+    size_t ukuran;
+    string cadangan;  // dipake kalo ga ada mmap
+    bool dipetakan;
+
+public:
+    explicit FileTerpeta(const string& path) : ptr(nullptr), ukuran(0), dipetakan(false) {
+#ifdef PERPUS_POSIX
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) return;
+        struct stat st;
+        if (fstat(fd, &st) == 0 && st.st_size > 0) {
+            void* m = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (m != MAP_FAILED) {
+                ptr = static_cast<const char*>(m);
+                ukuran = st.st_size;
+                dipetakan = true;
+            }
+        }
+        close(fd);
+        if (dipetakan) return;
+#endif
+        ifstream in(path, ios::binary);
+        if (!in) return;
+        cadangan.assign(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+        ptr = cadangan.data();
+        ukuran = cadangan.size();
+    }
+
+    ~FileTerpeta() {
+#ifdef PERPUS_POSIX
+        if (dipetakan) munmap(const_cast<char*>(ptr), ukuran);
+#endif
+    }
+
+    FileTerpeta(const FileTerpeta&) = delete;
+    FileTerpeta& operator=(const FileTerpeta&) = delete;
+
+    bool valid() const { return ptr != nullptr; }
+    const char* data() const { return ptr; }
+    size_t size() const { return ukuran; }
+};
+
+// tulis ke file sementara dulu terus rename, biar snapshot lama ga rusak
+// kalo programnya mati di tengah jalan
+bool tulisFileAtomik(const string& path, const string& isi) {
+    string tmp = path + ".tmp";
+    FILE* f = fopen(tmp.c_str(), "wb");
+    if (!f) return false;
+    bool ok = fwrite(isi.data(), 1, isi.size(), f) == isi.size();
+    ok = fflush(f) == 0 && ok;
+#ifdef PERPUS_POSIX
+    ok = fsync(fileno(f)) == 0 && ok;
+#endif
+    ok = fclose(f) == 0 && ok;
+    if (!ok) {
+        remove(tmp.c_str());
+        return false;
+    }
+    remove(path.c_str());  // windows ga bisa rename nimpa file
+    return rename(tmp.c_str(), path.c_str()) == 0;
+}
+
+// ===========================
+// ALOKASI: PENGHITUNG + ARENA
+// ===========================
+// operator new global bisa diganti biar alokasinya kehitung - buat ngecek
+// berapa kali malloc kepanggil pas bulk load (bench arena). cuma increment
+// relaxed, tapi tetep satu atomic per alokasi, jadi cuma nyala kalo dibuild
+// pake -DPERPUS_HITUNG_ALOKASI=1. build biasa pake operator new bawaan
+#ifndef PERPUS_HITUNG_ALOKASI
+#define PERPUS_HITUNG_ALOKASI 0
+#endif
+
+#if PERPUS_HITUNG_ALOKASI
+struct PenghitungAlokasi {
+    atomic<uint64_t> jumlah{0};
+    atomic<uint64_t> byte{0};
+    atomic<uint64_t> dibebaskan{0};
+};
+PenghitungAlokasi penghitungAlokasi;
+
+void* operator new(size_t n) {
+    penghitungAlokasi.jumlah.fetch_add(1, memory_order_relaxed);
+    penghitungAlokasi.byte.fetch_add(n, memory_order_relaxed);
+    if (void* p = malloc(n ? n : 1)) return p;
+    throw bad_alloc();
+}
+
+void* operator new(size_t n, const nothrow_t&) noexcept {
+    penghitungAlokasi.jumlah.fetch_add(1, memory_order_relaxed);
+    penghitungAlokasi.byte.fetch_add(n, memory_order_relaxed);
+    return malloc(n ? n : 1);
+}
+
+// ga boleh ke-inline: gcc bakal ngeliat free() buat pointer dari operator new
+// di atas terus ngira alokasinya ga cocok (-Wmismatched-new-delete)
+#if defined(__GNUC__)
+__attribute__((noinline))
+#endif
+void operator delete(void* p) noexcept {
+    if (!p) return;
+    penghitungAlokasi.dibebaskan.fetch_add(1, memory_order_relaxed);
+    free(p);
+}
+
+void operator delete(void* p, size_t) noexcept { ::operator delete(p); }
+#endif
+
+// rentang alamat semua blok arena yang masih idup (awal -> akhir), biar
+// delete per kelas bisa tau asal objek dari alamatnya doang tanpa nempelin
+// kepala di tiap objek. bloknya dikit (ukurannya dobel terus), jadi lookup
+// map-nya murah dan cuma kejadian pas objek dihapus
+class RentangArena {
+private:
+    static shared_mutex& mtx() {
+        static shared_mutex m;
+        return m;
+    }
+    static map<uintptr_t, uintptr_t>& blok() {
+        static map<uintptr_t, uintptr_t> b;
+        return b;
+    }
+
+public:
+    static void tambah(const void* p, size_t n) {
+        uintptr_t awal = reinterpret_cast<uintptr_t>(p);
+        unique_lock<shared_mutex> lk(mtx());
+        blok().emplace(awal, awal + n);
+    }
+
+    static void buang(const void* p) {
+        unique_lock<shared_mutex> lk(mtx());
+        blok().erase(reinterpret_cast<uintptr_t>(p));
+    }
+
+    static bool punya(const void* p) {
+        uintptr_t a = reinterpret_cast<uintptr_t>(p);
+        shared_lock<shared_mutex> lk(mtx());
+        auto it = blok().upper_bound(a);
+        if (it == blok().begin()) return false;
+        --it;
+        return a < it->second;
+    }
+};
+
+// arena: bagi2 memori dari blok gede yang makin lama makin gede, ga ada
+// free satu2 - semuanya dibalikin sekaligus pas reset()/destruktor
+class ArenaMemori : public pmr::memory_resource {
+private:
+    // hulu yang ngitung berapa blok gede yang diminta ke heap (dan nyatet
+    // rentangnya ke RentangArena)
+    class HuluTerhitung : public pmr::memory_resource {
+    public:
+        size_t blok = 0;
+        size_t byte = 0;
+
+    protected:
+        void* do_allocate(size_t n, size_t align) override {
+            blok++;
+            byte += n;
+            void* p = pmr::new_delete_resource()->allocate(n, align);
+            RentangArena::tambah(p, n);
+            return p;
+        }
+        void do_deallocate(void* p, size_t n, size_t align) override {
+            RentangArena::buang(p);
+            pmr::new_delete_resource()->deallocate(p, n, align);
+        }
+        bool do_is_equal(const memory_resource& lain) const noexcept override { return this == &lain; }
+    };
+
+    HuluTerhitung hulu;
+    pmr::monotonic_buffer_resource inti;
+    mutable mutex mtx;
+    size_t bytePakai;
+    size_t jumlahAlokasi;
+
+protected:
+    void* do_allocate(size_t n, size_t align) override {
+        lock_guard<mutex> lk(mtx);
+        bytePakai += n;
+        jumlahAlokasi++;
+        return inti.allocate(n, align);
+    }
+    void do_deallocate(void*, size_t, size_t) override {}  // dibebasin bareng2
+    bool do_is_equal(const memory_resource& lain) const noexcept override { return this == &lain; }
+
+public:
+    explicit ArenaMemori(size_t blokAwal = 1 << 20)
+        : inti(blokAwal, &hulu), bytePakai(0), jumlahAlokasi(0) {}
+
+    ArenaMemori(const ArenaMemori&) = delete;
+    ArenaMemori& operator=(const ArenaMemori&) = delete;
+
+    // balikin semua blok ke heap. semua objek di arena harus udah mati
+    void reset() {
+        lock_guard<mutex> lk(mtx);
+        inti.release();
+        bytePakai = 0;
+        jumlahAlokasi = 0;
+    }
+
+    struct Statistik {
+        size_t blok;         // berapa kali minta blok ke heap
+        size_t byteBlok;     // total ukuran blok
+        size_t bytePakai;    // yang beneran dibagi ke objek/teks
+        size_t alokasi;      // berapa potong yang dibagi
+    };
+
+    Statistik statistik() const {
+        lock_guard<mutex> lk(mtx);
+        return Statistik{hulu.blok, hulu.byte, bytePakai, jumlahAlokasi};
+    }
+};
+
+// arena yang lagi aktif di thread ini - Item/Member yang dibikin (objek +
+// teksnya) selama ada LingkupArena bakal ditaro di situ, di luar itu heap biasa
+thread_local ArenaMemori* arenaAktif = nullptr;
+
+class LingkupArena {
+private:
+    ArenaMemori* lama;
+
+public:
+    explicit LingkupArena(ArenaMemori* arena) : lama(arenaAktif) { arenaAktif = arena; }
+    ~LingkupArena() { arenaAktif = lama; }
+    LingkupArena(const LingkupArena&) = delete;
+    LingkupArena& operator=(const LingkupArena&) = delete;
+};
+
+// string buat field Item/Member - alokatornya ngikut arena aktif pas dibikin
+using Teks = pmr::string;
+
+inline pmr::polymorphic_allocator<char> alokatorTeks() {
+    return pmr::polymorphic_allocator<char>(arenaAktif ? arenaAktif : pmr::get_default_resource());
+}
+
+// operator new/delete per kelas: objek masuk arena aktif kalo ada, kalo ga
+// ya heap. delete nanya RentangArena: alamat di dalem blok arena = nunggu
+// dibebasin bareng arenanya, sisanya balik ke heap
+struct DialokasiArena {
+    static void* operator new(size_t n) {
+        if (arenaAktif) return arenaAktif->allocate(n, alignof(max_align_t));
+        return ::operator new(n);
+    }
+
+    static void operator delete(void* p) noexcept {
+        if (p && !RentangArena::punya(p)) ::operator delete(p);
+    }
+};
+
+// ===========================
+// KOLAM PARALEL (WORK-STEALING)
+// ===========================
+// buat kerjaan sekatalog yang bisa dipecah: bangun indeks urut, validasi
+// batch/impor gede, agregat riwayat. pola fork-join: pemanggil mecah
+// kerjaan jadi tugas, terus nunggu sambil ikut ngerjain (jadi boleh
+// bersarang, ga bakal deadlock nunggu dirinya sendiri). tiap pekerja punya
+// deque sendiri: tugas baru masuk + diambil dari belakang (masih anget di
+// cache), pekerja yang nganggur nyolong dari depan deque pekerja lain.
+// thread di luar kolam nitip ke deque titipan. kolam ukuran 1 = ga ada
+// thread sama sekali, semuanya langsung jalan serial di pemanggil.
+// tugas ga boleh lempar exception dan ga boleh nunggu lock yang dipegang
+// thread yang lagi nunggu grupnya
+class KolamParalel {
+public:
+    // satu fork-join: tunggu() balik kalo semua tugas grup ini udah kelar.
+    // sisa cuma dikurangin sambil megang `m`, jadi yang nunggu bisa tidur di
+    // `cv` dan Grup-nya aman dibuang begitu tunggu() balik
+    struct Grup {
+        atomic<size_t> sisa{0};
+        mutex m;
+        condition_variable cv;
+    };
+
+private:
+    struct Tugas {
+        function<void()> f;
+        Grup* grup;
+    };
+
+    struct alignas(64) Antrean {
+        mutex m;
+        deque<Tugas> isi;
+    };
+
+    vector<thread> pekerja;
+    unique_ptr<Antrean[]> antrean;  // [0..nPekerja) punya pekerja, [nPekerja] titipan
+    size_t nAntrean;
+    atomic<size_t> nTugas{0};  // yang lagi nunggu di semua antrean
+    mutex mtxTidur;
+    condition_variable cvTidur;
+    bool berhenti = false;
+
+    // indeks antrean pekerja thread ini, kalo thread-nya anggota kolam ini
+    static thread_local KolamParalel* kolamThread;
+    static thread_local size_t indeksThread;
+
+    size_t antreanSendiri() const { return kolamThread == this ? indeksThread : nAntrean - 1; }
+
+    bool ambil(Tugas& t) {
+        size_t sendiri = antreanSendiri();
+        {
+            Antrean& a = antrean[sendiri];
+            lock_guard<mutex> lk(a.m);
+            if (!a.isi.empty()) {
+                t = move(a.isi.back());
+                a.isi.pop_back();
+                nTugas.fetch_sub(1, memory_order_relaxed);
+                return true;
+            }
+        }
+        // nyolong dari depan, mulai dari tetangga biar ga semua nyerbu antrean 0
+        for (size_t k = 1; k < nAntrean; k++) {
+            Antrean& a = antrean[(sendiri + k) % nAntrean];
+            lock_guard<mutex> lk(a.m);
+            if (!a.isi.empty()) {
+                t = move(a.isi.front());
+                a.isi.pop_front();
+                nTugas.fetch_sub(1, memory_order_relaxed);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    static void jalankan(Tugas& t) {
+        t.f();
+        Grup& g = *t.grup;
+        lock_guard<mutex> lk(g.m);
+        if (g.sisa.fetch_sub(1, memory_order_acq_rel) == 1) g.cv.notify_all();
+    }
+
+    void loop(size_t indeks) {
+        kolamThread = this;
+        indeksThread = indeks;
+        Tugas t;
+        while (true) {
+            if (ambil(t)) {
+                jalankan(t);
+                continue;
+            }
+            unique_lock<mutex> lk(mtxTidur);
+            cvTidur.wait(lk, [&] { return berhenti || nTugas.load(memory_order_relaxed) > 0; });
+            if (berhenti) return;
+        }
+    }
+
+    template <typename F>
+    void bagi(Grup& g, size_t a, size_t b, size_t butir, F& f) {
+        while (b - a > butir) {
+            size_t tengah = a + (b - a) / 2;
+            kirim(g, [this, &g, tengah, b, butir, &f] { bagi(g, tengah, b, butir, f); });
+            b = tengah;
+        }
+        f(a, b);
+    }
+
+    // gabung [a0,a1) + [b0,b1) ke `out`: potong di tengah run yang lebih
+    // panjang, cari pasangannya di run satunya, kiri-kanan jalan sendiri2
+    template <typename T, typename Banding>
+    void gabung(Grup& g, const T* a0, const T* a1, const T* b0, const T* b1, T* out, Banding& banding) {
+        constexpr ptrdiff_t BUTIR_GABUNG = 1 << 15;
+        while ((a1 - a0) + (b1 - b0) > BUTIR_GABUNG) {
+            if (a1 - a0 < b1 - b0) {
+                swap(a0, b0);
+                swap(a1, b1);
+            }
+            const T* am = a0 + (a1 - a0) / 2;
+            const T* bm = lower_bound(b0, b1, *am, banding);
+            T* om = out + (am - a0) + (bm - b0);
+            *om = *am;
+            kirim(g, [this, &g, am, a1, bm, b1, om, &banding] { gabung(g, am + 1, a1, bm, b1, om + 1, banding); });
+            a1 = am;
+            b1 = bm;
+        }
+        merge(a0, a1, b0, b1, out, banding);
+    }
+
+public:
+    // nThread = total thread yang ngerjain, termasuk pemanggil
+    explicit KolamParalel(unsigned nThread) : nAntrean(max(1u, nThread)) {
+        antrean = make_unique<Antrean[]>(nAntrean);
+        for (size_t i = 0; i + 1 < nAntrean; i++) pekerja.emplace_back([this, i] { loop(i); });
+    }
+
+    ~KolamParalel() {
+        {
+            lock_guard<mutex> lk(mtxTidur);
+            berhenti = true;
+        }
+        cvTidur.notify_all();
+        for (auto& t : pekerja) t.join();
+    }
+
+    KolamParalel(const KolamParalel&) = delete;
+    KolamParalel& operator=(const KolamParalel&) = delete;
+
+    unsigned jumlahThread() const { return static_cast<unsigned>(pekerja.size() + 1); }
+
+    void kirim(Grup& g, function<void()> f) {
+        if (pekerja.empty()) {  // ga ada yang bisa nyolong, langsung aja
+            f();
+            return;
+        }
+        g.sisa.fetch_add(1, memory_order_relaxed);
+        {
+            Antrean& a = antrean[antreanSendiri()];
+            lock_guard<mutex> lk(a.m);
+            a.isi.push_back(Tugas{move(f), &g});
+        }
+        nTugas.fetch_add(1, memory_order_relaxed);
+        {
+            lock_guard<mutex> lk(mtxTidur);  // biar ga ada yang ketinggalan bangun
+        }
+        cvTidur.notify_one();
+    }
+
+    // nunggu sambil ngerjain tugas siapa aja yang ada. kalo ga ada yang bisa
+    // dicolong (sisanya lagi dikerjain pekerja lain), tidur di grupnya -
+    // dibangunin tugas terakhir, ga muter yield makan jatah CPU thread lain
+    void tunggu(Grup& g) {
+        Tugas t;
+        while (g.sisa.load(memory_order_acquire) > 0) {
+            if (ambil(t)) {
+                jalankan(t);
+                continue;
+            }
+            unique_lock<mutex> lk(g.m);
+            g.cv.wait(lk, [&] { return g.sisa.load(memory_order_acquire) == 0; });
+        }
+        lock_guard<mutex> lk(g.m);  // tugas terakhir udah lepas `m`, baru Grup boleh dibuang
+    }
+
+    // f(mulai, akhir) buat potongan2 [0, n), tiap potongan minimal `butir`
+    // (kecuali kalo n-nya emang kecil). urutan/pembagian potongan ga dijamin
+    template <typename F>
+    void untukRentang(size_t n, size_t butir, F&& f) {
+        if (n == 0) return;
+        butir = max<size_t>(max<size_t>(1, butir), n / (8 * jumlahThread()));
+        if (pekerja.empty() || n <= butir) {
+            f(size_t(0), n);
+            return;
+        }
+        Grup g;
+        bagi(g, 0, n, butir, f);
+        tunggu(g);
+    }
+
+    // jalanin beberapa kerjaan beda barengan, balik kalo semuanya kelar
+    template <typename F, typename... G>
+    void barengan(F&& f, G&&... g) {
+        Grup grup;
+        (kirim(grup, function<void()>(forward<G>(g))), ...);
+        f();
+        tunggu(grup);
+    }
+
+    // peta tiap potongan jadi T, terus digabung urut dari kiri - hasilnya
+    // sama terus berapa pun thread-nya (penting buat jumlah double)
+    template <typename T, typename Peta, typename Gabung>
+    T reduksi(size_t n, size_t butir, T nol, Peta&& peta, Gabung&& gabung) {
+        butir = max<size_t>(1, butir);
+        size_t nPotong = min((n + butir - 1) / butir, size_t(4) * jumlahThread());
+        if (nPotong <= 1) return n ? gabung(move(nol), peta(size_t(0), n)) : nol;
+        vector<T> hasil(nPotong);
+        untukRentang(nPotong, 1, [&](size_t a, size_t b) {
+            for (size_t p = a; p < b; p++) hasil[p] = peta(n * p / nPotong, n * (p + 1) / nPotong);
+        });
+        for (T& h : hasil) nol = gabung(move(nol), move(h));
+        return nol;
+    }
+
+    // sort paralel: potongan di-sort sendiri2, terus digabung berpasangan
+    // (gabungnya juga dipecah). kaya std::sort, urutan yang sama ga dijaga
+    template <typename T, typename Banding>
+    void urutkan(vector<T>& v, Banding banding) {
+        constexpr size_t BUTIR_URUT = 1 << 14;
+        size_t n = v.size();
+        if (pekerja.empty() || n < 2 * BUTIR_URUT) {
+            sort(v.begin(), v.end(), banding);
+            return;
+        }
+        size_t nPotong = 1;
+        while (nPotong < 4 * jumlahThread() && n / (nPotong * 2) >= BUTIR_URUT) nPotong *= 2;
+        vector<size_t> batas(nPotong + 1);
+        for (size_t p = 0; p <= nPotong; p++) batas[p] = n * p / nPotong;
+        untukRentang(nPotong, 1, [&](size_t a, size_t b) {
+            for (size_t p = a; p < b; p++) sort(v.begin() + batas[p], v.begin() + batas[p + 1], banding);
+        });
+
+        vector<T> buf(n);
+        T* asal = v.data();
+        T* tujuan = buf.data();
+        for (size_t lebar = 1; lebar < nPotong; lebar *= 2) {
+            Grup g;
+            for (size_t p = 0; p < nPotong; p += 2 * lebar) {
+                size_t a = batas[p], m = batas[min(p + lebar, nPotong)], b = batas[min(p + 2 * lebar, nPotong)];
+                kirim(g, [this, &g, &banding, asal, tujuan, a, m, b] {
+                    gabung(g, asal + a, asal + m, asal + m, asal + b, tujuan + a, banding);
+                });
+            }
+            tunggu(g);
+            swap(asal, tujuan);
+        }
+        if (asal != v.data()) {
+            untukRentang(n, BUTIR_URUT, [&](size_t a, size_t b) { copy(asal + a, asal + b, v.data() + a); });
+        }
+    }
+};
+
+thread_local KolamParalel* KolamParalel::kolamThread = nullptr;
+thread_local size_t KolamParalel::indeksThread = 0;
+
+// kolam bawaan, dibikin pas pertama dipake. 0 = seukuran jumlah core,
+// diatur lewat --paralel <n> sebelum ada yang make
+unsigned ukuranKolamParalel = 0;
+
+KolamParalel& kolamParalel() {
+    static KolamParalel kolam(ukuranKolamParalel ? ukuranKolamParalel : max(1u, thread::hardware_concurrency()));
+    return kolam;
+}
+
+// ===========================
+// MESIN KEBIJAKAN (DENDA, MAX HARI, LEVEL)
+// ===========================
+// semua aturan pinjam/denda/naik level ngumpul di satu tabel. bawaannya
+// constexpr (aturan asli), operator bisa muat tabel lain dari file pas
+// startup. jalur panas baca tabel aktif lewat fungsi inline, bukan virtual
+constexpr size_t JUMLAH_KODE_TIPE = 5;  // 0 = kosong, 1 Book, 2 Magazine, 3 DVD, 4 Alat
+constexpr const char* NAMA_TIPE[JUMLAH_KODE_TIPE] = {"", "Book", "Magazine", "DVD", "Alat"};
+constexpr int JUMLAH_LEVEL = 2;  // level 0 -> 1 -> 2
+
+struct AturanTipe {
+    int maxHari[2];  // [varian]: varian 1 = Book langka / Alat elektronik
+    double dendaPerHari[2];
+    double biayaRusak;  // tambahan flat kalo dibalikin rusak
+};
+
+struct AturanLevel {
+    int syaratPinjaman;  // pinjaman sukses minimal buat naik ke level berikutnya
+    int bonusKredit;
+};
+
+struct TabelKebijakan {
+    array<AturanTipe, JUMLAH_KODE_TIPE> tipe;
+    array<AturanLevel, JUMLAH_LEVEL> level;
+
+    constexpr int maxHari(uint8_t kode, bool varian) const { return tipe[kode].maxHari[varian]; }
+    constexpr double tarifDenda(uint8_t kode, bool varian) const { return tipe[kode].dendaPerHari[varian]; }
+
+    // denda pas balik: telatnya dihitung dari max hari, rusak nambah biaya flat
+    constexpr double dendaKembali(uint8_t kode, bool varian, int hariAktual, bool rusak) const {
+        int telat = hariAktual - maxHari(kode, varian);
+        return (telat > 0 ? tarifDenda(kode, varian) * telat : 0.0) + (rusak ? tipe[kode].biayaRusak : 0.0);
+    }
+};
+
+constexpr TabelKebijakan KEBIJAKAN_BAWAAN = {
+    {{
+        {{0, 0}, {0.0, 0.0}, 0.0},
+        {{14, 3}, {1000.0, 1000.0}, 0.0},     // Book - langka cuma 3 hari
+        {{7, 7}, {500.0, 500.0}, 0.0},        // Magazine - lebih murah dari buku
+        {{3, 3}, {2000.0, 2000.0}, 50000.0},  // DVD - paling mahal, rusak +50k
+        {{7, 3}, {1000.0, 5000.0}, 0.0},      // Alat - elektronik gantian dipake
+    }},
+    {{{5, 1}, {10, 3}}},  // 5 pinjaman -> level 1 (+1 kredit), 10 -> level 2 (+3)
+};
+
+// versi compile-time per kategori - buat kode yang tipe-nya udah pasti
+// pas kompilasi, ga bisa diganti tabel dari file
+template <uint8_t KODE>
+struct KebijakanTetap {
+    static_assert(KODE > 0 && KODE < JUMLAH_KODE_TIPE, "kode tipe ga valid");
+    static constexpr int maxHari(bool varian) { return KEBIJAKAN_BAWAAN.maxHari(KODE, varian); }
+    static constexpr double dendaKembali(int hariAktual, bool varian, bool rusak = false) {
+        return KEBIJAKAN_BAWAAN.dendaKembali(KODE, varian, hariAktual, rusak);
+    }
+};
+
+// tabel yang lagi dipake. cuma boleh diganti pas startup, sebelum ada transaksi
+TabelKebijakan kebijakanAktif = KEBIJAKAN_BAWAAN;
+
+inline const TabelKebijakan& kebijakan() { return kebijakanAktif; }
+
+// ===========================
+// DATA ITEM (RECORD BUAT NAMBAH ITEM)
+// ===========================
+// isi satu item sebelum masuk katalog. dipake pas nambah item (menu, impor,
+// snapshot, replay log) - begitu dipasang, isinya disalin ke KatalogKolom
+// (satu2nya pemilik data item) dan record ini udah ga kepake lagi.
+// anak2nya (Book, Magazine, DVD, Alat) cuma konstruktor + getter yang
+// namanya sesuai tipe, ga nambah field - jadi aman di-copy ke DataItem
+struct DataItem {
+    string id;
+    string judul;
+    string detail;       // penulis / edisi / sutradara / spesifikasi
+    uint8_t kode = 0;    // kode tipe - kunci ke tabel kebijakan
+    bool varian = false; // Book langka / Alat elektronik
+    uint32_t eksemplar = 1;
+    uint32_t diRak = 1;
+
+    // byte status di serialisasi: bit0 tersedia (format lama cuma ini),
+    // bit1 = abis ini ada [u32 eksemplar][u32 di rak]
+    static constexpr uint8_t FLAG_EKSEMPLAR = 2;
+
+    DataItem() = default;
+    DataItem(string_view id, string_view judul, uint8_t kode, bool varian, string_view detail)
+        : id(id), judul(judul), detail(detail), kode(kode), varian(varian) {}
+
+    string_view getId() const { return id; }
+    string_view getJudul() const { return judul; }
+    uint8_t kodeTipe() const { return kode; }
+    bool isTersedia() const { return diRak > 0; }
+    // true = semua eksemplar di rak, false = semuanya dipinjem
+    void setTersedia(bool tersedia) { diRak = tersedia ? eksemplar : 0; }
+
+    // kebalikan Item::tulisKe - isi `hasil` sesuai kode tipe, false kalo rusak.
+    // `hasil` boleh dipake ulang antar record, kapasitas string-nya ga dibuang
+    static bool bacaDari(PembacaBiner& in, DataItem& hasil);
+};
+
+// ===========================
+// KELAS BOOK (CHILD CLASS)
+// ===========================
+struct Book : DataItem {
+    static constexpr uint8_t KODE = 1;
+
+    // buku langka beda treatment cuy - max hari & denda-nya liat tabel kebijakan
+    Book(string_view id, string_view judul, string_view penulis, bool langka = false)
+        : DataItem(id, judul, KODE, langka, penulis) {}
+
+    string_view getPenulis() const { return detail; }
+    bool isLangka() const { return varian; }
+};
+
+// ===========================
+// KELAS MAGAZINE (CHILD CLASS)
+// ===========================
+struct Magazine : DataItem {
+    static constexpr uint8_t KODE = 2;
+
+    // majalah cuma seminggu - standar lah
+    Magazine(string_view id, string_view judul, string_view edisi)
+        : DataItem(id, judul, KODE, false, edisi) {}
+
+    string_view getEdisi() const { return detail; }
+};
+
+// ===========================
+// KELAS DVD (CHILD CLASS)
+// ===========================
+struct DVD : DataItem {
+    static constexpr uint8_t KODE = 3;
+
+    // DVD cepet banget - 3 hari doang, dendanya paling mahal bossku
+    DVD(string_view id, string_view judul, string_view sutradara)
+        : DataItem(id, judul, KODE, false, sutradara) {}
+
+    string_view getSutradara() const { return detail; }
+};
+
+// ===========================
+// KELAS ALAT (CHILD CLASS)
+// ===========================
+// alat lab dari file alat.txt - elektronik (spek = daya, misal "220")
+// atau non-elektronik (spek = bahan, misal "kaca")
+struct Alat : DataItem {
+    static constexpr uint8_t KODE = 4;
+
+    // alat elektronik gantian dipake, jangan lama2 - liat tabel kebijakan
+    Alat(string_view id, string_view nama, bool elektronik, string_view spesifikasi)
+        : DataItem(id, nama, KODE, elektronik, spesifikasi) {}
+
+    bool isElektronik() const { return varian; }
+    string_view getSpesifikasi() const { return detail; }
+};
+
+static_assert(sizeof(Book) == sizeof(DataItem) && sizeof(Alat) == sizeof(DataItem),
+              "anak DataItem ga boleh nambah field - di-copy ke DataItem");
+
+// aturan bawaan harus sama persis kaya aturan asli - dicek pas kompilasi
+static_assert(KebijakanTetap<Book::KODE>::maxHari(false) == 14 && KebijakanTetap<Book::KODE>::maxHari(true) == 3,
+              "buku biasa 14 hari, langka 3 hari");
+static_assert(KebijakanTetap<Magazine::KODE>::dendaKembali(9, false) == 1000.0, "majalah 500/hari");
+static_assert(KebijakanTetap<DVD::KODE>::dendaKembali(5, false, true) == 54000.0, "DVD 2000/hari + 50k rusak");
+static_assert(KebijakanTetap<Alat::KODE>::dendaKembali(4, true) == 5000.0, "alat elektronik 5000/hari");
+
+bool DataItem::bacaDari(PembacaBiner& in, DataItem& hasil) {
+    hasil.kode = in.baca<uint8_t>();
+    hasil.id = in.bacaString();
+    hasil.judul = in.bacaString();
+    uint8_t flag = in.baca<uint8_t>();
+    hasil.eksemplar = 1;
+    hasil.diRak = flag & 1;
+    if (flag & FLAG_EKSEMPLAR) {
+        hasil.eksemplar = in.baca<uint32_t>();
+        hasil.diRak = in.baca<uint32_t>();
+    }
+
+    hasil.varian = false;
+    if (hasil.kode == Book::KODE) {
+        hasil.detail = in.bacaString();
+        hasil.varian = in.baca<uint8_t>() != 0;
+    } else if (hasil.kode == Magazine::KODE || hasil.kode == DVD::KODE) {
+        hasil.detail = in.bacaString();
+    } else if (hasil.kode == Alat::KODE) {
+        hasil.varian = in.baca<uint8_t>() != 0;
+        hasil.detail = in.bacaString();
+    } else {
+        return false;
+    }
+
+    if (!in.isOk() || hasil.eksemplar == 0) return false;
+    hasil.diRak = min(hasil.diRak, hasil.eksemplar);
+    return true;
+}
+
+// ===========================
+// KATALOG KOLOM (STRUCTURE OF ARRAYS)
+// ===========================
+// satu2nya pemilik data item, per slot dalam bentuk kolom: tag tipe,
+// varian, ID & judul jadi offset ke satu arena string, field khusus tipe di
+// tabel samping, kata status + jumlah eksemplar, sama bitset tersedia yang
+// diturunin dari kata status. Item (di bawah) cuma tampilan pointer + slot
+// ke sini - ga ada objek per item di heap, scan sekatalog nyapu array padet
+
+// bitset yang bit-nya bisa diubah barengan dari banyak thread.
+// nambah bit (tumbuh) cuma boleh pas pemanggil megang lock exclusive
+class BitsetAtomik {
+private:
+    unique_ptr<atomic<uint64_t>[]> kata;
+    size_t kapasitasKata;
+    size_t nBit;
+
+public:
+    BitsetAtomik() : kapasitasKata(0), nBit(0) {}
+
+    void reserve(size_t bit) {
+        size_t perlu = (bit + 63) / 64;
+        if (perlu <= kapasitasKata) return;
+        unique_ptr<atomic<uint64_t>[]> baru(new atomic<uint64_t>[perlu]);
+        for (size_t i = 0; i < perlu; i++) {
+            baru[i].store(i < kapasitasKata ? kata[i].load(memory_order_relaxed) : 0,
+                          memory_order_relaxed);
+        }
+        kata = move(baru);
+        kapasitasKata = perlu;
+    }
+
+    void tambah(bool nilai) {
+        if (nBit / 64 >= kapasitasKata) reserve(max<size_t>(64, nBit * 2));
+        nBit++;
+        set(nBit - 1, nilai);
+    }
+
+    bool get(size_t i) const {
+        return (kata[i / 64].load(memory_order_relaxed) >> (i % 64)) & 1;
+    }
+
+    void set(size_t i, bool nilai) {
+        uint64_t mask = uint64_t(1) << (i % 64);
+        if (nilai) kata[i / 64].fetch_or(mask, memory_order_relaxed);
+        else kata[i / 64].fetch_and(~mask, memory_order_relaxed);
+    }
+
+    size_t hitung() const {
+        size_t total = 0;
+        for (size_t i = 0; i < (nBit + 63) / 64; i++) {
+            total += __builtin_popcountll(kata[i].load(memory_order_relaxed));
+        }
+        return total;
+    }
+
+    // buang bit terakhir - bit-nya harus udah dinolin pemanggil
+    void buangTerakhir() { nBit--; }
+
+    void clear() {
+        for (size_t i = 0; i < kapasitasKata; i++) kata[i].store(0, memory_order_relaxed);
+        nBit = 0;
+    }
+
+    size_t size() const { return nBit; }
+    size_t jumlahKata() const { return (nBit + 63) / 64; }
+    size_t ukuranMemori() const { return kapasitasKata * sizeof(uint64_t); }
+
+    // akses mentah buat kernel SIMD. hasilnya snapshot kasar (sama kaya load
+    // relaxed per kata), bit yang lagi diubah thread lain bisa kebaca lama/baru
+    const uint64_t* mentah() const { return reinterpret_cast<const uint64_t*>(kata.get()); }
+};
+
+static_assert(sizeof(atomic<uint64_t>) == sizeof(uint64_t) && atomic<uint64_t>::is_always_lock_free,
+              "BitsetAtomik::mentah butuh atomic<uint64_t> yang layout-nya polos");
+
+// ===========================
+// KERNEL BITSET (SIMD)
+// ===========================
+// dua operasi dasar buat query ketersediaan: popcount(a & b) dan cari kata
+// pertama yang (a & b) != 0. ada versi AVX2, SSE4.1+POPCNT, sama skalar;
+// yang kepake dipilih sekali pas runtime sesuai CPU
+struct KernelBitset {
+    const char* nama;
+    size_t (*hitungIrisan)(const uint64_t* a, const uint64_t* b, size_t nKata);
+    size_t (*cariIrisan)(const uint64_t* a, const uint64_t* b, size_t mulai, size_t nKata);
+};
+
+size_t hitungIrisanSkalar(const uint64_t* a, const uint64_t* b, size_t nKata) {
+    size_t total = 0;
+    for (size_t i = 0; i < nKata; i++) total += __builtin_popcountll(a[i] & b[i]);
+    return total;
+}
+
+size_t cariIrisanSkalar(const uint64_t* a, const uint64_t* b, size_t mulai, size_t nKata) {
+    for (size_t i = mulai; i < nKata; i++) {
+        if (a[i] & b[i]) return i;
+    }
+    return nKata;
+}
+
+#ifdef PERPUS_X86_SIMD
+// sama kaya skalar tapi dikompil pake instruksi POPCNT
+__attribute__((target("popcnt")))
+size_t hitungIrisanPopcnt(const uint64_t* a, const uint64_t* b, size_t nKata) {
+    size_t total = 0;
+    for (size_t i = 0; i < nKata; i++) total += __builtin_popcountll(a[i] & b[i]);
+    return total;
+}
+
+__attribute__((target("sse4.1")))
+size_t cariIrisanSse(const uint64_t* a, const uint64_t* b, size_t mulai, size_t nKata) {
+    size_t i = mulai;
+    for (; i + 2 <= nKata; i += 2) {
+        __m128i v = _mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i)),
+                                  _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i)));
+        if (!_mm_testz_si128(v, v)) break;
+    }
+    return cariIrisanSkalar(a, b, i, nKata);
+}
+
+// popcount pake tabel nibble lewat vpshufb. counter per byte maks 8 per
+// putaran, jadi tiap 31 putaran dijumlahin ke 64-bit (sad) biar ga overflow
+__attribute__((target("avx2")))
+size_t hitungIrisanAvx2(const uint64_t* a, const uint64_t* b, size_t nKata) {
+    const __m256i tabel = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                           0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i nibble = _mm256_set1_epi8(0x0f);
+    const __m256i nol = _mm256_setzero_si256();
+    __m256i total = nol;
+    size_t i = 0;
+    while (i + 4 <= nKata) {
+        __m256i lokal = nol;
+        size_t batas = min(nKata, i + 4 * 31);
+        for (; i + 4 <= batas; i += 4) {
+            __m256i v = _mm256_and_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i)),
+                                         _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i)));
+            __m256i lo = _mm256_and_si256(v, nibble);
+            __m256i hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), nibble);
+            lokal = _mm256_add_epi8(lokal, _mm256_add_epi8(_mm256_shuffle_epi8(tabel, lo),
+                                                           _mm256_shuffle_epi8(tabel, hi)));
+        }
+        total = _mm256_add_epi64(total, _mm256_sad_epu8(lokal, nol));
+    }
+    uint64_t jumlah[4];
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(jumlah), total);
+    return jumlah[0] + jumlah[1] + jumlah[2] + jumlah[3] + hitungIrisanSkalar(a + i, b + i, nKata - i);
+}
+
+__attribute__((target("avx2")))
+size_t cariIrisanAvx2(const uint64_t* a, const uint64_t* b, size_t mulai, size_t nKata) {
+    size_t i = mulai;
+    for (; i + 4 <= nKata; i += 4) {
+        __m256i v = _mm256_and_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i)),
+                                     _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i)));
+        if (!_mm256_testz_si256(v, v)) break;
+    }
+    return cariIrisanSkalar(a, b, i, nKata);
+}
+#endif
+
+// semua kernel yang bisa jalan di CPU ini, dari yang paling kenceng
+vector<KernelBitset> daftarKernelBitset() {
+    vector<KernelBitset> daftar;
+#ifdef PERPUS_X86_SIMD
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        daftar.push_back({"avx2", hitungIrisanAvx2, cariIrisanAvx2});
+    }
+    if (__builtin_cpu_supports("sse4.1") && __builtin_cpu_supports("popcnt")) {
+        daftar.push_back({"sse4.1+popcnt", hitungIrisanPopcnt, cariIrisanSse});
+    }
+#endif
+    daftar.push_back({"skalar", hitungIrisanSkalar, cariIrisanSkalar});
+    return daftar;
+}
+
+const KernelBitset& kernelBitset() {
+    static const KernelBitset terbaik = daftarKernelBitset().front();
+    return terbaik;
+}
+
+struct RefTeks {
+    uint32_t off;
+    uint32_t len;
+};
+
+// 8 byte pertama teks jadi angka, urutannya sama kaya urutan string
+inline uint64_t awalanTeks(string_view s, size_t nByte = 8) {
+    uint64_t v = 0;
+    for (size_t i = 0; i < nByte; i++) v = (v << 8) | (i < s.size() ? static_cast<unsigned char>(s[i]) : 0);
+    return v;
+}
+
+// bagian item yang bisa berubah - ini doang yang disalin buat potret
+// (VersiLama). ID, judul, tipe, detail ga pernah berubah abis item masuk
+struct KeadaanItem {
+    uint64_t status;     // kata status, lihat KatalogKolom::status
+    uint32_t eksemplar;
+
+    uint32_t diRak() const { return static_cast<uint32_t>(status); }
+    uint32_t antre() const { return static_cast<uint32_t>(status >> 32); }
+    bool isTersedia() const { return diRak() > 0; }
+};
+
+class Item;
+
+class KatalogKolom {
+public:
+    // hasil cobaBalikin: eksemplarnya balik ke rak, atau langsung jatah
+    // kepala antrean reservasi (pemanggil yang nyerahin ke member-nya)
+    enum class Balik : uint8_t { GAGAL, KE_RAK, KE_ANTREAN };
+
+private:
+    vector<uint8_t> tag;
+    vector<uint8_t> varian;
+    vector<RefTeks> id;
+    vector<RefTeks> judul;
+    // kunci ID = awalanTeks(id): kunci beda udah nentuin urutan, string di
+    // arena cuma dibuka kalo kuncinya seri (ID sama 8 byte pertamanya)
+    vector<uint64_t> kunciId;
+    vector<uint32_t> barisSamping;  // slot -> baris di tabel samping tipe-nya
+    vector<uint32_t> eksemplar;     // total eksemplar - cuma diganti pas lock struktur exclusive
+    string arena;                   // semua teks ditumpuk di sini
+
+    // satu judul bisa punya beberapa eksemplar. state-nya satu kata atomic
+    // per slot: 32 bit bawah = eksemplar yang lagi di rak, 32 bit atas =
+    // jumlah member yang ngantre reservasi. dua2nya berubah bareng dalam satu
+    // CAS, jadi "ada di rak" sama "ada yang ngantre" ga pernah kejadian barengan.
+    // ini state transaksi, bukan struktur katalog - makanya mutable, diubah
+    // lewat referensi const di bawah lock struktur shared. nambah slot cuma
+    // pas lock exclusive
+    mutable unique_ptr<atomic<uint64_t>[]> status;
+    size_t kapasitasStatus = 0;
+
+    // bit tersedia = di rak > 0. bukan salinan yang disinkronin dari luar:
+    // ditulis sama fungsi yang ngubah kata status-nya, pas rak kosong <-> ada
+    // isi. perubahan status satu slot udah diserialisasi kunci item di
+    // Perpustakaan (ato lock exclusive), jadi bit-nya ga bisa kebalik urutan
+    mutable BitsetAtomik tersedia;
+
+    // bitmap anggota per tipe, diindeks kode tipe. kode 0 = semua item.
+    // ga pernah berubah abis item masuk, jadi ga perlu atomik
+    array<vector<uint64_t>, JUMLAH_KODE_TIPE> maskTipe;
+
+    // tabel samping per tipe (langka & elektronik udah masuk `varian`)
+    vector<RefTeks> penulis;      // Book
+    vector<RefTeks> edisi;        // Magazine
+    vector<RefTeks> sutradara;    // DVD
+    vector<RefTeks> spesifikasi;  // Alat
+
+    static constexpr uint64_t SATU_ANTRE = uint64_t(1) << 32;
+    static uint32_t diRak(uint64_t s) { return static_cast<uint32_t>(s); }
+    static uint32_t antre(uint64_t s) { return static_cast<uint32_t>(s >> 32); }
+
+    RefTeks simpan(string_view s) {
+        RefTeks r{static_cast<uint32_t>(arena.size()), static_cast<uint32_t>(s.size())};
+        arena.append(s.data(), s.size());
+        return r;
+    }
+
+    vector<RefTeks>* tabelSamping(uint8_t kode) {
+        switch (kode) {
+            case Book::KODE: return &penulis;
+            case Magazine::KODE: return &edisi;
+            case DVD::KODE: return &sutradara;
+            case Alat::KODE: return &spesifikasi;
+        }
+        return nullptr;
+    }
+
+    void reserveStatus(size_t n) {
+        if (n <= kapasitasStatus) return;
+        unique_ptr<atomic<uint64_t>[]> baru(new atomic<uint64_t>[n]);
+        for (size_t i = 0; i < tag.size(); i++) {
+            baru[i].store(status[i].load(memory_order_relaxed), memory_order_relaxed);
+        }
+        status = move(baru);
+        kapasitasStatus = n;
+    }
+
+    void tulisStatus(uint32_t slot, uint64_t s) const {
+        status[slot].store(s, memory_order_release);
+        tersedia.set(slot, diRak(s) > 0);
+    }
+
+    template <typename T>
+    static size_t kapasitasByte(const vector<T>& v) { return v.capacity() * sizeof(T); }
+
+public:
+    // tambahin satu baris, balikin slot-nya. eksemplar 0 dianggep 1
+    uint32_t tambah(const DataItem& data) {
+        uint32_t slot = static_cast<uint32_t>(tag.size());
+        uint8_t kode = data.kode < JUMLAH_KODE_TIPE ? data.kode : 0;
+        uint32_t total = max<uint32_t>(1, data.eksemplar);
+
+        if (slot % 64 == 0) {
+            for (auto& mask : maskTipe) mask.push_back(0);
+        }
+        maskTipe[0].back() |= uint64_t(1) << (slot % 64);
+        maskTipe[kode].back() |= uint64_t(1) << (slot % 64);
+
+        // ID duluan - buangTerakhir motong arena balik ke offset ID
+        id.push_back(simpan(data.id));
+        kunciId.push_back(awalanTeks(data.id));
+        judul.push_back(simpan(data.judul));
+        vector<RefTeks>* samping = tabelSamping(kode);
+        barisSamping.push_back(samping ? static_cast<uint32_t>(samping->size()) : 0);
+        if (samping) samping->push_back(simpan(data.detail));
+
+        if (slot >= kapasitasStatus) reserveStatus(max<size_t>(64, kapasitasStatus * 2));
+        tag.push_back(kode);
+        varian.push_back(data.varian);
+        eksemplar.push_back(total);
+        tersedia.tambah(false);
+        tulisStatus(slot, min(data.diRak, total));
+        return slot;
+    }
+
+    // batalin tambah() terakhir (misal ID-nya ternyata dobel)
+    void buangTerakhir() {
+        uint32_t slot = static_cast<uint32_t>(tag.size() - 1);
+        arena.resize(id[slot].off);
+        if (vector<RefTeks>* samping = tabelSamping(tag[slot])) samping->pop_back();
+        for (auto& mask : maskTipe) {
+            if (slot % 64 == 0) mask.pop_back();
+            else mask.back() &= ~(uint64_t(1) << (slot % 64));
+        }
+        tersedia.set(slot, false);
+        tersedia.buangTerakhir();
+        tag.pop_back();
+        varian.pop_back();
+        id.pop_back();
+        kunciId.pop_back();
+        judul.pop_back();
+        barisSamping.pop_back();
+        eksemplar.pop_back();
+    }
+
+    void reserve(size_t n) {
+        tag.reserve(n);
+        varian.reserve(n);
+        tersedia.reserve(n);
+        id.reserve(n);
+        kunciId.reserve(n);
+        judul.reserve(n);
+        barisSamping.reserve(n);
+        eksemplar.reserve(n);
+        reserveStatus(n);
+        for (auto& mask : maskTipe) mask.reserve((n + 63) / 64);
+    }
+
+    void clear() {
+        tag.clear();
+        varian.clear();
+        tersedia.clear();
+        id.clear();
+        kunciId.clear();
+        judul.clear();
+        barisSamping.clear();
+        eksemplar.clear();
+        arena.clear();
+        for (auto& mask : maskTipe) mask.clear();
+        penulis.clear();
+        edisi.clear();
+        sutradara.clear();
+        spesifikasi.clear();
+    }
+
+    size_t size() const { return tag.size(); }
+    string_view teks(RefTeks r) const { return string_view(arena.data() + r.off, r.len); }
+
+    uint8_t getTag(uint32_t slot) const { return tag[slot]; }
+    bool isTersedia(uint32_t slot) const { return tersedia.get(slot); }
+    string_view getId(uint32_t slot) const { return teks(id[slot]); }
+    uint64_t getKunciId(uint32_t slot) const { return kunciId[slot]; }
+    string_view getJudul(uint32_t slot) const { return teks(judul[slot]); }
+    bool getVarian(uint32_t slot) const { return varian[slot]; }
+
+    // banding ID slot vs ID lain (kunci-nya udah diitung pemanggil): <0, 0, >0
+    int bandingId(uint32_t slot, uint64_t kunci, string_view idLain) const {
+        if (kunciId[slot] != kunci) return kunciId[slot] < kunci ? -1 : 1;
+        return getId(slot).compare(idLain);
+    }
+
+    bool idSebelum(uint32_t a, uint32_t b) const {
+        if (kunciId[a] != kunciId[b]) return kunciId[a] < kunciId[b];
+        return getId(a) < getId(b);
+    }
+
+    // field khusus tipe - string kosong kalo ga relevan buat tipe itu
+    string_view getDetail(uint32_t slot) const {
+        switch (tag[slot]) {
+            case Book::KODE: return teks(penulis[barisSamping[slot]]);
+            case Magazine::KODE: return teks(edisi[barisSamping[slot]]);
+            case DVD::KODE: return teks(sutradara[barisSamping[slot]]);
+            case Alat::KODE: return teks(spesifikasi[barisSamping[slot]]);
+        }
+        return {};
+    }
+
+    // aturan langsung dari tabel kebijakan, diindeks tag + varian
+    int maxHariPinjam(uint32_t slot) const {
+        return kebijakan().maxHari(tag[slot], varian[slot]);
+    }
+
+    double tarifDenda(uint32_t slot) const {
+        return kebijakan().tarifDenda(tag[slot], varian[slot]);
+    }
+
+    double hitungDenda(uint32_t slot, int hariTerlambat) const {
+        return tarifDenda(slot) * hariTerlambat;
+    }
+
+    // --- status eksemplar ---
+    KeadaanItem keadaan(uint32_t slot) const {
+        return KeadaanItem{status[slot].load(memory_order_acquire), eksemplar[slot]};
+    }
+
+    uint32_t jumlahEksemplar(uint32_t slot) const { return eksemplar[slot]; }
+    uint32_t eksemplarDiRak(uint32_t slot) const { return diRak(status[slot].load(memory_order_acquire)); }
+    uint32_t panjangAntrean(uint32_t slot) const { return antre(status[slot].load(memory_order_acquire)); }
+
+    // compare-and-swap: cuma satu thread yang bisa menang ambil eksemplar terakhir
+    bool cobaAmbil(uint32_t slot) const {
+        uint64_t s = status[slot].load(memory_order_acquire);
+        while (diRak(s) > 0) {
+            if (status[slot].compare_exchange_weak(s, s - 1, memory_order_acq_rel)) {
+                if (diRak(s) == 1) tersedia.set(slot, false);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // eksemplar yang balik langsung jadi jatah antrean kalo ada yang nunggu -
+    // ga sempet mampir ke rak, jadi ga bisa diserobot peminjam biasa
+    Balik cobaBalikin(uint32_t slot) const {
+        uint64_t s = status[slot].load(memory_order_acquire);
+        while (diRak(s) < eksemplar[slot]) {
+            bool adaAntrean = antre(s) > 0;
+            if (status[slot].compare_exchange_weak(s, adaAntrean ? s - SATU_ANTRE : s + 1, memory_order_acq_rel)) {
+                if (adaAntrean) return Balik::KE_ANTREAN;
+                if (diRak(s) == 0) tersedia.set(slot, true);
+                return Balik::KE_RAK;
+            }
+        }
+        return Balik::GAGAL;
+    }
+
+    // masuk antrean reservasi - cuma boleh kalo rak lagi kosong
+    bool cobaAntre(uint32_t slot) const {
+        uint64_t s = status[slot].load(memory_order_acquire);
+        while (diRak(s) == 0) {
+            if (status[slot].compare_exchange_weak(s, s + SATU_ANTRE, memory_order_acq_rel)) return true;
+        }
+        return false;
+    }
+
+    // ganti total eksemplar (lock struktur exclusive, ga ada transaksi lain).
+    // yang lagi dipinjem ga boleh lebih dari total baru. eksemplar baru yang
+    // nganggur dijatahin ke antrean dulu - `keAntrean` = berapa kepala antrean
+    // yang harus diserahin eksemplar sama pemanggil
+    bool setEksemplar(uint32_t slot, uint32_t total, uint32_t& keAntrean) {
+        uint64_t s = status[slot].load(memory_order_acquire);
+        uint32_t dipinjam = eksemplar[slot] - diRak(s);
+        if (total == 0 || total < dipinjam) return false;
+        uint32_t nganggur = total - dipinjam;
+        keAntrean = min(nganggur, antre(s));
+        eksemplar[slot] = total;
+        tulisStatus(slot, (uint64_t(antre(s) - keAntrean) << 32) | (nganggur - keAntrean));
+        return true;
+    }
+
+    size_t hitungTersedia() const { return tersedia.hitung(); }
+
+    // jumlah item tipe `kode` yang lagi tersedia (kode 0 = semua tipe)
+    size_t hitungTersediaTipe(uint8_t kode, const KernelBitset& kernel = kernelBitset()) const {
+        if (kode >= JUMLAH_KODE_TIPE) return 0;
+        return kernel.hitungIrisan(tersedia.mentah(), maskTipe[kode].data(), tersedia.jumlahKata());
+    }
+
+    // slot tersedia pertama bertipe `kode` mulai dari slot `mulai`, size() kalo ga ada
+    uint32_t cariTersedia(uint8_t kode, uint32_t mulai = 0,
+                          const KernelBitset& kernel = kernelBitset()) const {
+        size_t nKata = tersedia.jumlahKata();
+        if (kode >= JUMLAH_KODE_TIPE || mulai >= size()) return static_cast<uint32_t>(size());
+        const uint64_t* a = tersedia.mentah();
+        const uint64_t* b = maskTipe[kode].data();
+
+        size_t k = mulai / 64;
+        uint64_t sisa = a[k] & b[k] & (~uint64_t(0) << (mulai % 64));
+        if (!sisa) {
+            k = kernel.cariIrisan(a, b, k + 1, nKata);
+            if (k == nKata) return static_cast<uint32_t>(size());
+            sisa = a[k] & b[k];
+            // kata-nya bisa keburu berubah sama thread lain, lanjut aja cari lagi
+            if (!sisa) return cariTersedia(kode, static_cast<uint32_t>(k * 64 + 64), kernel);
+        }
+        return static_cast<uint32_t>(k * 64 + __builtin_ctzll(sisa));
+    }
+
+    // maks `n` slot tersedia pertama bertipe `kode`, misal "5 DVD pertama yang ready"
+    vector<uint32_t> daftarTersedia(uint8_t kode, size_t n) const {
+        vector<uint32_t> hasil;
+        for (uint32_t slot = cariTersedia(kode); slot < size() && hasil.size() < n;
+             slot = cariTersedia(kode, slot + 1)) {
+            hasil.push_back(slot);
+        }
+        return hasil;
+    }
+
+    class IteratorTersedia;
+    struct RentangTersedia;
+    inline RentangTersedia semuaTersedia(uint8_t kode) const;
+
+    // popcount mask tipe-nya, ga perlu nyentuh array tag sama sekali
+    // (kode 0 = semua tipe)
+    size_t hitungTipe(uint8_t kode) const {
+        if (kode >= JUMLAH_KODE_TIPE) return 0;
+        size_t total = 0;
+        for (uint64_t kata : maskTipe[kode]) total += __builtin_popcountll(kata);
+        return total;
+    }
+
+    inline Item lihat(uint32_t slot) const;
+
+    size_t ukuranMemori() const {
+        return kapasitasByte(tag) + kapasitasByte(varian) + tersedia.ukuranMemori() +
+               kapasitasByte(id) + kapasitasByte(kunciId) + kapasitasByte(judul) +
+               kapasitasByte(barisSamping) + kapasitasByte(eksemplar) + kapasitasStatus * sizeof(uint64_t) +
+               arena.capacity() + kapasitasByte(penulis) + kapasitasByte(edisi) +
+               kapasitasByte(sutradara) + kapasitasByte(spesifikasi);
+    }
+};
+
+// ===========================
+// KELAS ITEM (VIEW KE KATALOG KOLOM)
+// ===========================
+// tampilan ringan satu item - cuma pointer kolom + slot, ga ada alokasi,
+// ga ada virtual. semua data & status-nya tinggal di KatalogKolom. valid
+// selama pemanggil megang lock struktur Perpustakaan (shared cukup).
+// default-nya kosong (kaya nullptr) - cek pake `if (item)`
+class Item {
+private:
+    const KatalogKolom* kolom = nullptr;
+    uint32_t slot = 0;
+
+public:
+    using Balik = KatalogKolom::Balik;
+
+    Item() = default;
+    Item(const KatalogKolom* kolom, uint32_t slot) : kolom(kolom), slot(slot) {}
+
+    explicit operator bool() const { return kolom != nullptr; }
+
+    uint32_t getSlot() const { return slot; }
+    string_view getId() const { return kolom->getId(slot); }
+    string_view getJudul() const { return kolom->getJudul(slot); }
+    string_view getTipe() const { return NAMA_TIPE[kolom->getTag(slot)]; }
+    uint8_t kodeTipe() const { return kolom->getTag(slot); }
+    bool getVarian() const { return kolom->getVarian(slot); }
+    string_view getDetail() const { return kolom->getDetail(slot); }
+
+    KeadaanItem keadaan() const { return kolom->keadaan(slot); }
+    bool isTersedia() const { return kolom->eksemplarDiRak(slot) > 0; }
+    uint32_t jumlahEksemplar() const { return kolom->jumlahEksemplar(slot); }
+    uint32_t eksemplarDiRak() const { return kolom->eksemplarDiRak(slot); }
+    uint32_t panjangAntrean() const { return kolom->panjangAntrean(slot); }
+
+    bool cobaAmbil() const { return kolom->cobaAmbil(slot); }
+    Balik cobaBalikin() const { return kolom->cobaBalikin(slot); }
+    bool cobaAntre() const { return kolom->cobaAntre(slot); }
+
+    // aturan langsung dari tabel kebijakan lewat tag + varian - ga virtual
+    int batasHari() const { return kolom->maxHariPinjam(slot); }
+    int maxHariPinjam() const { return batasHari(); }
+    double tarifDenda() const { return kolom->tarifDenda(slot); }
+    double dendaKembali(int hariAktual, bool rusak = false) const {
+        return kebijakan().dendaKembali(kodeTipe(), getVarian(), hariAktual, rusak);
+    }
+    double hitungDenda(int hariTerlambat) const { return kolom->hitungDenda(slot, hariTerlambat); }
+
+    // OVERLOAD - bisa tambah biaya rusak (DVD rusak langsung +50k - sakit)
+    double hitungDenda(int hariTerlambat, bool rusak) const {
+        double dendaDasar = hitungDenda(hariTerlambat);
+        return rusak ? dendaDasar + kebijakan().tipe[kodeTipe()].biayaRusak : dendaDasar;
+    }
+
+    // serialisasi: [kode][id][judul][status...][field tipe]. item satu
+    // eksemplar ditulis persis format lama. `k` = status yang ditulis (bisa
+    // versi lama punya potret)
+    void tulisKe(PenulisBiner& out, const KeadaanItem& k) const {
+        out.tulis<uint8_t>(kodeTipe());
+        out.tulisString(getId());
+        out.tulisString(getJudul());
+        bool banyak = k.eksemplar != 1;
+        out.tulis<uint8_t>(k.isTersedia() | (banyak ? DataItem::FLAG_EKSEMPLAR : 0));
+        if (banyak) {
+            out.tulis<uint32_t>(k.eksemplar);
+            out.tulis<uint32_t>(k.diRak());
+        }
+        switch (kodeTipe()) {
+            case Book::KODE:
+                out.tulisString(getDetail());
+                out.tulis<uint8_t>(getVarian());
+                break;
+            case Magazine::KODE:
+            case DVD::KODE:
+                out.tulisString(getDetail());
+                break;
+            case Alat::KODE:
+                out.tulis<uint8_t>(getVarian());
+                out.tulisString(getDetail());
+                break;
+        }
+    }
+
+    void tulisKe(PenulisBiner& out) const { tulisKe(out, keadaan()); }
+
+    // operator overload buat sorting katalog - ez clap
+    // kunci ID duluan, string cuma kalo seri - sama kaya BandingId
+    bool operator<(const Item& lain) const {
+        uint64_t a = kolom->getKunciId(slot), b = lain.kolom->getKunciId(lain.slot);
+        return a != b ? a < b : getId() < lain.getId();
+    }
+
+    // info item versi teks, ditambahin ke `out` - baris kedua detail per tipe.
+    // listing gede nulis lewat sini ke satu buffer, ga lewat cout per baris
+    void tulisInfo(string& out, const KeadaanItem& k) const {
+        out += "ID: ";
+        out += getId();
+        out += " | Judul: ";
+        out += getJudul();
+        out += " | Status: ";
+        out += k.isTersedia() ? "Tersedia" : "Dipinjam";
+        if (k.eksemplar != 1) {
+            out += " (" + to_string(k.diRak()) + "/" + to_string(k.eksemplar) + " eksemplar";
+            if (k.antre() > 0) out += ", antre " + to_string(k.antre());
+            out += ')';
+        }
+        out += '\n';
+        switch (kodeTipe()) {
+            case Book::KODE:
+                out += "  Penulis: ";
+                out += getDetail();
+                out += getVarian() ? " | Langka: Ya\n" : " | Langka: Tidak\n";
+                break;
+            case Magazine::KODE:
+                out += "  Edisi: ";
+                out += getDetail();
+                out += '\n';
+                break;
+            case DVD::KODE:
+                out += "  Sutradara: ";
+                out += getDetail();
+                out += '\n';
+                break;
+            case Alat::KODE:
+                out += getVarian() ? "  Kategori: Elektronik | Daya: " : "  Kategori: NonElektronik | Bahan: ";
+                out += getDetail();
+                out += '\n';
+                break;
+        }
+    }
+
+    void tulisInfo(string& out) const { tulisInfo(out, keadaan()); }
+
+    void tampilInfo() const {
+        string s;
+        tulisInfo(s);
+        cout << s << flush;
+    }
+};
+
+inline Item KatalogKolom::lihat(uint32_t slot) const { return Item(this, slot); }
+
+// iterasi semua item tersedia bertipe tertentu:
+//   for (Item v : kolom.semuaTersedia(DVD::KODE)) ...
+class KatalogKolom::IteratorTersedia {
+private:
+    const KatalogKolom* kolom;
+    uint8_t kode;
+    uint32_t slot;
+
+public:
+    IteratorTersedia(const KatalogKolom* kolom, uint8_t kode, uint32_t slot)
+        : kolom(kolom), kode(kode), slot(slot) {}
+
+    Item operator*() const { return kolom->lihat(slot); }
+    IteratorTersedia& operator++() {
+        slot = kolom->cariTersedia(kode, slot + 1);
+        return *this;
+    }
+    bool operator!=(const IteratorTersedia& lain) const { return slot != lain.slot; }
+};
+
+struct KatalogKolom::RentangTersedia {
+    const KatalogKolom* kolom;
+    uint8_t kode;
+
+    IteratorTersedia begin() const { return IteratorTersedia(kolom, kode, kolom->cariTersedia(kode)); }
+    IteratorTersedia end() const {
+        return IteratorTersedia(kolom, kode, static_cast<uint32_t>(kolom->size()));
+    }
+};
+
+inline KatalogKolom::RentangTersedia KatalogKolom::semuaTersedia(uint8_t kode) const {
+    return RentangTersedia{this, kode};
+}
+
+// ===========================
+// HASIL TRANSAKSI
+// ===========================
+// status satu transaksi - dipake jalur batch & pemanggil non-interaktif
+enum class StatusTransaksi : uint8_t {
+    SUKSES = 0,
+    MEMBER_TIDAK_ADA,
+    ITEM_TIDAK_ADA,
+    ITEM_DIPINJAM,        // item lagi dipinjam orang lain
+    HARI_KEBANYAKAN,      // melebihi maxHariPinjam
+    HARI_TIDAK_VALID,     // hari pinjam <= 0
+    ITEM_TIDAK_DIPINJAM,  // balikin item yang ga lagi dipinjam
+    BUKAN_DVD,
+    ID_DUPLIKAT,          // tambah item / register member pake ID yang udah ada
+    ITEM_TERSEDIA,        // reservasi padahal masih ada eksemplar di rak - pinjem aja langsung
+    SUDAH_ANTRE,          // member-nya udah ada di antrean reservasi judul ini
+    EKSEMPLAR_TIDAK_VALID // total eksemplar 0 / kurang dari yang lagi dipinjem
+};
+
+// nama status apa adanya - buat protokol mesin (mode headless)
+inline const char* namaStatus(StatusTransaksi s) {
+    static const char* const NAMA[] = {"SUKSES",           "MEMBER_TIDAK_ADA",    "ITEM_TIDAK_ADA",
+                                       "ITEM_DIPINJAM",    "HARI_KEBANYAKAN",     "HARI_TIDAK_VALID",
+                                       "ITEM_TIDAK_DIPINJAM", "BUKAN_DVD",        "ID_DUPLIKAT",
+                                       "ITEM_TERSEDIA",    "SUDAH_ANTRE",         "EKSEMPLAR_TIDAK_VALID"};
+    size_t i = static_cast<size_t>(s);
+    return i < sizeof(NAMA) / sizeof(NAMA[0]) ? NAMA[i] : "?";
+}
+
+struct HasilTransaksi {
+    StatusTransaksi status;
+    bool pakeKredit;   // lewat jalur kredit gratis (kalo gagal, kreditnya balik)
+    bool naikLevel;    // member naik level gara2 transaksi ini
+    double denda;
+    bool diteruskan;   // eksemplar yang dibalikin langsung dipinjemin ke antrean reservasi
+
+    static HasilTransaksi dari(StatusTransaksi status) { return {status, false, false, 0.0, false}; }
+    bool ok() const { return status == StatusTransaksi::SUKSES; }
+};
+
+// satu permintaan di batch. ID-nya string_view - pemanggil yang jaga
+// buffer aslinya tetep hidup selama prosesBatch jalan
+struct PermintaanTransaksi {
+    enum Jenis : uint8_t { PINJAM, KEMBALI, KEMBALI_DVD };
+    Jenis jenis;
+    bool opsi;          // PINJAM: pake kredit, KEMBALI_DVD: rusak
+    int32_t hari;       // PINJAM: hari diminta, KEMBALI*: hari aktual
+    string_view idMember;
+    string_view idItem;
+};
+
+// ===========================
+// METRIK & INSTRUMENTASI
+// ===========================
+// tiap operasi penting dihitung per status (jadi alasan penolakan kaya
+// ITEM_DIPINJAM / HARI_KEBANYAKAN / HARI_TIDAK_VALID kepisah) plus
+// histogram latensinya. tiap thread nulis ke blok sendiri tanpa lock,
+// blok2-nya baru dijumlahin pas dibaca (menu 17 / dump Prometheus).
+// baca jam itu yang mahal (~45 ns sekali di VM), jadi latensinya disampel:
+// bawaan 1 dari 8 operasi per thread, ganti pake --metrik <N> (1 = semua,
+// 0 = mati, tinggal counter ~2 ns). -DPERPUS_METRIK=0 ngilangin semuanya
+#ifndef PERPUS_METRIK
+#define PERPUS_METRIK 1
+#endif
+
+enum class OpMetrik : uint8_t {
+    PINJAM, KEMBALI, KEMBALI_DVD, CARI_ITEM, CARI_MEMBER, LAPORAN, BATCH, RESERVASI, JUMLAH
+};
+
+const char* const NAMA_OP_METRIK[] = {"pinjam",    "kembali",     "kembali_dvd", "cari_item",
+                                      "cari_member", "laporan", "batch",      "reservasi"};
+
+// bucket ala HDR histogram: tiap rentang 2^k dipecah 8 sub-bucket linear,
+// jadi error relatifnya paling gede 12.5% dari 1 ns sampe ~9 menit
+struct BucketLatensi {
+    static constexpr int LOG_SUB = 3;
+    static constexpr int SUB = 1 << LOG_SUB;
+    static constexpr int MAKS_EKSPONEN = 39;
+    static constexpr size_t JUMLAH = (MAKS_EKSPONEN - LOG_SUB + 2) * SUB;
+
+    static size_t indeks(uint64_t ns) {
+        if (ns < SUB) return static_cast<size_t>(ns);
+        int e = 63 - __builtin_clzll(ns);
+        if (e > MAKS_EKSPONEN) return JUMLAH - 1;
+        return static_cast<size_t>((e - LOG_SUB + 1) * SUB + ((ns >> (e - LOG_SUB)) & (SUB - 1)));
+    }
+
+    // nilai terbesar yang masuk bucket ini
+    static uint64_t batasAtas(size_t idx) {
+        if (idx < SUB) return idx;
+        int e = static_cast<int>(idx / SUB) + LOG_SUB - 1;
+        uint64_t bawah = (SUB + idx % SUB) << (e - LOG_SUB);
+        return bawah + (uint64_t(1) << (e - LOG_SUB)) - 1;
+    }
+};
+
+constexpr size_t JUMLAH_OP_METRIK = static_cast<size_t>(OpMetrik::JUMLAH);
+constexpr size_t JUMLAH_STATUS_METRIK = 16;  // muat semua StatusTransaksi
+
+// counter punya satu thread. penulisnya cuma thread itu, jadi cukup
+// load + store relaxed (ga ada lock add); pembaca thread lain tetep dapet
+// nilai yang utuh
+struct BlokMetrik {
+    array<array<atomic<uint64_t>, JUMLAH_STATUS_METRIK>, JUMLAH_OP_METRIK> status;
+    array<array<atomic<uint64_t>, BucketLatensi::JUMLAH>, JUMLAH_OP_METRIK> bucket;
+    array<atomic<uint64_t>, JUMLAH_OP_METRIK> totalNs;
+    uint32_t hitungSampel = 0;  // cuma disentuh thread pemilik
+
+    BlokMetrik() { reset(); }
+
+    static void tambah(atomic<uint64_t>& a, uint64_t n) {
+        a.store(a.load(memory_order_relaxed) + n, memory_order_relaxed);
+    }
+
+    void reset() {
+        for (auto& op : status) for (auto& c : op) c.store(0, memory_order_relaxed);
+        for (auto& op : bucket) for (auto& c : op) c.store(0, memory_order_relaxed);
+        for (auto& c : totalNs) c.store(0, memory_order_relaxed);
+    }
+};
+
+// hasil gabungan semua thread
+struct RingkasanMetrik {
+    struct PerOp {
+        array<uint64_t, JUMLAH_STATUS_METRIK> status{};
+        vector<uint64_t> bucket = vector<uint64_t>(BucketLatensi::JUMLAH);
+        uint64_t totalNs = 0;
+        uint64_t sampel = 0;  // jumlah yang latensinya diukur
+
+        uint64_t jumlah() const {
+            uint64_t n = 0;
+            for (uint64_t s : status) n += s;
+            return n;
+        }
+
+        // persentil dari histogram - batas atas bucket-nya
+        uint64_t persentilNs(double q) const {
+            if (sampel == 0) return 0;
+            // nearest-rank: sampel ke-ceil(q*n)
+            double rank = q * sampel;
+            uint64_t target = max<uint64_t>(1, static_cast<uint64_t>(rank) + (rank > uint64_t(rank))), jalan = 0;
+            for (size_t i = 0; i < bucket.size(); i++) {
+                jalan += bucket[i];
+                if (jalan >= target) return BucketLatensi::batasAtas(i);
+            }
+            return BucketLatensi::batasAtas(bucket.size() - 1);
+        }
+    };
+    array<PerOp, JUMLAH_OP_METRIK> op;
+};
+
+class Metrik {
+private:
+    mutable mutex mtx;
+    vector<BlokMetrik*> blok;  // blok thread yang masih hidup
+    BlokMetrik pensiun;        // titipan dari thread yang udah selesai
+    atomic<uint32_t> periode;  // latensi diukur 1 dari sekian operasi, 0 = ga diukur
+
+    struct Pemegang {
+        Metrik* pemilik;
+        BlokMetrik* b;
+        ~Pemegang() { pemilik->lepas(b); }
+    };
+
+    BlokMetrik* daftarBaru() {
+        BlokMetrik* b = new BlokMetrik();
+        lock_guard<mutex> lk(mtx);
+        blok.push_back(b);
+        return b;
+    }
+
+    // thread-nya selesai: angkanya dipindah ke `pensiun` biar ga ilang
+    void lepas(BlokMetrik* b) {
+        {
+            lock_guard<mutex> lk(mtx);
+            for (size_t o = 0; o < JUMLAH_OP_METRIK; o++) {
+                for (size_t s = 0; s < JUMLAH_STATUS_METRIK; s++)
+                    BlokMetrik::tambah(pensiun.status[o][s], b->status[o][s].load(memory_order_relaxed));
+                for (size_t i = 0; i < BucketLatensi::JUMLAH; i++)
+                    BlokMetrik::tambah(pensiun.bucket[o][i], b->bucket[o][i].load(memory_order_relaxed));
+                BlokMetrik::tambah(pensiun.totalNs[o], b->totalNs[o].load(memory_order_relaxed));
+            }
+            blok.erase(find(blok.begin(), blok.end(), b));
+        }
+        delete b;
+    }
+
+public:
+    static constexpr uint32_t PERIODE_BAWAAN = 8;
+
+    Metrik() : periode(PERIODE_BAWAAN) {}
+
+    BlokMetrik& blokSaya() {
+        thread_local Pemegang pemegang{this, daftarBaru()};
+        return *pemegang.b;
+    }
+
+    uint32_t periodeSampel() const { return periode.load(memory_order_relaxed); }
+    void setPeriodeSampel(uint32_t n) { periode.store(n, memory_order_relaxed); }
+
+    // operasi ini kebagian diukur latensinya?
+    bool giliranUkur(BlokMetrik& b) const {
+        uint32_t p = periode.load(memory_order_relaxed);
+        if (p == 0 || ++b.hitungSampel < p) return false;
+        b.hitungSampel = 0;
+        return true;
+    }
+
+    void catat(OpMetrik op, StatusTransaksi status, uint64_t jumlah = 1) {
+        catat(blokSaya(), op, status, jumlah);
+    }
+
+    static void catat(BlokMetrik& b, OpMetrik op, StatusTransaksi status, uint64_t jumlah = 1) {
+        BlokMetrik::tambah(b.status[static_cast<size_t>(op)][static_cast<size_t>(status)], jumlah);
+    }
+
+    static void catatLatensi(BlokMetrik& b, OpMetrik op, uint64_t ns) {
+        size_t o = static_cast<size_t>(op);
+        BlokMetrik::tambah(b.bucket[o][BucketLatensi::indeks(ns)], 1);
+        BlokMetrik::tambah(b.totalNs[o], ns);
+    }
+
+    RingkasanMetrik baca() const {
+        RingkasanMetrik r;
+        lock_guard<mutex> lk(mtx);
+        auto gabung = [&](const BlokMetrik& b) {
+            for (size_t o = 0; o < JUMLAH_OP_METRIK; o++) {
+                RingkasanMetrik::PerOp& p = r.op[o];
+                for (size_t s = 0; s < JUMLAH_STATUS_METRIK; s++) p.status[s] += b.status[o][s].load(memory_order_relaxed);
+                for (size_t i = 0; i < BucketLatensi::JUMLAH; i++) {
+                    uint64_t n = b.bucket[o][i].load(memory_order_relaxed);
+                    p.bucket[i] += n;
+                    p.sampel += n;
+                }
+                p.totalNs += b.totalNs[o].load(memory_order_relaxed);
+            }
+        };
+        gabung(pensiun);
+        for (const BlokMetrik* b : blok) gabung(*b);
+        return r;
+    }
+
+    // blok punya thread lain ikut di-nol-in - angka yang lagi ditulis
+    // barengan bisa nyelip, buat metrik ga masalah
+    void reset() {
+        lock_guard<mutex> lk(mtx);
+        pensiun.reset();
+        for (BlokMetrik* b : blok) b->reset();
+    }
+};
+
+Metrik metrik;
+
+// ukur satu operasi: jam dibaca cuma kalo operasi ini kebagian sampel
+class PengukurMetrik {
+private:
+#if PERPUS_METRIK
+    OpMetrik op;
+    BlokMetrik& blok;
+    bool ukur;
+    chrono::steady_clock::time_point mulai;
+#endif
+
+public:
+#if PERPUS_METRIK
+    explicit PengukurMetrik(OpMetrik op) : op(op), blok(metrik.blokSaya()), ukur(metrik.giliranUkur(blok)) {
+        if (ukur) mulai = chrono::steady_clock::now();
+    }
+
+    void selesai(StatusTransaksi status) {
+        Metrik::catat(blok, op, status);
+        if (ukur) {
+            auto ns = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - mulai).count();
+            Metrik::catatLatensi(blok, op, static_cast<uint64_t>(ns));
+        }
+    }
+#else
+    explicit PengukurMetrik(OpMetrik) {}
+    void selesai(StatusTransaksi) {}
+#endif
+};
+
+// teks exposition format Prometheus. bucket histogram cuma yang ada isinya
+// (kumulatif), latensi dalam detik. _count histogram = jumlah yang disampel,
+// jumlah operasi sebenernya di perpus_operasi_total
+string formatPrometheus(const RingkasanMetrik& r) {
+    string s;
+    char tmp[192];
+    s += "# HELP perpus_operasi_total Jumlah operasi per jenis dan status hasil\n";
+    s += "# TYPE perpus_operasi_total counter\n";
+    for (size_t o = 0; o < JUMLAH_OP_METRIK; o++) {
+        for (size_t st = 0; st < JUMLAH_STATUS_METRIK; st++) {
+            if (r.op[o].status[st] == 0) continue;
+            snprintf(tmp, sizeof(tmp), "perpus_operasi_total{op=\"%s\",status=\"%s\"} %llu\n", NAMA_OP_METRIK[o],
+                     namaStatus(static_cast<StatusTransaksi>(st)), static_cast<unsigned long long>(r.op[o].status[st]));
+            s += tmp;
+        }
+    }
+    s += "# HELP perpus_latensi_detik Latensi operasi\n";
+    s += "# TYPE perpus_latensi_detik histogram\n";
+    for (size_t o = 0; o < JUMLAH_OP_METRIK; o++) {
+        const RingkasanMetrik::PerOp& p = r.op[o];
+        if (p.sampel == 0) continue;
+        uint64_t kumulatif = 0;
+        for (size_t i = 0; i < p.bucket.size(); i++) {
+            if (p.bucket[i] == 0) continue;
+            kumulatif += p.bucket[i];
+            snprintf(tmp, sizeof(tmp), "perpus_latensi_detik_bucket{op=\"%s\",le=\"%.9g\"} %llu\n", NAMA_OP_METRIK[o],
+                     (BucketLatensi::batasAtas(i) + 1) / 1e9, static_cast<unsigned long long>(kumulatif));
+            s += tmp;
+        }
+        snprintf(tmp, sizeof(tmp),
+                 "perpus_latensi_detik_bucket{op=\"%s\",le=\"+Inf\"} %llu\n"
+                 "perpus_latensi_detik_sum{op=\"%s\"} %.9g\nperpus_latensi_detik_count{op=\"%s\"} %llu\n",
+                 NAMA_OP_METRIK[o], static_cast<unsigned long long>(p.sampel), NAMA_OP_METRIK[o], p.totalNs / 1e9,
+                 NAMA_OP_METRIK[o], static_cast<unsigned long long>(p.sampel));
+        s += tmp;
+    }
+    return s;
+}
+
+// tabel buat menu: jumlah, sukses, latensi, terus alasan gagal
+void tampilkanMetrik(const RingkasanMetrik& r) {
+    cout << "\n📈 === METRIK OPERASI ===" << endl;
+    cout << setw(13) << left << "operasi" << right << setw(10) << "jumlah" << setw(10) << "sukses" << setw(10)
+         << "rata2 us" << setw(10) << "p50 us" << setw(10) << "p99 us" << setw(10) << "p999 us" << endl;
+    bool ada = false;
+    for (size_t o = 0; o < JUMLAH_OP_METRIK; o++) {
+        const RingkasanMetrik::PerOp& p = r.op[o];
+        if (p.jumlah() == 0) continue;
+        ada = true;
+        cout << setw(13) << left << NAMA_OP_METRIK[o] << right << setw(10) << p.jumlah() << setw(10) << p.status[0]
+             << fixed << setprecision(2) << setw(10) << (p.sampel ? p.totalNs / 1e3 / p.sampel : 0.0) << setw(10)
+             << p.persentilNs(0.50) / 1e3 << setw(10) << p.persentilNs(0.99) / 1e3 << setw(10)
+             << p.persentilNs(0.999) / 1e3 << endl;
+    }
+    if (!ada) {
+        cout << "Belum ada operasi yang kecatet" << endl;
+        return;
+    }
+    cout << "\n🚫 Alasan gagal:" << endl;
+    for (size_t o = 0; o < JUMLAH_OP_METRIK; o++) {
+        for (size_t st = 1; st < JUMLAH_STATUS_METRIK; st++) {
+            if (r.op[o].status[st] == 0) continue;
+            cout << "  " << NAMA_OP_METRIK[o] << " " << namaStatus(static_cast<StatusTransaksi>(st)) << ": "
+                 << r.op[o].status[st] << endl;
+        }
+    }
+    uint32_t periode = metrik.periodeSampel();
+    if (periode == 0) cout << "(pengukuran latensi lagi dimatiin)" << endl;
+    else if (periode > 1) cout << "(latensi disampel 1 dari " << periode << " operasi per thread)" << endl;
+}
+
+// tulis dump Prometheus ke file (atomik lewat file sementara)
+bool dumpMetrikPrometheus(const string& path) {
+    return tulisFileAtomik(path, formatPrometheus(metrik.baca()));
+}
+
+// ===========================
+// EVENT SINK
+// ===========================
+// semua kejadian di Perpustakaan dikirim sebagai Event ke sink yang dipasang.
+// yang mau teks (menu) pasang SinkTeks, yang ga butuh output (batch, benchmark)
+// cukup SinkNoop - event-nya bahkan ga dibikin, jadi ga bayar format teks
+struct Event {
+    enum Jenis : uint8_t {
+        TAMBAH_ITEM,
+        REGISTER_MEMBER,
+        PINJAM,
+        KEMBALI,
+        KEMBALI_DVD,
+        SORT_KATALOG,
+        RESET_STATISTIK,
+        RESERVASI,
+        EKSEMPLAR
+    };
+    Jenis jenis;
+    HasilTransaksi hasil;
+    string_view idMember;
+    string_view idItem;
+    string_view idPenerima;  // KEMBALI*/EKSEMPLAR: kepala antrean yang kebagian eksemplar
+    int32_t hari;        // PINJAM: max hari item, KEMBALI*: hari terlambat, RESERVASI: posisi antrean
+    int32_t level;       // level member sesudah transaksi
+    int32_t sisaKredit;  // kredit gratis member sesudah transaksi
+    bool rusak;          // KEMBALI_DVD
+
+    Event(Jenis jenis, StatusTransaksi status, string_view idMember = {}, string_view idItem = {})
+        : jenis(jenis), hasil(HasilTransaksi::dari(status)), idMember(idMember), idItem(idItem),
+          hari(0), level(0), sisaKredit(0), rusak(false) {}
+};
+
+class EventSink {
+public:
+    virtual ~EventSink() = default;
+    virtual void terima(const Event& ev) = 0;
+    virtual void flush() {}
+    // false = Perpustakaan ga usah repot2 bikin Event
+    virtual bool aktif() const { return true; }
+};
+
+class SinkNoop : public EventSink {
+public:
+    void terima(const Event&) override {}
+    bool aktif() const override { return false; }
+};
+
+// format event jadi pesan yang sama persis kaya dulu, ditampung di buffer.
+// flushTiapEvent = true buat menu interaktif biar urutannya pas sama prompt
+class SinkTeks : public EventSink {
+private:
+    ostream& out;
+    bool flushTiapEvent;
+    mutex mtx;
+    string buf;
+
+    static constexpr size_t BATAS_BUFFER = 1 << 16;
+
+    static void tambahRupiah(string& s, double nilai) {
+        char tmp[32];
+        snprintf(tmp, sizeof(tmp), "%.0f", nilai);
+        s += tmp;
+    }
+
+    void format(const Event& ev) {
+        const HasilTransaksi& h = ev.hasil;
+        switch (ev.jenis) {
+            case Event::TAMBAH_ITEM:
+                buf += h.ok() ? "✅ Item berhasil ditambah ke katalog!\n"
+                              : "❌ ID udah ada cuy! Pake ID lain dong\n";
+                break;
+            case Event::REGISTER_MEMBER:
+                buf += h.ok() ? "✅ Member berhasil terdaftar!\n" : "❌ ID member udah kepake!\n";
+                break;
+            case Event::PINJAM:
+                if (h.pakeKredit) {
+                    buf += "🎁 Pake kredit gratis nih! Sisa: ";
+                    buf += to_string(ev.sisaKredit - (h.ok() ? 0 : 1));
+                    buf += '\n';
+                    if (!h.ok()) buf += "❌ Item lagi dipinjam, kredit balik deh\n";
+                    break;
+                }
+                switch (h.status) {
+                    case StatusTransaksi::SUKSES:
+                        buf += "✅ Sip, berhasil pinjam! Jangan lupa balikin ya~\n";
+                        break;
+                    case StatusTransaksi::MEMBER_TIDAK_ADA:
+                        buf += "❌ Member ga ketemu!\n";
+                        break;
+                    case StatusTransaksi::ITEM_TIDAK_ADA:
+                        buf += "❌ Item ga ada di katalog!\n";
+                        break;
+                    case StatusTransaksi::HARI_KEBANYAKAN:
+                        buf += "❌ Kebanyakan hari cuy! Max cuma " + to_string(ev.hari) +
+                               " hari untuk item ini\n";
+                        break;
+                    case StatusTransaksi::HARI_TIDAK_VALID:
+                        buf += "❌ Hari pinjam harus lebih dari 0 lah!\n";
+                        break;
+                    default:
+                        buf += "❌ Waduh, item lagi dipinjam orang lain bro!\n";
+                }
+                break;
+            case Event::KEMBALI:
+                if (h.status == StatusTransaksi::MEMBER_TIDAK_ADA ||
+                    h.status == StatusTransaksi::ITEM_TIDAK_ADA) {
+                    buf += "❌ Member atau item ga ketemu!\n";
+                } else if (!h.ok()) {
+                    buf += "❌ Lah, item ini ga dipinjam kok!\n";
+                } else if (h.denda > 0) {
+                    buf += "⚠️  Telat " + to_string(ev.hari) + " hari! Denda: Rp";
+                    tambahRupiah(buf, h.denda);
+                    buf += '\n';
+                } else {
+                    buf += "✅ Tepat waktu! Good job bro 👍\n";
+                }
+                break;
+            case Event::KEMBALI_DVD:
+                if (h.status == StatusTransaksi::MEMBER_TIDAK_ADA ||
+                    h.status == StatusTransaksi::ITEM_TIDAK_ADA) {
+                    buf += "❌ Member atau DVD ga ketemu!\n";
+                } else if (h.status == StatusTransaksi::BUKAN_DVD) {
+                    buf += "❌ Item bukan DVD cuy!\n";
+                } else if (!h.ok()) {
+                    buf += "❌ DVD ini ga dipinjam!\n";
+                } else if (h.denda > 0) {
+                    buf += "⚠️  Denda total: Rp";
+                    tambahRupiah(buf, h.denda);
+                    if (ev.rusak) buf += " (termasuk biaya rusak Rp50.000)";
+                    buf += '\n';
+                } else {
+                    buf += "✅ Mantap, DVD balik dalam kondisi aman!\n";
+                }
+                break;
+            case Event::SORT_KATALOG:
+                buf += "✅ Katalog udah di-sort!\n";
+                break;
+            case Event::RESET_STATISTIK:
+                buf += "✅ Statistik bulanan di-reset!\n";
+                break;
+            case Event::RESERVASI:
+                switch (h.status) {
+                    case StatusTransaksi::SUKSES:
+                        buf += "📝 Masuk antrean reservasi, posisi ke-" + to_string(ev.hari) + "\n";
+                        break;
+                    case StatusTransaksi::ITEM_TERSEDIA:
+                        buf += "ℹ️  Masih ada eksemplar di rak, langsung pinjem aja bro\n";
+                        break;
+                    case StatusTransaksi::SUDAH_ANTRE:
+                        buf += "❌ Udah ada di antrean judul ini!\n";
+                        break;
+                    default:
+                        buf += "❌ Member atau item ga ketemu!\n";
+                }
+                break;
+            case Event::EKSEMPLAR:
+                if (h.ok()) buf += "✅ Jumlah eksemplar " + string(ev.idItem) + " jadi " + to_string(ev.hari) + "\n";
+                else if (h.status == StatusTransaksi::ITEM_TIDAK_ADA) buf += "❌ Item ga ada di katalog!\n";
+                else buf += "❌ Jumlah eksemplar ga boleh 0 / kurang dari yang lagi dipinjem!\n";
+                break;
+        }
+        if (!ev.idPenerima.empty()) {
+            buf += "📬 Eksemplar langsung dipinjemin ke ";
+            buf += ev.idPenerima;
+            buf += " (antrean reservasi)\n";
+        }
+        if (h.naikLevel) {
+            buf += "🎉 LEVEL UP! Sekarang level " + to_string(ev.level) + "! Dapet " +
+                   to_string(kebijakan().level[ev.level - 1].bonusKredit) + " kredit gratis!\n";
+        }
+    }
+
+    void tulis() {
+        out.write(buf.data(), buf.size());
+        out.flush();
+        buf.clear();
+    }
+
+public:
+    explicit SinkTeks(ostream& out, bool flushTiapEvent = false)
+        : out(out), flushTiapEvent(flushTiapEvent) {
+        buf.reserve(BATAS_BUFFER);
+    }
+
+    ~SinkTeks() override { flush(); }
+
+    void terima(const Event& ev) override {
+        lock_guard<mutex> lk(mtx);
+        format(ev);
+        if (flushTiapEvent || buf.size() >= BATAS_BUFFER) tulis();
+    }
+
+    void flush() override {
+        lock_guard<mutex> lk(mtx);
+        if (!buf.empty()) tulis();
+    }
+};
+
+// event mentah ke file biner, buat diolah program lain. per record:
+// [u8 jenis][u8 status][u8 flag][i32 hari][i32 level][i32 sisaKredit]
+// [f64 denda][str idMember][str idItem]  - flag: bit0 kredit, bit1 naik level, bit2 rusak
+class SinkBiner : public EventSink {
+private:
+    FILE* f;
+    const bool dibuka;
+    mutex mtx;
+    PenulisBiner buf;
+    atomic<bool> gagal{false};  // ada fwrite/fflush yang ga utuh - event sesudahnya dibuang
+
+    static constexpr size_t BATAS_BUFFER = 1 << 16;
+
+    void tulis() {
+        if (f && !gagal.load() && fwrite(buf.data().data(), 1, buf.posisi(), f) != buf.posisi()) gagal = true;
+        buf.clear();
+    }
+
+public:
+    explicit SinkBiner(const string& path) : f(fopen(path.c_str(), "wb")), dibuka(f != nullptr) {}
+
+    ~SinkBiner() override { tutup(); }
+
+    SinkBiner(const SinkBiner&) = delete;
+    SinkBiner& operator=(const SinkBiner&) = delete;
+
+    bool valid() const { return f != nullptr; }
+
+    // false kalo file-nya gagal dibuka ato ada event yang ga ketulis utuh
+    bool ok() const { return dibuka && !gagal.load(); }
+
+    // flush + tutup file, false kalo ada yang ilang. aman dipanggil dua kali
+    bool tutup() {
+        flush();
+        lock_guard<mutex> lk(mtx);
+        if (f && fclose(f) != 0) gagal = true;
+        f = nullptr;
+        return ok();
+    }
+
+    void terima(const Event& ev) override {
+        lock_guard<mutex> lk(mtx);
+        buf.tulis<uint8_t>(ev.jenis);
+        buf.tulis<uint8_t>(static_cast<uint8_t>(ev.hasil.status));
+        buf.tulis<uint8_t>(ev.hasil.pakeKredit | (ev.hasil.naikLevel << 1) | (ev.rusak << 2));
+        buf.tulis<int32_t>(ev.hari);
+        buf.tulis<int32_t>(ev.level);
+        buf.tulis<int32_t>(ev.sisaKredit);
+        buf.tulis<double>(ev.hasil.denda);
+        buf.tulisString(ev.idMember);
+        buf.tulisString(ev.idItem);
+        if (buf.posisi() >= BATAS_BUFFER) tulis();
+    }
+
+    void flush() override {
+        lock_guard<mutex> lk(mtx);
+        tulis();
+        if (f && fflush(f) != 0) gagal = true;
+    }
+};
+
+// ===========================
+// KELAS MEMBER
+// ===========================
+class Member : public DialokasiArena {
+private:
+    Teks id;
+    Teks nama;
+    int level;
+    int kreditGratis;
+    int totalPinjaman;
+    int pinjamanSukses;
+
+public:
+    Member(string_view id, string_view nama) 
+        : id(id, alokatorTeks()), nama(nama, alokatorTeks()), level(0), kreditGratis(0), 
+          totalPinjaman(0), pinjamanSukses(0) {}
+
+    // getter buat ngecek status member - sama kaya Item, ga nyalin
+    string_view getId() const { return id; }
+    string_view getNama() const { return nama; }
+    int getLevel() const { return level; }
+    int getKreditGratis() const { return kreditGratis; }
+    int getTotalPinjaman() const { return totalPinjaman; }
+    int getPinjamanSukses() const { return pinjamanSukses; }
+
+    // method borrow yang basic - no kredit dipakai.
+    // ga ngeprint apa2, pesan buat user diurus event sink di Perpustakaan
+    HasilTransaksi pinjam(const Item& item, int hariDiminta) {
+        if (!item.isTersedia()) return HasilTransaksi::dari(StatusTransaksi::ITEM_DIPINJAM);
+        if (hariDiminta > item.batasHari()) return HasilTransaksi::dari(StatusTransaksi::HARI_KEBANYAKAN);
+        if (hariDiminta <= 0) return HasilTransaksi::dari(StatusTransaksi::HARI_TIDAK_VALID);
+        // bisa aja keduluan meja lain di antara cek di atas sama sini
+        if (!item.cobaAmbil()) return HasilTransaksi::dari(StatusTransaksi::ITEM_DIPINJAM);
+        totalPinjaman++;
+        return HasilTransaksi::dari(StatusTransaksi::SUKSES);
+    }
+
+    // OVERLOAD method borrow - bisa pake kredit gratis nih
+    HasilTransaksi pinjam(const Item& item, int hariDiminta, bool pakeKredit) {
+        if (pakeKredit && kreditGratis > 0) {
+            // pake kredit = bebas aturan max hari, tapi item tetep harus ada
+            HasilTransaksi hasil = HasilTransaksi::dari(StatusTransaksi::SUKSES);
+            hasil.pakeKredit = true;
+            if (!item.cobaAmbil()) {
+                hasil.status = StatusTransaksi::ITEM_DIPINJAM;  // kredit ga jadi kepake
+                return hasil;
+            }
+            kreditGratis--;
+            totalPinjaman++;
+            return hasil;
+        }
+        return pinjam(item, hariDiminta);
+    }
+
+    // method buat balikin item + hitung denda kalo telat
+    HasilTransaksi balikinItem(const Item& item, int hariAktual) {
+        Item::Balik balik = item.cobaBalikin();
+        if (balik == Item::Balik::GAGAL) return HasilTransaksi::dari(StatusTransaksi::ITEM_TIDAK_DIPINJAM);
+        pinjamanSukses++;
+
+        HasilTransaksi hasil = HasilTransaksi::dari(StatusTransaksi::SUKSES);
+        hasil.diteruskan = balik == Item::Balik::KE_ANTREAN;
+        hasil.denda = item.dendaKembali(hariAktual);
+
+        // cek upgrade level - ini logika level upnya
+        hasil.naikLevel = cekUpgradeLevel();
+        return hasil;
+    }
+
+    // method buat balikin DVD dengan opsi rusak - overload hitungDenda dipake disini.
+    // tipe-nya udah dicek pemanggil (BUKAN_DVD)
+    HasilTransaksi balikinDVD(const Item& dvd, int hariAktual, bool rusak) {
+        Item::Balik balik = dvd.cobaBalikin();
+        if (balik == Item::Balik::GAGAL) return HasilTransaksi::dari(StatusTransaksi::ITEM_TIDAK_DIPINJAM);
+        pinjamanSukses++;
+
+        HasilTransaksi hasil = HasilTransaksi::dari(StatusTransaksi::SUKSES);
+        hasil.diteruskan = balik == Item::Balik::KE_ANTREAN;
+        int hariTerlambat = hariAktual - dvd.batasHari();
+        if (hariTerlambat > 0 || rusak) {
+            // pake overload method - yang ada parameter rusak
+            hasil.denda = dvd.hitungDenda(max(0, hariTerlambat), rusak);
+        }
+
+        hasil.naikLevel = cekUpgradeLevel();
+        return hasil;
+    }
+
+    // giliran antrean reservasinya nyampe: eksemplarnya udah dijatahin
+    // (ga lewat rak), tinggal dicatat sebagai pinjaman
+    void terimaReservasi() { totalPinjaman++; }
+
+private:
+    // method internal buat naik level - system reward gitu.
+    // balikin true kalo barusan naik level
+    bool cekUpgradeLevel() {
+        // syarat & bonus tiap level dari tabel kebijakan. bawaannya:
+        // 0 -> 1 butuh 5 pinjaman sukses (+1 kredit), 1 -> 2 butuh 10 (+3 kredit - mantap).
+        // naiknya tetep maksimal satu level per balikin
+        if (level >= JUMLAH_LEVEL) return false;
+        const AturanLevel& aturan = kebijakan().level[level];
+        if (pinjamanSukses < aturan.syaratPinjaman) return false;
+        level++;
+        kreditGratis += aturan.bonusKredit;
+        return true;
+    }
+
+public:
+    // serialisasi - semua counter ikut disimpen biar level ga ilang
+    void tulisKe(PenulisBiner& out) const {
+        out.tulisString(id);
+        out.tulisString(nama);
+        out.tulis<int32_t>(level);
+        out.tulis<int32_t>(kreditGratis);
+        out.tulis<int32_t>(totalPinjaman);
+        out.tulis<int32_t>(pinjamanSukses);
+    }
+
+    static unique_ptr<Member> bacaDari(PembacaBiner& in) {
+        string_view id = in.bacaString();
+        string_view nama = in.bacaString();
+        auto member = make_unique<Member>(id, nama);
+        member->level = in.baca<int32_t>();
+        member->kreditGratis = in.baca<int32_t>();
+        member->totalPinjaman = in.baca<int32_t>();
+        member->pinjamanSukses = in.baca<int32_t>();
+        if (!in.isOk()) return nullptr;
+        return member;
+    }
+
+    void tulisInfo(string& out) const {
+        out += "\n👤 Member Info:\nID: ";
+        out += id;
+        out += " | Nama: ";
+        out += nama;
+        out += "\nLevel: " + to_string(level) + " | Kredit Gratis: " + to_string(kreditGratis);
+        out += "\nTotal Pinjaman: " + to_string(totalPinjaman) + " | Sukses: " + to_string(pinjamanSukses) + "\n";
+    }
+
+    void tampilInfo() const {
+        string s;
+        tulisInfo(s);
+        cout << s << flush;
+    }
+};
+
+// ===========================
+// INDEKS HASH (OPEN ADDRESSING)
+// ===========================
+// FNV-1a 64 bit - simpel tapi nyebarnya oke buat ID / kata pendek
+inline uint64_t hashTeks(string_view s) {
+    uint64_t h = 1469598103934665603ULL;
+    for (unsigned char c : s) {
+        h ^= c;
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+// kunci ID buat IndeksHash (lihat di bawah)
+inline uint64_t kunciId(string_view s) {
+    if (s.size() > 7) return hashTeks(s) | (uint64_t(0xFF) << 56);
+    uint64_t k = uint64_t(s.size()) << 56;
+    for (size_t i = 0; i < s.size(); i++) k |= uint64_t(static_cast<unsigned char>(s[i])) << (8 * i);
+    return k;
+}
+
+inline bool kunciPadat(uint64_t k) { return (k >> 56) <= 7; }
+
+// map ID -> slot pake linear probing, jadi cari ID ga perlu scan satu2 lagi.
+// slot = handle 32 bit yang padet (0..n-1, ga pernah pindah), semua struktur
+// di belakang (kolom, pinjaman aktif, antrean, riwayat) udah pake slot ini -
+// string ID cuma di-resolve sekali di pintu masuk lewat sini.
+// tiap entri nyimpen slot + kunci 64 bit:
+// - ID pendek (<= 7 byte, "B001", "MEM001") dipadetin utuh ke kunci, byte
+//   paling atas = panjangnya. kunci sama = ID sama, ga usah buka objeknya
+// - ID panjang: kunci = hash dengan byte atas 0xFF, jadi ga mungkin bentrok
+//   sama yang dipadetin. kalo kuncinya cocok baru string-nya dibandingin
+//   lewat `sumber` - hemat memori cuy, teks ID tetep cuma ada di sumbernya
+//   (kolom katalog buat item, objek Member buat member)
+template <typename T>
+struct SumberId {
+    using Tipe = vector<T*>;
+    static string_view id(const Tipe& sumber, uint32_t slot) { return sumber[slot]->getId(); }
+};
+
+template <>
+struct SumberId<Item> {
+    using Tipe = KatalogKolom;
+    static string_view id(const KatalogKolom& kolom, uint32_t slot) { return kolom.getId(slot); }
+};
+
+template <typename T>
+class IndeksHash {
+public:
+    static constexpr uint32_t KOSONG = 0xFFFFFFFFu;
+
+private:
+    using Sumber = typename SumberId<T>::Tipe;
+    const Sumber& sumber;       // slot -> ID, urutannya ga pernah berubah
+    vector<uint32_t> tabel;     // isinya slot, KOSONG kalo belum kepake
+    vector<uint64_t> kunci;     // kunciId per entri - rehash ga perlu buka objek
+    size_t jumlah;
+
+    // kunci padet belum teracak (byte2 awalnya mirip semua), jadi diaduk dulu
+    static size_t posisi(uint64_t k) {
+        k *= 0x9E3779B97F4A7C15ULL;
+        return static_cast<size_t>(k ^ (k >> 29));
+    }
+
+    void pasang(uint32_t slot, uint64_t k) {
+        size_t mask = tabel.size() - 1;
+        size_t pos = posisi(k) & mask;
+        while (tabel[pos] != KOSONG) pos = (pos + 1) & mask;
+        tabel[pos] = slot;
+        kunci[pos] = k;
+    }
+
+    void rehash(size_t kapasitasBaru) {
+        vector<uint32_t> tabelLama(kapasitasBaru, KOSONG);
+        vector<uint64_t> kunciLama(kapasitasBaru, 0);
+        tabel.swap(tabelLama);
+        kunci.swap(kunciLama);
+        for (size_t i = 0; i < tabelLama.size(); i++) {
+            if (tabelLama[i] != KOSONG) pasang(tabelLama[i], kunciLama[i]);
+        }
+    }
+
+    uint32_t cariKunci(uint64_t k, string_view id) const {
+        size_t mask = tabel.size() - 1;
+        bool padat = kunciPadat(k);
+        for (size_t pos = posisi(k) & mask; tabel[pos] != KOSONG; pos = (pos + 1) & mask) {
+            if (kunci[pos] == k && (padat || SumberId<T>::id(sumber, tabel[pos]) == id)) return tabel[pos];
+        }
+        return KOSONG;
+    }
+
+public:
+    explicit IndeksHash(const Sumber& sumber)
+        : sumber(sumber), tabel(16, KOSONG), kunci(16, 0), jumlah(0) {}
+
+    // siapin kapasitas di depan biar bulk load ga rehash berkali2
+    void reserve(size_t n) {
+        size_t kap = tabel.size();
+        while (kap < n * 2) kap <<= 1;
+        if (kap != tabel.size()) rehash(kap);
+    }
+
+    uint32_t cari(string_view id) const { return cariKunci(kunciId(id), id); }
+
+    // daftarin slot baru (slot harus == jumlah entri sebelumnya).
+    // balikin false kalo ID-nya udah ada - cek duplikat sekalian, O(1)
+    bool tambah(uint32_t slot) {
+        string_view id = SumberId<T>::id(sumber, slot);
+        uint64_t k = kunciId(id);
+        if (cariKunci(k, id) != KOSONG) return false;
+        jumlah++;
+        if (jumlah * 2 > tabel.size()) rehash(tabel.size() * 2);
+        pasang(slot, k);
+        return true;
+    }
+
+    void clear() {
+        tabel.assign(16, KOSONG);
+        kunci.assign(16, 0);
+        jumlah = 0;
+    }
+
+    size_t size() const { return jumlah; }
+};
+
+// ===========================
+// INDEKS PENCARIAN TEKS
+// ===========================
+// cari item lewat kata di judul + penulis (Book) / sutradara (DVD).
+// - inverted index: kata -> daftar slot (posting). slot selalu naik
+//   (slot = urutan masuk), jadi disimpen delta varint, per BLOK entri ada
+//   titik lompat biar irisan antar kata bisa loncat
+// - kamus kata terurut buat query awalan ("pemro" -> pemrograman, ...)
+// - filter tersedia langsung baca bitset KatalogKolom, yang udah ikut
+//   ke-update tiap pinjam/balik - jadi indeks ini cuma nambah pas tambahItem
+
+// pecah teks jadi kata huruf kecil. pemisahnya semua ASCII non-alfanumerik,
+// byte >= 0x80 (UTF-8) dianggap bagian kata biar ga kepotong
+template <typename F>
+void pecahKata(string_view teks, F&& f) {
+    char buf[64];
+    size_t n = 0;
+    bool kepanjangan = false;
+    auto kirimKata = [&] {
+        if (n > 0 && !kepanjangan) f(string_view(buf, n));
+        n = 0;
+        kepanjangan = false;
+    };
+    for (char c : teks) {
+        unsigned char u = static_cast<unsigned char>(c);
+        bool hurufKata = (u >= '0' && u <= '9') || (u >= 'a' && u <= 'z') || (u >= 'A' && u <= 'Z') || u >= 0x80;
+        if (!hurufKata) {
+            kirimKata();
+            continue;
+        }
+        if (n == sizeof(buf)) kepanjangan = true;  // kata > 64 byte di-skip aja, ga ada yang nyari begituan
+        else buf[n++] = (u >= 'A' && u <= 'Z') ? static_cast<char>(u + 32) : c;
+    }
+    kirimKata();
+}
+
+class IndeksCari {
+public:
+    static constexpr uint32_t KOSONG = 0xFFFFFFFFu;
+
+    struct Opsi {
+        bool hanyaTersedia = false;  // cuma item yang lagi ada di rak
+        bool awalan = true;          // kata terakhir dianggap awalan (ketik sambil nyari)
+        size_t maks = 20;
+    };
+
+private:
+    static constexpr uint32_t BLOK = 128;
+
+    struct Lompatan {
+        uint32_t slot;  // slot pertama di blok
+        uint32_t off;   // offset byte-nya di data
+    };
+
+    struct Posting {
+        vector<uint8_t> data;
+        vector<Lompatan> lompat;  // awal blok ke-1, ke-2, dst. blok 0 mulai dari off 0
+        uint32_t jumlah = 0;
+        uint32_t terakhir = 0;
+
+        // entri pertama tiap blok ditulis utuh, sisanya selisih sama sebelumnya
+        void tambah(uint32_t slot) {
+            if (jumlah > 0 && slot == terakhir) return;  // kata dobel di item yang sama
+            uint32_t nilai = slot - terakhir;
+            if (jumlah % BLOK == 0) {
+                if (jumlah > 0) lompat.push_back({slot, static_cast<uint32_t>(data.size())});
+                nilai = slot;
+            }
+            while (nilai >= 0x80) {
+                data.push_back(static_cast<uint8_t>(nilai | 0x80));
+                nilai >>= 7;
+            }
+            data.push_back(static_cast<uint8_t>(nilai));
+            terakhir = slot;
+            jumlah++;
+        }
+    };
+
+    // baca satu posting list berurutan, bisa loncat ke slot >= target
+    class Kursor {
+        const Posting* p;
+        uint32_t idx;
+        uint32_t off;
+        uint32_t nilai;
+
+        uint32_t bacaVarint() {
+            uint32_t v = 0;
+            for (int geser = 0;; geser += 7) {
+                uint8_t b = p->data[off++];
+                v |= uint32_t(b & 0x7F) << geser;
+                if (!(b & 0x80)) return v;
+            }
+        }
+
+    public:
+        explicit Kursor(const Posting& p) : p(&p), idx(0), off(0), nilai(0) { nilai = bacaVarint(); }
+
+        bool habis() const { return idx >= p->jumlah; }
+        uint32_t sekarang() const { return nilai; }
+        uint32_t jumlah() const { return p->jumlah; }
+
+        void maju() {
+            if (++idx >= p->jumlah) return;
+            uint32_t v = bacaVarint();
+            nilai = idx % BLOK == 0 ? v : nilai + v;
+        }
+
+        void majuKe(uint32_t target) {
+            if (habis() || nilai >= target) return;
+            // lompat[b] = awal blok b+1. kalo blok berikutnya masih <= target,
+            // langsung loncat ke blok terakhir yang awalnya <= target
+            size_t b = idx / BLOK;
+            if (b < p->lompat.size() && p->lompat[b].slot <= target) {
+                auto it = upper_bound(p->lompat.begin() + b, p->lompat.end(), target,
+                                      [](uint32_t t, const Lompatan& l) { return t < l.slot; });
+                size_t blok = it - p->lompat.begin();
+                idx = static_cast<uint32_t>(blok * BLOK);
+                off = p->lompat[blok - 1].off;
+                nilai = bacaVarint();
+            }
+            while (!habis() && nilai < target) maju();
+        }
+    };
+
+    // gabungan beberapa posting (semua kata dengan awalan yang sama) - min-heap kursor
+    class KursorGabungan {
+        vector<Kursor> isi;
+        size_t perkiraan = 0;
+
+        static bool lebihBesar(const Kursor& a, const Kursor& b) { return a.sekarang() > b.sekarang(); }
+
+    public:
+        void tambah(const Posting& p) {
+            isi.emplace_back(p);
+            perkiraan += p.jumlah;
+        }
+        void siap() { make_heap(isi.begin(), isi.end(), lebihBesar); }
+
+        bool habis() const { return isi.empty(); }
+        uint32_t sekarang() const { return isi.front().sekarang(); }
+        size_t perkiraanJumlah() const { return perkiraan; }
+
+        void majuKe(uint32_t target) {
+            while (!isi.empty() && isi.front().sekarang() < target) {
+                pop_heap(isi.begin(), isi.end(), lebihBesar);
+                isi.back().majuKe(target);
+                if (isi.back().habis()) isi.pop_back();
+                else push_heap(isi.begin(), isi.end(), lebihBesar);
+            }
+        }
+
+        // slot yang sama dari kata lain ikut kelewat, jadi hasilnya ga dobel
+        void maju() { majuKe(sekarang() + 1); }
+    };
+
+    // kamus kata: open addressing kaya IndeksHash, teks kata numpuk di satu arena
+    string teks;
+    vector<RefTeks> kata;
+    vector<Posting> posting;  // diindeks nomor kata
+    vector<uint32_t> tabel;
+    vector<uint32_t> sidikJari;
+
+    // nomor kata urut alfabet buat query awalan. kata baru numpuk di `baru`,
+    // digabung pas query awalan berikutnya (query jalan barengan di bawah
+    // shared lock, makanya pake mutex sendiri)
+    mutable vector<uint32_t> urut;
+    mutable vector<uint32_t> baru;
+    mutable atomic<bool> perluGabung{false};
+    mutable mutex mtxUrut;
+
+    string_view teksKata(uint32_t k) const { return string_view(teks.data() + kata[k].off, kata[k].len); }
+
+    void pasang(uint32_t k, uint64_t h) {
+        size_t mask = tabel.size() - 1;
+        size_t pos = h & mask;
+        while (tabel[pos] != KOSONG) pos = (pos + 1) & mask;
+        tabel[pos] = k;
+        sidikJari[pos] = static_cast<uint32_t>(h >> 32);
+    }
+
+    uint32_t nomorKata(string_view s) const {
+        uint64_t h = hashTeks(s);
+        uint32_t fp = static_cast<uint32_t>(h >> 32);
+        size_t mask = tabel.size() - 1;
+        for (size_t pos = h & mask; tabel[pos] != KOSONG; pos = (pos + 1) & mask) {
+            if (sidikJari[pos] == fp && teksKata(tabel[pos]) == s) return tabel[pos];
+        }
+        return KOSONG;
+    }
+
+    uint32_t nomorAtauBaru(string_view s) {
+        uint32_t k = nomorKata(s);
+        if (k != KOSONG) return k;
+        k = static_cast<uint32_t>(kata.size());
+        kata.push_back({static_cast<uint32_t>(teks.size()), static_cast<uint32_t>(s.size())});
+        teks.append(s.data(), s.size());
+        posting.emplace_back();
+        if (kata.size() * 2 > tabel.size()) {
+            tabel.assign(tabel.size() * 2, KOSONG);
+            sidikJari.assign(tabel.size(), 0);
+            for (uint32_t i = 0; i < kata.size(); i++) pasang(i, hashTeks(teksKata(i)));
+        } else {
+            pasang(k, hashTeks(s));
+        }
+        baru.push_back(k);
+        perluGabung.store(true, memory_order_release);
+        return k;
+    }
+
+    void rapikanUrut() const {
+        if (!perluGabung.load(memory_order_acquire)) return;
+        lock_guard<mutex> lk(mtxUrut);
+        if (!perluGabung.load(memory_order_relaxed)) return;
+        auto lebihKecil = [this](uint32_t a, uint32_t b) { return teksKata(a) < teksKata(b); };
+        sort(baru.begin(), baru.end(), lebihKecil);
+        size_t tengah = urut.size();
+        urut.insert(urut.end(), baru.begin(), baru.end());
+        inplace_merge(urut.begin(), urut.begin() + tengah, urut.end(), lebihKecil);
+        baru.clear();
+        perluGabung.store(false, memory_order_release);
+    }
+
+public:
+    IndeksCari() : tabel(16, KOSONG), sidikJari(16, 0) {}
+
+    // masukin kata2 slot baru. slot harus naik terus (urutan tambahItem)
+    void tambah(uint32_t slot, const KatalogKolom& kolom) {
+        auto masuk = [&](string_view s) { posting[nomorAtauBaru(s)].tambah(slot); };
+        pecahKata(kolom.getJudul(slot), masuk);
+        uint8_t tag = kolom.getTag(slot);
+        if (tag == Book::KODE || tag == DVD::KODE) pecahKata(kolom.getDetail(slot), masuk);
+    }
+
+    void clear() {
+        teks.clear();
+        kata.clear();
+        posting.clear();
+        tabel.assign(16, KOSONG);
+        sidikJari.assign(16, 0);
+        urut.clear();
+        baru.clear();
+        perluGabung = false;
+    }
+
+    // slot yang semua kata query-nya ada (AND), urut slot, maks opsi.maks.
+    // kata terakhir boleh awalan. irisannya leapfrog: kursor yang paling
+    // jarang jalan duluan, yang lain loncat ke slot kandidat
+    vector<uint32_t> cari(string_view query, const KatalogKolom& kolom, const Opsi& opsi) const {
+        vector<string> kataQuery;
+        pecahKata(query, [&](string_view s) { kataQuery.emplace_back(s); });
+        vector<uint32_t> hasil;
+        if (kataQuery.empty() || opsi.maks == 0) return hasil;
+
+        vector<KursorGabungan> kursor(kataQuery.size());
+        for (size_t i = 0; i < kataQuery.size(); i++) {
+            const string& q = kataQuery[i];
+            if (i + 1 == kataQuery.size() && opsi.awalan) {
+                rapikanUrut();
+                auto it = lower_bound(urut.begin(), urut.end(), q,
+                                      [this](uint32_t k, const string& s) { return teksKata(k) < s; });
+                for (; it != urut.end() && teksKata(*it).substr(0, q.size()) == q; ++it) {
+                    kursor[i].tambah(posting[*it]);
+                }
+            } else {
+                uint32_t k = nomorKata(q);
+                if (k != KOSONG) kursor[i].tambah(posting[k]);
+            }
+            if (kursor[i].habis()) return hasil;
+            kursor[i].siap();
+        }
+        sort(kursor.begin(), kursor.end(), [](const KursorGabungan& a, const KursorGabungan& b) {
+            return a.perkiraanJumlah() < b.perkiraanJumlah();
+        });
+
+        uint32_t kandidat = kursor[0].sekarang();
+        while (true) {
+            bool cocok = true;
+            for (KursorGabungan& k : kursor) {
+                k.majuKe(kandidat);
+                if (k.habis()) return hasil;
+                if (k.sekarang() != kandidat) {
+                    kandidat = k.sekarang();
+                    cocok = false;
+                    break;
+                }
+            }
+            if (!cocok) continue;
+            if (!opsi.hanyaTersedia || kolom.isTersedia(kandidat)) {
+                hasil.push_back(kandidat);
+                if (hasil.size() == opsi.maks) return hasil;
+            }
+            kursor[0].maju();
+            if (kursor[0].habis()) return hasil;
+            kandidat = kursor[0].sekarang();
+        }
+    }
+
+    size_t jumlahKata() const { return kata.size(); }
+
+    size_t ukuranMemori() const {
+        size_t total = teks.capacity() + kata.capacity() * sizeof(RefTeks) + posting.capacity() * sizeof(Posting) +
+                       (tabel.capacity() + sidikJari.capacity() + urut.capacity() + baru.capacity()) * sizeof(uint32_t);
+        for (const Posting& p : posting) total += p.data.capacity() + p.lompat.capacity() * sizeof(Lompatan);
+        return total;
+    }
+};
+
+// ===========================
+// INDEKS TERURUT (ID / JUDUL / TIPE)
+// ===========================
+// urutan slot yang selalu kejaga pas tambahItem, jadi katalog ga perlu
+// di-sort ulang. bentuknya B+-tree berhitung: daun = blok terurut maks
+// MAKS_BLOK entri (disambung berurutan lewat `berikut`), simpul dalem maks
+// MAKS_ANAK anak, tiap anak dicatet entri terakhirnya + jumlah entri di
+// bawahnya. tambah = turun dari akar (binary search per simpul) + geser
+// <= MAKS_BLOK entri di daun; yang penuh dibelah dua, belahannya naik ke
+// induk - semuanya O(log n), ga ada yang geser sepanjang katalog.
+// posisiKe (lompat ke halaman ke-k) turun lewat jumlah per anak, juga O(log n).
+// tiap entri bawa 8 byte awal kuncinya (big-endian), jadi kebanyakan
+// perbandingan ga perlu baca teks di arena kolom.
+// ketersediaan ga diindeks terpisah (berubah tiap pinjam/balik) -
+// iterasinya difilter pake bitset kolom
+enum class UrutKatalog : uint8_t { MASUK, ID, JUDUL, TIPE };
+
+// tiap pembanding harus total: kalo kunci utamanya sama, ID yang nentuin.
+// awalan(a) < awalan(b) harus berarti a sebelum b. ID dibandingin lewat
+// kunci ID di kolom (idSebelum), string cuma dibuka kalo kuncinya seri
+struct BandingId {
+    static uint64_t awalan(const KatalogKolom& k, uint32_t s) { return k.getKunciId(s); }
+    bool operator()(const KatalogKolom& k, uint32_t a, uint32_t b) const { return k.idSebelum(a, b); }
+};
+
+struct BandingJudul {
+    static uint64_t awalan(const KatalogKolom& k, uint32_t s) { return awalanTeks(k.getJudul(s)); }
+    bool operator()(const KatalogKolom& k, uint32_t a, uint32_t b) const {
+        int c = k.getJudul(a).compare(k.getJudul(b));
+        return c != 0 ? c < 0 : k.idSebelum(a, b);
+    }
+};
+
+struct BandingTipe {
+    static uint64_t awalan(const KatalogKolom& k, uint32_t s) {
+        return (uint64_t(k.getTag(s)) << 56) | (k.getKunciId(s) >> 8);
+    }
+    bool operator()(const KatalogKolom& k, uint32_t a, uint32_t b) const {
+        uint8_t ta = k.getTag(a), tb = k.getTag(b);
+        return ta != tb ? ta < tb : k.idSebelum(a, b);
+    }
+};
+
+template <typename Banding>
+class IndeksUrut {
+public:
+    static constexpr size_t MAKS_BLOK = 256;
+    static constexpr size_t MAKS_ANAK = 64;
+
+    // blok = nomor daun (KOSONG = udah lewat ujung), idx = urutan di daun itu
+    struct Posisi {
+        size_t blok;
+        size_t idx;
+    };
+
+private:
+    static constexpr uint32_t KOSONG = UINT32_MAX;
+    static constexpr size_t MAKS_TINGGI = 16;  // 32^16 entri, ga bakal kesampean
+
+    struct Entri {
+        uint64_t awalan;
+        uint32_t slot;
+    };
+
+    struct Dalem {
+        vector<uint32_t> anak;  // nomor daun kalo anakDaun, kalo ga nomor simpul dalem
+        vector<Entri> batas;    // entri terakhir tiap anak
+        vector<size_t> hitung;  // jumlah entri di bawah tiap anak
+        bool anakDaun;
+    };
+
+    const KatalogKolom& kolom;
+    Banding banding;
+    vector<vector<Entri>> blok;  // daun
+    vector<uint32_t> berikut;    // daun sesudahnya dalam urutan, KOSONG = terakhir
+    vector<Dalem> dalem;
+    uint32_t akar;               // simpul dalem, KOSONG kalo indeksnya kosong
+    uint32_t daunPertama;
+    size_t jumlah;
+
+    bool sebelum(const Entri& a, const Entri& b) const {
+        if (a.awalan != b.awalan) return a.awalan < b.awalan;
+        return banding(kolom, a.slot, b.slot);
+    }
+
+    Entri entri(uint32_t slot) const { return {Banding::awalan(kolom, slot), slot}; }
+
+    Entri batasAnak(bool daun, uint32_t x) const { return daun ? blok[x].back() : dalem[x].batas.back(); }
+
+    size_t hitungAnak(bool daun, uint32_t x) const {
+        if (daun) return blok[x].size();
+        size_t total = 0;
+        for (size_t h : dalem[x].hitung) total += h;
+        return total;
+    }
+
+    // simpul dalem baru di atas anak2 [dari, sampai) - dipake bangun + akar baru
+    uint32_t dalemBaru(bool anakDaun, const uint32_t* dari, const uint32_t* sampai) {
+        Dalem d;
+        d.anakDaun = anakDaun;
+        d.anak.reserve(MAKS_ANAK + 1);
+        d.batas.reserve(MAKS_ANAK + 1);
+        d.hitung.reserve(MAKS_ANAK + 1);
+        for (const uint32_t* x = dari; x != sampai; x++) {
+            d.anak.push_back(*x);
+            d.batas.push_back(batasAnak(anakDaun, *x));
+            d.hitung.push_back(hitungAnak(anakDaun, *x));
+        }
+        dalem.push_back(move(d));
+        return static_cast<uint32_t>(dalem.size() - 1);
+    }
+
+    // belah daun `b` yang kepenuhan, balikin nomor daun belakangnya
+    uint32_t belahDaun(uint32_t b) {
+        size_t tengah = blok[b].size() / 2;
+        vector<Entri> belakang;
+        belakang.reserve(MAKS_BLOK + 1);
+        belakang.assign(blok[b].begin() + tengah, blok[b].end());
+        blok[b].resize(tengah);
+        uint32_t nb = static_cast<uint32_t>(blok.size());
+        blok.push_back(move(belakang));
+        berikut.push_back(berikut[b]);
+        berikut[b] = nb;
+        return nb;
+    }
+
+    // belah simpul dalem `d` yang kepenuhan, balikin nomor simpul belakangnya
+    uint32_t belahDalem(uint32_t d) {
+        size_t tengah = dalem[d].anak.size() / 2;
+        Dalem belakang;
+        belakang.anakDaun = dalem[d].anakDaun;
+        belakang.anak.reserve(MAKS_ANAK + 1);
+        belakang.batas.reserve(MAKS_ANAK + 1);
+        belakang.hitung.reserve(MAKS_ANAK + 1);
+        Dalem& n = dalem[d];
+        belakang.anak.assign(n.anak.begin() + tengah, n.anak.end());
+        belakang.batas.assign(n.batas.begin() + tengah, n.batas.end());
+        belakang.hitung.assign(n.hitung.begin() + tengah, n.hitung.end());
+        n.anak.resize(tengah);
+        n.batas.resize(tengah);
+        n.hitung.resize(tengah);
+        dalem.push_back(move(belakang));
+        return static_cast<uint32_t>(dalem.size() - 1);
+    }
+
+public:
+    explicit IndeksUrut(const KatalogKolom& kolom) : kolom(kolom), akar(KOSONG), daunPertama(KOSONG), jumlah(0) {}
+
+    void tambah(uint32_t slot) {
+        Entri e = entri(slot);
+        jumlah++;
+        if (akar == KOSONG) {
+            blok.emplace_back();
+            blok.back().reserve(MAKS_BLOK + 1);
+            blok.back().push_back(e);
+            berikut.push_back(KOSONG);
+            daunPertama = 0;
+            akar = dalemBaru(true, &daunPertama, &daunPertama + 1);
+            return;
+        }
+
+        // turun ke daun: tiap tingkat anak pertama yang entri terakhirnya ga
+        // sebelum e (kalo ga ada, anak terakhir), hitungnya langsung ditambah
+        uint32_t jalur[MAKS_TINGGI];
+        size_t pilih[MAKS_TINGGI];
+        size_t tinggi = 0;
+        for (uint32_t d = akar;;) {
+            Dalem& n = dalem[d];
+            size_t i = partition_point(n.batas.begin(), n.batas.end(), [&](const Entri& x) { return sebelum(x, e); }) -
+                       n.batas.begin();
+            if (i == n.anak.size()) i--;
+            n.hitung[i]++;
+            jalur[tinggi] = d;
+            pilih[tinggi++] = i;
+            if (n.anakDaun) break;
+            d = n.anak[i];
+        }
+
+        uint32_t b = dalem[jalur[tinggi - 1]].anak[pilih[tinggi - 1]];
+        vector<Entri>& v = blok[b];
+        v.insert(upper_bound(v.begin(), v.end(), e, [&](const Entri& x, const Entri& y) { return sebelum(x, y); }), e);
+        uint32_t baru = v.size() > MAKS_BLOK ? belahDaun(b) : KOSONG;
+
+        // naik lagi: batas anak yang dilewatin diperbarui, belahan (kalo ada)
+        // disisipin di sebelah anaknya, induk yang jadi kepenuhan ikut dibelah
+        for (size_t t = tinggi; t-- > 0;) {
+            uint32_t d = jalur[t];
+            size_t i = pilih[t];
+            bool daun = dalem[d].anakDaun;
+            dalem[d].batas[i] = batasAnak(daun, dalem[d].anak[i]);
+            if (baru == KOSONG) continue;
+            Dalem& n = dalem[d];
+            n.hitung[i] = hitungAnak(daun, n.anak[i]);
+            n.anak.insert(n.anak.begin() + i + 1, baru);
+            n.batas.insert(n.batas.begin() + i + 1, batasAnak(daun, baru));
+            n.hitung.insert(n.hitung.begin() + i + 1, hitungAnak(daun, baru));
+            baru = n.anak.size() > MAKS_ANAK ? belahDalem(d) : KOSONG;
+        }
+        if (baru != KOSONG) {
+            uint32_t dua[2] = {akar, baru};
+            akar = dalemBaru(false, dua, dua + 2);
+        }
+    }
+
+    // bulk load: masukin semua slot sekaligus terus sort sekali, O(n log n).
+    // ambil awalan, sort, sama motong daun semuanya dibagi ke `kolam`.
+    // daun + simpul dalem diisi setengah biar tambah sesudahnya ga langsung belah
+    void bangun(uint32_t nSlot, KolamParalel& kolam = kolamParalel()) {
+        vector<Entri> semua(nSlot);
+        kolam.untukRentang(nSlot, 1 << 14, [&](size_t a, size_t b) {
+            for (size_t s = a; s < b; s++) semua[s] = entri(static_cast<uint32_t>(s));
+        });
+        kolam.urutkan(semua, [&](const Entri& x, const Entri& y) { return sebelum(x, y); });
+        clear();
+        if (semua.empty()) return;
+        constexpr size_t ISI = MAKS_BLOK / 2;
+        size_t nBlok = (semua.size() + ISI - 1) / ISI;
+        blok.resize(nBlok);
+        kolam.untukRentang(nBlok, 256, [&](size_t a, size_t b) {
+            for (size_t i = a; i < b; i++) {
+                blok[i].reserve(MAKS_BLOK + 1);
+                blok[i].assign(semua.begin() + i * ISI, semua.begin() + min(semua.size(), (i + 1) * ISI));
+            }
+        });
+        berikut.resize(nBlok);
+        for (size_t i = 0; i < nBlok; i++) berikut[i] = i + 1 < nBlok ? static_cast<uint32_t>(i + 1) : KOSONG;
+        daunPertama = 0;
+        jumlah = nSlot;
+
+        // tingkat dalem dibangun dari bawah sampe tinggal satu simpul
+        vector<uint32_t> tingkat(nBlok);
+        for (size_t i = 0; i < nBlok; i++) tingkat[i] = static_cast<uint32_t>(i);
+        bool anakDaun = true;
+        do {
+            vector<uint32_t> atas;
+            for (size_t i = 0; i < tingkat.size(); i += MAKS_ANAK / 2) {
+                atas.push_back(dalemBaru(anakDaun, tingkat.data() + i,
+                                         tingkat.data() + min(tingkat.size(), i + MAKS_ANAK / 2)));
+            }
+            tingkat = move(atas);
+            anakDaun = false;
+        } while (tingkat.size() > 1);
+        akar = tingkat[0];
+    }
+
+    void clear() {
+        blok.clear();
+        berikut.clear();
+        dalem.clear();
+        akar = daunPertama = KOSONG;
+        jumlah = 0;
+    }
+
+    size_t size() const { return jumlah; }
+
+    Posisi awal() const { return {daunPertama, 0}; }
+
+    // posisi entri ke-`ke` (0-based) - turun dari akar lewat jumlah per anak
+    Posisi posisiKe(size_t ke) const {
+        if (ke >= jumlah) return {KOSONG, 0};
+        for (uint32_t d = akar;;) {
+            const Dalem& n = dalem[d];
+            size_t i = 0;
+            while (ke >= n.hitung[i]) ke -= n.hitung[i++];
+            if (n.anakDaun) return {n.anak[i], ke};
+            d = n.anak[i];
+        }
+    }
+
+    // posisi pertama yang `sebelumKunci(slot)`-nya false (kaya lower_bound)
+    template <typename F>
+    Posisi cariPertama(F&& sebelumKunci) const {
+        if (akar == KOSONG) return {KOSONG, 0};
+        auto lewat = [&](const Entri& x) { return sebelumKunci(x.slot); };
+        for (uint32_t d = akar;;) {
+            const Dalem& n = dalem[d];
+            size_t i = partition_point(n.batas.begin(), n.batas.end(), lewat) - n.batas.begin();
+            if (i == n.anak.size()) return {KOSONG, 0};
+            if (n.anakDaun) {
+                const vector<Entri>& v = blok[n.anak[i]];
+                return {n.anak[i], static_cast<size_t>(partition_point(v.begin(), v.end(), lewat) - v.begin())};
+            }
+            d = n.anak[i];
+        }
+    }
+
+    // posisi tepat setelah `slot` - buat nerusin halaman dari kursor
+    Posisi setelah(uint32_t slot) const {
+        return cariPertama([&](uint32_t s) { return !banding(kolom, slot, s); });
+    }
+
+    // jalan urut dari `mulai`, berhenti kalo f(slot) balikin false
+    template <typename F>
+    void jelajah(Posisi mulai, F&& f) const {
+        size_t i = mulai.idx;
+        for (size_t b = mulai.blok; b != KOSONG; b = berikut[b], i = 0) {
+            const vector<Entri>& v = blok[b];
+            for (; i < v.size(); i++) {
+                if (!f(v[i].slot)) return;
+            }
+        }
+    }
+
+    size_t ukuranMemori() const {
+        size_t total = blok.capacity() * sizeof(vector<Entri>) + berikut.capacity() * sizeof(uint32_t) +
+                       dalem.capacity() * sizeof(Dalem);
+        for (const auto& v : blok) total += v.capacity() * sizeof(Entri);
+        for (const Dalem& d : dalem) {
+            total += d.anak.capacity() * sizeof(uint32_t) + d.batas.capacity() * sizeof(Entri) +
+                     d.hitung.capacity() * sizeof(size_t);
+        }
+        return total;
+    }
+};
+
+// ===========================
+// KELUARAN STREAMING (LISTING & EKSPOR)
+// ===========================
+// listing gede ditumpuk di satu buffer (default 1 MB) yang dipake ulang,
+// baru ditulis sekali pas penuh - bukan flush tiap baris kaya endl.
+// teks / CSV / JSON Lines lewat jalur yang sama
+enum class FormatListing : uint8_t { TEKS, CSV, JSONL };
+
+class BufferKeluaran {
+private:
+    FILE* f;
+    string buf;
+    size_t batas;
+    size_t total;
+    bool gagal;  // ada fwrite/fflush yang ga utuh (disk penuh dll)
+
+public:
+    explicit BufferKeluaran(FILE* f, size_t batas = 1 << 20) : f(f), batas(batas), total(0), gagal(false) {
+        buf.reserve(batas + 4096);
+    }
+
+    ~BufferKeluaran() { flush(); }
+
+    BufferKeluaran(const BufferKeluaran&) = delete;
+    BufferKeluaran& operator=(const BufferKeluaran&) = delete;
+
+    // akses langsung buat formatter yang nulis ke string (Item::tulisInfo dll)
+    string& isi() { return buf; }
+
+    void tambah(string_view s) { buf.append(s.data(), s.size()); }
+    void tambah(char c) { buf += c; }
+
+    void angka(int64_t v) {
+        char tmp[24];
+        auto r = to_chars(tmp, tmp + sizeof(tmp), v);
+        buf.append(tmp, r.ptr);
+    }
+
+    // field CSV - dikutip kalo ada koma/kutip/newline (RFC 4180)
+    void csv(string_view s) {
+        bool perluKutip = false;
+        for (char c : s) perluKutip |= c == ',' || c == '"' || c == '\r' || c == '\n';
+        if (!perluKutip) {
+            tambah(s);
+            return;
+        }
+        buf += '"';
+        for (char c : s) {
+            if (c == '"') buf += '"';
+            buf += c;
+        }
+        buf += '"';
+    }
+
+    // string JSON lengkap sama kutipnya
+    void json(string_view s) {
+        buf += '"';
+        for (char c : s) {
+            unsigned char u = static_cast<unsigned char>(c);
+            if (c == '"' || c == '\\') {
+                buf += '\\';
+                buf += c;
+            } else if (u < 0x20) {
+                char tmp[8];
+                snprintf(tmp, sizeof(tmp), "\\u%04x", u);
+                buf += tmp;
+            } else {
+                buf += c;
+            }
+        }
+        buf += '"';
+    }
+
+    // dipanggil abis tiap baris - nulis kalo udah lewat batas
+    void cekPenuh() {
+        if (buf.size() >= batas) flush();
+    }
+
+    // kalo sekali gagal, sisanya ga ditulis lagi - file-nya udah bolong
+    void flush() {
+        if (f && !gagal) {
+            if (!buf.empty() && fwrite(buf.data(), 1, buf.size(), f) != buf.size()) gagal = true;
+            if (fflush(f) != 0) gagal = true;
+        }
+        total += buf.size();
+        buf.clear();
+    }
+
+    // false kalo ada yang ga kesimpen utuh - cek abis flush terakhir
+    bool ok() const { return !gagal && !(f && ferror(f)); }
+
+    size_t jumlahByte() const { return total + buf.size(); }
+};
+
+// filter + urutan listing katalog
+struct FilterListing {
+    UrutKatalog urut = UrutKatalog::MASUK;
+    uint8_t kode = 0;  // 0 = semua tipe
+    bool hanyaTersedia = false;
+};
+
+// kursor halaman = slot terakhir yang udah ditulis. AWAL = dari depan,
+// HABIS = udah ga ada sisa
+constexpr uint32_t KURSOR_AWAL = 0xFFFFFFFFu;
+constexpr uint32_t KURSOR_HABIS = 0xFFFFFFFEu;
+
+void tulisHeaderItem(BufferKeluaran& out, FormatListing fmt) {
+    if (fmt == FormatListing::CSV) out.tambah("id,tipe,judul,detail,varian,tersedia\n");
+}
+
+// satu baris item. TEKS lewat Item::tulisInfo (format sama kaya tampilInfo),
+// CSV/JSONL dari kolom, kecuali status yang diambil dari `k` (bisa versi
+// lama punya potret). cekPenuh() urusan pemanggil - jangan sampe flush ke
+// file pas masih megang lock
+void tulisBarisItem(BufferKeluaran& out, FormatListing fmt, const Item& v, const KeadaanItem& k) {
+    switch (fmt) {
+        case FormatListing::TEKS:
+            v.tulisInfo(out.isi(), k);
+            out.tambah("---\n");
+            break;
+        case FormatListing::CSV:
+            out.csv(v.getId());
+            out.tambah(',');
+            out.tambah(v.getTipe());
+            out.tambah(',');
+            out.csv(v.getJudul());
+            out.tambah(',');
+            out.csv(v.getDetail());
+            out.tambah(v.getVarian() ? ",1," : ",0,");
+            out.tambah(k.isTersedia() ? "1\n" : "0\n");
+            break;
+        case FormatListing::JSONL:
+            out.tambah("{\"id\":");
+            out.json(v.getId());
+            out.tambah(",\"tipe\":\"");
+            out.tambah(v.getTipe());
+            out.tambah("\",\"judul\":");
+            out.json(v.getJudul());
+            out.tambah(",\"detail\":");
+            out.json(v.getDetail());
+            out.tambah(v.getVarian() ? ",\"varian\":true" : ",\"varian\":false");
+            out.tambah(k.isTersedia() ? ",\"tersedia\":true}\n" : ",\"tersedia\":false}\n");
+            break;
+    }
+}
+
+void tulisHeaderMember(BufferKeluaran& out, FormatListing fmt) {
+    if (fmt == FormatListing::CSV) out.tambah("id,nama,level,kredit,total_pinjaman,sukses\n");
+}
+
+void tulisBarisMember(BufferKeluaran& out, FormatListing fmt, const Member& m) {
+    switch (fmt) {
+        case FormatListing::TEKS:
+            m.tulisInfo(out.isi());
+            out.tambah("---\n");
+            break;
+        case FormatListing::CSV:
+            out.csv(m.getId());
+            out.tambah(',');
+            out.csv(m.getNama());
+            for (int x : {m.getLevel(), m.getKreditGratis(), m.getTotalPinjaman(), m.getPinjamanSukses()}) {
+                out.tambah(',');
+                out.angka(x);
+            }
+            out.tambah('\n');
+            break;
+        case FormatListing::JSONL:
+            out.tambah("{\"id\":");
+            out.json(m.getId());
+            out.tambah(",\"nama\":");
+            out.json(m.getNama());
+            out.tambah(",\"level\":");
+            out.angka(m.getLevel());
+            out.tambah(",\"kredit\":");
+            out.angka(m.getKreditGratis());
+            out.tambah(",\"total_pinjaman\":");
+            out.angka(m.getTotalPinjaman());
+            out.tambah(",\"sukses\":");
+            out.angka(m.getPinjamanSukses());
+            out.tambah("}\n");
+            break;
+    }
+}
+
+// ===========================
+// PARSER FILE ALAT (alat.txt)
+// ===========================
+// format per baris, dipisah spasi/tab:
+//   <Elektronik|NonElektronik> <Nama> <ID> <daya|bahan> <tersedia 0/1>
+// token-nya string_view ke buffer file, baru di-copy pas bikin objek
+struct ErrorImpor {
+    size_t baris;
+    string pesan;
+};
+
+struct HasilImpor {
+    size_t totalBaris = 0;
+    size_t sukses = 0;
+    vector<ErrorImpor> error;  // dibatesin, yang lain cuma dihitung
+    size_t jumlahError = 0;
+};
+
+inline bool isSpasi(char c) { return c == ' ' || c == '\t' || c == '\r'; }
+
+// pecah satu baris jadi token, balikin jumlah token (maksimal `maks`)
+inline size_t pecahToken(string_view baris, string_view* token, size_t maks) {
+    size_t n = 0, i = 0;
+    while (i < baris.size()) {
+        while (i < baris.size() && isSpasi(baris[i])) i++;
+        if (i == baris.size()) break;
+        size_t mulai = i;
+        while (i < baris.size() && !isSpasi(baris[i])) i++;
+        if (n == maks) return maks + 1;  // kebanyakan token
+        token[n++] = baris.substr(mulai, i - mulai);
+    }
+    return n;
+}
+
+// satu baris alat yang udah lolos cek. token-nya masih nunjuk ke isi file
+struct BarisAlat {
+    string_view t[5];  // kategori, nama, id, kondisi, tersedia
+    bool elektronik;
+};
+
+// cek format satu baris alat, belum bikin objek - aman dipanggil barengan
+// dari banyak thread. false + isi `pesan` kalo formatnya salah
+bool cekBarisAlat(string_view baris, BarisAlat& hasil, string& pesan) {
+    string_view* t = hasil.t;
+    size_t n = pecahToken(baris, t, 5);
+    if (n != 5) {
+        pesan = "butuh 5 kolom, dapet " + (n > 5 ? string("lebih") : to_string(n));
+        return false;
+    }
+
+    if (t[0] == "Elektronik") hasil.elektronik = true;
+    else if (t[0] == "NonElektronik") hasil.elektronik = false;
+    else {
+        pesan = "kategori '" + string(t[0]) + "' ga dikenal";
+        return false;
+    }
+
+    if (t[4] != "0" && t[4] != "1") {
+        pesan = "status tersedia harus 0/1";
+        return false;
+    }
+    return true;
+}
+
+Alat buatAlat(const BarisAlat& b) {
+    Alat alat(b.t[2], b.t[1], b.elektronik, b.t[3]);
+    alat.setTersedia(b.t[4] == "1");
+    return alat;
+}
+
+// ===========================
+// FILE KEBIJAKAN (kebijakan.txt)
+// ===========================
+// format per baris, '#' buat komentar. tipe yang ga disebut tetep pake
+// nilai lama di tabel:
+//   <Book|Magazine|DVD|Alat> <maxHari> <maxHariVarian> <denda/hari> <dendaVarian/hari> <biayaRusak>
+//   level <1..JUMLAH_LEVEL> <syarat pinjaman sukses> <bonus kredit>
+// dimuat sekali pas startup. WAL ga nyimpen dendanya, jadi ganti tabel di
+// antara dua sesi bikin transaksi yang di-replay dihitung pake tabel baru
+inline bool parseInt(string_view t, int& nilai) {
+    auto r = from_chars(t.data(), t.data() + t.size(), nilai);
+    return r.ec == errc() && r.ptr == t.data() + t.size() && nilai >= 0;
+}
+
+inline bool parseDesimal(string_view t, double& nilai) {
+    string s(t);
+    char* akhir = nullptr;
+    nilai = strtod(s.c_str(), &akhir);
+    return !s.empty() && akhir == s.c_str() + s.size() && nilai >= 0.0;
+}
+
+// isi `tabel` dari file. gagal = false + `pesan`, tabel-nya ga disentuh
+bool muatKebijakan(const string& path, TabelKebijakan& tabel, string& pesan) {
+    FileTerpeta file(path);
+    if (!file.valid()) {
+        pesan = "file ga bisa dibuka";
+        return false;
+    }
+
+    TabelKebijakan baru = tabel;
+    string_view isi(file.data(), file.size());
+    size_t pos = 0, nomor = 0;
+    while (pos < isi.size()) {
+        size_t akhir = isi.find('\n', pos);
+        if (akhir == string_view::npos) akhir = isi.size();
+        string_view baris = isi.substr(pos, akhir - pos);
+        pos = akhir + 1;
+        nomor++;
+
+        baris = baris.substr(0, baris.find('#'));
+        string_view t[6];
+        size_t n = pecahToken(baris, t, 6);
+        if (n == 0) continue;
+
+        auto gagal = [&](const string& alasan) {
+            pesan = "baris " + to_string(nomor) + ": " + alasan;
+            return false;
+        };
+
+        if (t[0] == "level") {
+            int ke, syarat, bonus;
+            if (n != 4) return gagal("level butuh 3 angka");
+            if (!parseInt(t[1], ke) || ke < 1 || ke > JUMLAH_LEVEL)
+                return gagal("level harus 1.." + to_string(JUMLAH_LEVEL));
+            if (!parseInt(t[2], syarat) || !parseInt(t[3], bonus)) return gagal("angka level ga valid");
+            baru.level[ke - 1] = {syarat, bonus};
+            continue;
+        }
+
+        size_t kode = 1;
+        while (kode < JUMLAH_KODE_TIPE && t[0] != NAMA_TIPE[kode]) kode++;
+        if (kode == JUMLAH_KODE_TIPE) return gagal("tipe '" + string(t[0]) + "' ga dikenal");
+        if (n != 6) return gagal("tipe butuh 5 angka");
+
+        AturanTipe aturan{};
+        if (!parseInt(t[1], aturan.maxHari[0]) || !parseInt(t[2], aturan.maxHari[1]) ||
+            aturan.maxHari[0] == 0 || aturan.maxHari[1] == 0)
+            return gagal("max hari harus angka > 0");
+        if (!parseDesimal(t[3], aturan.dendaPerHari[0]) || !parseDesimal(t[4], aturan.dendaPerHari[1]) ||
+            !parseDesimal(t[5], aturan.biayaRusak))
+            return gagal("denda harus angka >= 0");
+        baru.tipe[kode] = aturan;
+    }
+
+    tabel = baru;
+    return true;
+}
+
+// ===========================
+// WRITE-AHEAD LOG TRANSAKSI
+// ===========================
+// tiap record: [u32 panjang payload][u32 checksum][payload]
+// payload:     [u64 lsn][u8 jenis][field2 sesuai jenis]
+struct KonfigurasiLog {
+    size_t batasRecord = 256;  // langsung flush kalo antrian udah segini...
+    int batasMs = 20;          // ...atau paling lambat tiap sekian ms
+    bool fsyncAktif = true;    // false = cuma nulis ke OS, tanpa fsync
+};
+
+// group commit: yang nyatet cuma naro record di antrian memori, thread
+// penulis yang ngumpulin terus write + fsync sekali buat satu batch.
+// jadi ga ada fsync per transaksi, yang ilang pas crash paling cuma batasMs
+class LogTransaksi {
+public:
+    enum Jenis : uint8_t {
+        TAMBAH_ITEM = 1,
+        REGISTER_MEMBER = 2,
+        PINJAM = 3,
+        KEMBALI = 4,
+        KEMBALI_DVD = 5,
+        RESET_STATISTIK = 6,
+        RESERVASI = 7,
+        EKSEMPLAR = 8
+    };
+
+private:
+    string path;
+    KonfigurasiLog konfig;
+    FILE* f;
+
+    mutex mtx;                // jaga antrian + counter
+    mutex mtxFile;            // jaga FILE* (thread penulis vs potong())
+    condition_variable cv;
+    condition_variable cvSelesai;
+    string antrian;
+    size_t nAntrian;
+    uint64_t seqMasuk;        // jumlah record yang udah diantriin
+    uint64_t seqTertulis;     // jumlah record yang udah beneran di disk
+    bool flushDiminta;
+    bool berhenti;
+    // sekali write/flush/fsync gagal, log dianggap rusak: record berikutnya
+    // ditolak (kalo tetep ditulis, file-nya bolong di tengah dan replay
+    // nerapin transaksi yang ga nyambung). baru pulih abis potong() sukses,
+    // soalnya snapshot checkpoint udah nyakup semua yang ilang
+    atomic<bool> gagal;
+    PenulisBiner rec;
+    thread penulis;
+
+    static uint32_t checksum(const char* p, size_t n) {
+        uint32_t h = 2166136261u;
+        for (size_t i = 0; i < n; i++) {
+            h ^= static_cast<unsigned char>(p[i]);
+            h *= 16777619u;
+        }
+        return h;
+    }
+
+    // false kalo ada yang ga nyampe disk utuh
+    bool tulisBatch(const string& batch) {
+        lock_guard<mutex> lkFile(mtxFile);
+        if (!f) return false;
+        bool ok = fwrite(batch.data(), 1, batch.size(), f) == batch.size();
+        ok = fflush(f) == 0 && ok;
+#ifdef PERPUS_POSIX
+        if (ok && konfig.fsyncAktif) ok = fsync(fileno(f)) == 0;
+#endif
+        return ok;
+    }
+
+    void loopPenulis() {
+        unique_lock<mutex> lk(mtx);
+        while (true) {
+            cv.wait_for(lk, chrono::milliseconds(konfig.batasMs), [&] {
+                return berhenti || flushDiminta || nAntrian >= konfig.batasRecord;
+            });
+            if (!antrian.empty()) {
+                string batch;
+                batch.swap(antrian);
+                uint64_t seq = seqMasuk;
+                nAntrian = 0;
+                lk.unlock();
+                // yang udah gagal ga ditulis lagi, tapi seqTertulis tetep maju
+                // biar yang nunggu di sinkron() ga nyangkut - dia cek `gagal`
+                if (!gagal.load() && !tulisBatch(batch)) gagal.store(true);
+                lk.lock();
+                seqTertulis = seq;
+            }
+            flushDiminta = false;
+            cvSelesai.notify_all();
+            if (berhenti && antrian.empty()) break;
+        }
+    }
+
+public:
+    LogTransaksi(const string& path, KonfigurasiLog konfig)
+        : path(path), konfig(konfig), f(fopen(path.c_str(), "ab")), nAntrian(0),
+          seqMasuk(0), seqTertulis(0), flushDiminta(false), berhenti(false), gagal(false) {
+        if (this->konfig.batasMs < 1) this->konfig.batasMs = 1;
+        if (this->konfig.batasRecord < 1) this->konfig.batasRecord = 1;
+        penulis = thread(&LogTransaksi::loopPenulis, this);
+    }
+
+    ~LogTransaksi() {
+        {
+            lock_guard<mutex> lk(mtx);
+            berhenti = true;
+        }
+        cv.notify_one();
+        penulis.join();
+        if (f) fclose(f);
+    }
+
+    LogTransaksi(const LogTransaksi&) = delete;
+    LogTransaksi& operator=(const LogTransaksi&) = delete;
+
+    bool valid() const { return f != nullptr; }
+
+    // true = ada tulisan yang gagal, record baru ditolak sampe potong()
+    bool rusak() const { return gagal.load(); }
+
+    // antriin satu record - `isi` nulis field2 khusus jenis ini. nomor lsn
+    // diambil di dalem lock, jadi urutan di file = urutan lsn walau multi-thread.
+    // false (lsn tetep maju) kalo log-nya udah rusak
+    template <typename F>
+    bool catat(atomic<uint64_t>& lsn, Jenis jenis, F&& isi) {
+        lock_guard<mutex> lk(mtx);
+        if (gagal.load()) {
+            ++lsn;
+            return false;
+        }
+        rec.clear();
+        rec.tulis<uint32_t>(0);
+        rec.tulis<uint32_t>(0);
+        rec.tulis<uint64_t>(++lsn);
+        rec.tulis<uint8_t>(jenis);
+        isi(rec);
+        uint32_t panjang = static_cast<uint32_t>(rec.posisi() - 8);
+        rec.timpa<uint32_t>(0, panjang);
+        rec.timpa<uint32_t>(4, checksum(rec.data().data() + 8, panjang));
+        antrian += rec.data();
+        seqMasuk++;
+        if (++nAntrian >= konfig.batasRecord) cv.notify_one();
+        return true;
+    }
+
+    // blok sampe semua record yang udah dicatat beneran ketulis ke disk.
+    // false kalo ada yang gagal ditulis (record-nya ga tahan crash)
+    bool sinkron() {
+        unique_lock<mutex> lk(mtx);
+        uint64_t target = seqMasuk;
+        while (seqTertulis < target) {
+            flushDiminta = true;
+            cv.notify_one();
+            cvSelesai.wait(lk);
+        }
+        return !gagal.load();
+    }
+
+    // kosongin file log - dipanggil abis snapshot baru sukses disimpen.
+    // snapshot-nya udah nyakup record yang gagal ditulis, jadi log yang
+    // rusak boleh mulai lagi dari file kosong
+    bool potong() {
+        sinkron();
+        lock_guard<mutex> lkFile(mtxFile);
+        if (f) fclose(f);
+        FILE* kosong = fopen(path.c_str(), "wb");
+        if (kosong) fclose(kosong);
+        f = fopen(path.c_str(), "ab");
+        gagal.store(f == nullptr);
+        return f != nullptr;
+    }
+
+    // baca ulang semua record yang utuh, panggil terapkan(lsn, jenis, payload).
+    // kalo ekornya kepotong (crash pas nulis), bagian rusaknya dibuang.
+    // balikin jumlah record yang valid
+    template <typename F>
+    static size_t replay(const string& path, F&& terapkan) {
+        size_t nRecord = 0;
+        size_t valid = 0;
+        string sisaValid;
+        {
+            FileTerpeta file(path);
+            if (!file.valid()) return 0;
+            const char* data = file.data();
+            size_t n = file.size();
+            while (n - valid >= 8) {
+                uint32_t panjang, cek;
+                memcpy(&panjang, data + valid, 4);
+                memcpy(&cek, data + valid + 4, 4);
+                if (n - valid - 8 < panjang || panjang < 9) break;
+                if (checksum(data + valid + 8, panjang) != cek) break;
+
+                PembacaBiner in(data + valid + 8, panjang);
+                uint64_t lsn = in.baca<uint64_t>();
+                Jenis jenis = static_cast<Jenis>(in.baca<uint8_t>());
+                terapkan(lsn, jenis, in);
+                valid += 8 + panjang;
+                nRecord++;
+            }
+            if (valid == n) return nRecord;
+            sisaValid.assign(data, valid);
+        }
+        tulisFileAtomik(path, sisaValid);
+        return nRecord;
+    }
+};
+
+// ===========================
+// STATISTIK BULANAN (SHARDED)
+// ===========================
+// counter dipecah per shard biar thread2 yang nyatet ga rebutan satu lock.
+// tiap thread nempel ke satu shard, pas laporan baru semua shard dijumlahin
+class StatistikBulanan {
+private:
+    static constexpr size_t JUMLAH_SHARD = 16;
+
+    // dihitung per kode tipe (handle kecil), bukan map<string, int> - jalur
+    // panas cuma naikin satu angka, nama tipenya baru dipasang pas laporan
+    struct alignas(64) Shard {
+        mutable mutex m;
+        array<int, 256> pinjamanPerKode{};
+        double denda = 0.0;
+        int kredit = 0;
+    };
+    array<Shard, JUMLAH_SHARD> shard;
+    // tipe dari snapshot yang namanya ga ada di NAMA_TIPE - dijaga shard[0].m
+    map<string, int> tipeLain;
+
+    Shard& shardSaya() {
+        static atomic<size_t> berikutnya{0};
+        thread_local size_t idx = berikutnya++ % JUMLAH_SHARD;
+        return shard[idx];
+    }
+
+    static string namaKode(size_t kode) {
+        return kode < JUMLAH_KODE_TIPE ? string(NAMA_TIPE[kode]) : "Tipe " + to_string(kode);
+    }
+
+public:
+    void catatPinjam(uint8_t kode, int jumlah, int kredit) {
+        Shard& sh = shardSaya();
+        lock_guard<mutex> lk(sh.m);
+        sh.pinjamanPerKode[kode] += jumlah;
+        sh.kredit += kredit;
+    }
+
+    void catatDenda(double denda) {
+        if (denda == 0.0) return;
+        Shard& sh = shardSaya();
+        lock_guard<mutex> lk(sh.m);
+        sh.denda += denda;
+    }
+
+    map<string, int> pinjamanPerTipe() const {
+        array<int, 256> perKode{};
+        map<string, int> total;
+        for (const auto& sh : shard) {
+            lock_guard<mutex> lk(sh.m);
+            for (size_t k = 0; k < perKode.size(); k++) perKode[k] += sh.pinjamanPerKode[k];
+            if (&sh == &shard[0]) total = tipeLain;
+        }
+        for (size_t k = 0; k < perKode.size(); k++) {
+            if (perKode[k]) total[namaKode(k)] += perKode[k];
+        }
+        return total;
+    }
+
+    double totalDenda() const {
+        double total = 0.0;
+        for (const auto& sh : shard) {
+            lock_guard<mutex> lk(sh.m);
+            total += sh.denda;
+        }
+        return total;
+    }
+
+    int totalKredit() const {
+        int total = 0;
+        for (const auto& sh : shard) {
+            lock_guard<mutex> lk(sh.m);
+            total += sh.kredit;
+        }
+        return total;
+    }
+
+    void reset() {
+        for (auto& sh : shard) {
+            lock_guard<mutex> lk(sh.m);
+            sh.pinjamanPerKode.fill(0);
+            sh.denda = 0.0;
+            sh.kredit = 0;
+            if (&sh == &shard[0]) tipeLain.clear();
+        }
+    }
+
+    // isi ulang dari snapshot - semuanya ditaro di shard pertama
+    void pulihkan(const map<string, int>& perTipe, double denda, int kredit) {
+        reset();
+        lock_guard<mutex> lk(shard[0].m);
+        for (const auto& pair : perTipe) {
+            size_t kode = 1;
+            while (kode < JUMLAH_KODE_TIPE && pair.first != NAMA_TIPE[kode]) kode++;
+            if (kode < JUMLAH_KODE_TIPE) shard[0].pinjamanPerKode[kode] += pair.second;
+            else tipeLain[pair.first] += pair.second;
+        }
+        shard[0].denda = denda;
+        shard[0].kredit = kredit;
+    }
+};
+
+// ===========================
+// KALENDER
+// ===========================
+// satuan waktu di sistem ini hari: hari ke-N sejak 1970-01-01 (UTC)
+int32_t hariSekarang() {
+    auto detik = chrono::duration_cast<chrono::seconds>(chrono::system_clock::now().time_since_epoch());
+    return static_cast<int32_t>(detik.count() / 86400);
+}
+
+struct Tanggal {
+    int tahun;
+    int bulan;  // 1-12
+    int hari;   // 1-31
+};
+
+// konversi hari -> tanggal kalender gregorian (algoritma civil_from_days)
+Tanggal tanggalDariHari(int32_t n) {
+    int64_t z = int64_t(n) + 719468;
+    int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+    int64_t doe = z - era * 146097;
+    int64_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    int64_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    int64_t mp = (5 * doy + 2) / 153;
+    int d = static_cast<int>(doy - (153 * mp + 2) / 5 + 1);
+    int m = static_cast<int>(mp < 10 ? mp + 3 : mp - 9);
+    return Tanggal{static_cast<int>(yoe + era * 400 + (m <= 2)), m, d};
+}
+
+// kebalikannya (days_from_civil)
+int32_t hariDariTanggal(int tahun, int bulan, int hari) {
+    int64_t y = tahun - (bulan <= 2);
+    int64_t era = (y >= 0 ? y : y - 399) / 400;
+    int64_t yoe = y - era * 400;
+    int64_t doy = (153 * (bulan + (bulan > 2 ? -3 : 9)) + 2) / 5 + hari - 1;
+    int64_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return static_cast<int32_t>(era * 146097 + doe - 719468);
+}
+
+// nomor bulan berurutan (tahun*12 + bulan-1), enak buat range
+int32_t bulanDariHari(int32_t n) {
+    Tanggal t = tanggalDariHari(n);
+    return t.tahun * 12 + t.bulan - 1;
+}
+
+int32_t hariPertamaBulan(int32_t bulanKe) {
+    return hariDariTanggal(bulanKe / 12, bulanKe % 12 + 1, 1);
+}
+
+string formatTanggal(int32_t n) {
+    Tanggal t = tanggalDariHari(n);
+    char buf[16];
+    snprintf(buf, sizeof(buf), "%04d-%02d-%02d", t.tahun, t.bulan, t.hari);
+    return buf;
+}
+
+// ===========================
+// MESIN LAPORAN (EMBER WAKTU)
+// ===========================
+// agregat yang udah dijumlahin per hari & per bulan, dipecah per tipe.
+// laporan rentang berapapun cukup jumlahin ember-nya, ga perlu nyapu ulang
+// riwayat transaksi
+struct AgregatLaporan {
+    array<uint32_t, JUMLAH_KODE_TIPE> pinjam{};
+    array<uint32_t, JUMLAH_KODE_TIPE> kembali{};
+    array<uint32_t, JUMLAH_KODE_TIPE> terlambat{};
+    array<double, JUMLAH_KODE_TIPE> denda{};
+    uint32_t kredit = 0;
+
+    void tambah(const AgregatLaporan& lain) {
+        for (size_t k = 0; k < JUMLAH_KODE_TIPE; k++) {
+            pinjam[k] += lain.pinjam[k];
+            kembali[k] += lain.kembali[k];
+            terlambat[k] += lain.terlambat[k];
+            denda[k] += lain.denda[k];
+        }
+        kredit += lain.kredit;
+    }
+
+    bool kosong() const {
+        for (size_t k = 0; k < JUMLAH_KODE_TIPE; k++) {
+            if (pinjam[k] || kembali[k] || denda[k] != 0.0) return false;
+        }
+        return kredit == 0;
+    }
+
+    uint32_t totalPinjam() const {
+        uint32_t total = 0;
+        for (uint32_t x : pinjam) total += x;
+        return total;
+    }
+
+    double totalDenda() const {
+        double total = 0.0;
+        for (double x : denda) total += x;
+        return total;
+    }
+
+    // persen pengembalian yang telat, semua tipe kalo kode = 0
+    double rasioTerlambat(uint8_t kode = 0) const {
+        uint32_t telat = 0, semua = 0;
+        for (size_t k = 0; k < JUMLAH_KODE_TIPE; k++) {
+            if (kode != 0 && k != kode) continue;
+            telat += terlambat[k];
+            semua += kembali[k];
+        }
+        return semua ? 100.0 * telat / semua : 0.0;
+    }
+
+    void tulisKe(PenulisBiner& out) const {
+        for (size_t k = 0; k < JUMLAH_KODE_TIPE; k++) {
+            out.tulis<uint32_t>(pinjam[k]);
+            out.tulis<uint32_t>(kembali[k]);
+            out.tulis<uint32_t>(terlambat[k]);
+            out.tulis<double>(denda[k]);
+        }
+        out.tulis<uint32_t>(kredit);
+    }
+
+    // nKode = jumlah tipe pas ditulis, tipe yang ga dikenal lagi dilewatin
+    void bacaDari(PembacaBiner& in, size_t nKode) {
+        for (size_t k = 0; k < nKode; k++) {
+            uint32_t p = in.baca<uint32_t>();
+            uint32_t b = in.baca<uint32_t>();
+            uint32_t t = in.baca<uint32_t>();
+            double d = in.baca<double>();
+            if (k >= JUMLAH_KODE_TIPE) continue;
+            pinjam[k] = p;
+            kembali[k] = b;
+            terlambat[k] = t;
+            denda[k] = d;
+        }
+        kredit = in.baca<uint32_t>();
+    }
+};
+
+// dua tingkat ring buffer ukuran tetap: harian (~13 bulan ke belakang) sama
+// bulanan (10 tahun). ember yang ketimpa putaran baru otomatis dikosongin.
+// sharded kaya StatistikBulanan biar thread2 transaksi ga rebutan
+class MesinLaporan {
+public:
+    static constexpr int32_t SLOT_HARI = 400;
+    static constexpr int32_t SLOT_BULAN = 120;
+
+private:
+    static constexpr size_t JUMLAH_SHARD = 16;
+    static constexpr int32_t KOSONG = INT32_MIN;
+
+    struct Ember {
+        int32_t kunci = KOSONG;  // hari / nomor bulan yang lagi nempatin ember ini
+        AgregatLaporan isi;
+    };
+
+    struct alignas(64) Shard {
+        mutable mutex m;
+        array<Ember, SLOT_HARI> hari;
+        array<Ember, SLOT_BULAN> bulan;
+    };
+    unique_ptr<array<Shard, JUMLAH_SHARD>> shard;
+
+    Shard& shardSaya() {
+        static atomic<size_t> berikutnya{0};
+        thread_local size_t idx = berikutnya++ % JUMLAH_SHARD;
+        return (*shard)[idx];
+    }
+
+    template <size_t N>
+    static AgregatLaporan& emberTulis(array<Ember, N>& ring, int32_t kunci) {
+        Ember& e = ring[((kunci % int32_t(N)) + N) % N];
+        if (e.kunci != kunci) {
+            e.kunci = kunci;
+            e.isi = AgregatLaporan();
+        }
+        return e.isi;
+    }
+
+    template <size_t N>
+    static void tambahkanEmber(const array<Ember, N>& ring, int32_t kunci, AgregatLaporan& hasil) {
+        const Ember& e = ring[((kunci % int32_t(N)) + N) % N];
+        if (e.kunci == kunci) hasil.tambah(e.isi);
+    }
+
+    template <typename F>
+    void tulis(int32_t hari, F&& ubah) {
+        Shard& sh = shardSaya();
+        lock_guard<mutex> lk(sh.m);
+        ubah(emberTulis(sh.hari, hari));
+        ubah(emberTulis(sh.bulan, bulanDariHari(hari)));
+    }
+
+public:
+    MesinLaporan() : shard(make_unique<array<Shard, JUMLAH_SHARD>>()) {}
+
+    // setor agregat yang udah dijumlahin duluan (dipake prosesBatch)
+    void catat(int32_t hari, const AgregatLaporan& a) {
+        tulis(hari, [&](AgregatLaporan& ember) { ember.tambah(a); });
+    }
+
+    void catatPinjam(int32_t hari, uint8_t kode, uint32_t jumlah, uint32_t kredit) {
+        if (kode >= JUMLAH_KODE_TIPE) return;
+        tulis(hari, [&](AgregatLaporan& a) {
+            a.pinjam[kode] += jumlah;
+            a.kredit += kredit;
+        });
+    }
+
+    void catatKembali(int32_t hari, uint8_t kode, bool terlambat, double denda) {
+        if (kode >= JUMLAH_KODE_TIPE) return;
+        tulis(hari, [&](AgregatLaporan& a) {
+            a.kembali[kode]++;
+            a.terlambat[kode] += terlambat;
+            a.denda[kode] += denda;
+        });
+    }
+
+    AgregatLaporan satuHari(int32_t hari) const {
+        AgregatLaporan hasil;
+        for (const Shard& sh : *shard) {
+            lock_guard<mutex> lk(sh.m);
+            tambahkanEmber(sh.hari, hari, hasil);
+        }
+        return hasil;
+    }
+
+    AgregatLaporan satuBulan(int32_t bulanKe) const {
+        AgregatLaporan hasil;
+        for (const Shard& sh : *shard) {
+            lock_guard<mutex> lk(sh.m);
+            tambahkanEmber(sh.bulan, bulanKe, hasil);
+        }
+        return hasil;
+    }
+
+    // rentang [dari, sampai] dalam hari. bulan yang kecover penuh diambil
+    // dari ember bulanan, pinggirannya dari ember harian - jadi O(ember),
+    // dan rentang yang udah lewat dari jendela harian tetep kejawab per bulan.
+    // hari pinggiran yang udah lewat jendela harian ga kehitung
+    AgregatLaporan rentang(int32_t dari, int32_t sampai) const {
+        AgregatLaporan hasil;
+        int32_t h = dari;
+        while (h <= sampai) {
+            int32_t bulanKe = bulanDariHari(h);
+            int32_t awal = hariPertamaBulan(bulanKe);
+            int32_t awalBerikut = hariPertamaBulan(bulanKe + 1);
+            if (h == awal && awalBerikut - 1 <= sampai) {
+                hasil.tambah(satuBulan(bulanKe));
+                h = awalBerikut;
+            } else {
+                hasil.tambah(satuHari(h));
+                h++;
+            }
+        }
+        return hasil;
+    }
+
+    void clear() {
+        for (Shard& sh : *shard) {
+            lock_guard<mutex> lk(sh.m);
+            sh.hari.fill(Ember());
+            sh.bulan.fill(Ember());
+        }
+    }
+
+    // cuma ember yang ada isinya yang ditulis, shard udah dijumlahin
+    void tulisKe(PenulisBiner& out) const {
+        auto tulisTingkat = [&](auto ambilRing, auto ambilSatu) {
+            vector<int32_t> kunci;
+            for (const Shard& sh : *shard) {
+                lock_guard<mutex> lk(sh.m);
+                for (const Ember& e : ambilRing(sh)) {
+                    if (e.kunci != KOSONG) kunci.push_back(e.kunci);
+                }
+            }
+            sort(kunci.begin(), kunci.end());
+            kunci.erase(unique(kunci.begin(), kunci.end()), kunci.end());
+            out.tulis<uint32_t>(static_cast<uint32_t>(kunci.size()));
+            for (int32_t k : kunci) {
+                out.tulis<int32_t>(k);
+                ambilSatu(k).tulisKe(out);
+            }
+        };
+        out.tulis<uint8_t>(static_cast<uint8_t>(JUMLAH_KODE_TIPE));
+        tulisTingkat([](const Shard& sh) -> const array<Ember, SLOT_HARI>& { return sh.hari; },
+                     [&](int32_t k) { return satuHari(k); });
+        tulisTingkat([](const Shard& sh) -> const array<Ember, SLOT_BULAN>& { return sh.bulan; },
+                     [&](int32_t k) { return satuBulan(k); });
+    }
+
+    // isi ulang dari snapshot - semuanya masuk shard pertama
+    void bacaDari(PembacaBiner& in) {
+        clear();
+        Shard& sh = (*shard)[0];
+        lock_guard<mutex> lk(sh.m);
+        size_t nKode = in.baca<uint8_t>();
+        uint32_t nHari = in.baca<uint32_t>();
+        for (uint32_t i = 0; i < nHari && in.isOk(); i++) {
+            int32_t k = in.baca<int32_t>();
+            emberTulis(sh.hari, k).bacaDari(in, nKode);
+        }
+        uint32_t nBulan = in.baca<uint32_t>();
+        for (uint32_t i = 0; i < nBulan && in.isOk(); i++) {
+            int32_t k = in.baca<int32_t>();
+            emberTulis(sh.bulan, k).bacaDari(in, nKode);
+        }
+    }
+};
+
+// statistik bulanan yang di-reset ga dibuang, diarsip per periode
+struct ArsipPeriode {
+    int32_t hariMulai;
+    int32_t hariSelesai;
+    map<string, int> pinjamanPerTipe;
+    double denda;
+    int kredit;
+};
+
+// ===========================
+// TABEL PINJAMAN AKTIF (JATUH TEMPO)
+// ===========================
+// satu entri per eksemplar: siapa yang minjem, kapan, jatuh temponya kapan.
+// eksemplar satu judul dirantai dari kepala[slot], jadi judul yang eksemplarnya
+// banyak tetep bisa dipinjem barengan. nomor entri = kunci pinjaman.
+// jatuh tempo diantriin di min-heap; pas hari maju, yang lewat tempo dipindah
+// ke daftar telat - jadi "yang baru telat hari ini" cuma O(yang kadaluarsa).
+// denda berjalan = hariIni * sum(tarif) - sum(tarif * jatuhTempo), O(1).
+// dipecah per shard (slot item % JUMLAH_SHARD) biar meja2 ga rebutan satu lock
+class TabelPinjaman {
+public:
+    static constexpr uint32_t KOSONG = UINT32_MAX;
+
+    struct Pinjaman {
+        uint32_t slotMember = KOSONG;  // KOSONG = lagi ga dipinjem
+        uint32_t slotItem = KOSONG;
+        int32_t hariPinjam = 0;
+        int32_t jatuhTempo = 0;
+        double dendaPerHari = 0.0;
+        uint32_t generasi = 0;         // naik tiap pinjam/balik, buat buang jadwal basi
+        int32_t posTelat = -1;         // posisi di daftar telat shard, -1 kalo belum telat
+        uint32_t berikut = KOSONG;     // eksemplar berikutnya dari judul yang sama
+    };
+
+private:
+    static constexpr size_t JUMLAH_SHARD = 16;
+
+    struct Jadwal {
+        int32_t jatuhTempo;
+        uint32_t entri;
+        uint32_t generasi;
+        bool operator>(const Jadwal& lain) const { return jatuhTempo > lain.jatuhTempo; }
+    };
+
+    struct alignas(64) Shard {
+        mutable mutex m;
+        vector<Jadwal> heap;     // min-heap by jatuhTempo
+        vector<uint32_t> telat;  // entri2 yang udah lewat tempo & belum balik
+        vector<Jadwal> baruTelat;  // udah masuk `telat` tapi belum diambil ambilBaruTelat
+        double sumTarif = 0.0;
+        double sumTarifTempo = 0.0;
+        size_t aktif = 0;
+    };
+
+    // dua2nya cuma tumbuh pas lock struktur exclusive
+    vector<Pinjaman> entri;    // per eksemplar
+    vector<uint32_t> kepala;   // slot item -> entri eksemplar pertamanya
+    array<Shard, JUMLAH_SHARD> shard;
+
+    Shard& shardUntuk(uint32_t slot) { return shard[slot % JUMLAH_SHARD]; }
+
+    void keluarDariTelat(Shard& sh, Pinjaman& p) {
+        uint32_t pindah = sh.telat.back();
+        sh.telat[p.posTelat] = pindah;
+        entri[pindah].posTelat = p.posTelat;
+        sh.telat.pop_back();
+        p.posTelat = -1;
+        sh.sumTarif -= p.dendaPerHari;
+        sh.sumTarifTempo -= p.dendaPerHari * p.jatuhTempo;
+    }
+
+    // majuin waktu satu shard ke `hariIni`: pinjaman yang jatuh temponya <
+    // hariIni pindah ke daftar telat. yang baru telat juga dititipin di
+    // `baruTelat` sampe diambil ambilBaruTelat - jadi yang majuin duluan
+    // (daftar telat, denda berjalan) ga bikin cekJatuhTempo berikutnya kelewatan
+    void majuShard(Shard& sh, int32_t hariIni) {
+        lock_guard<mutex> lk(sh.m);
+        while (!sh.heap.empty() && sh.heap.front().jatuhTempo < hariIni) {
+            Jadwal j = sh.heap.front();
+            pop_heap(sh.heap.begin(), sh.heap.end(), greater<Jadwal>());
+            sh.heap.pop_back();
+            Pinjaman& p = entri[j.entri];
+            if (p.generasi != j.generasi || p.slotMember == KOSONG || p.posTelat >= 0) continue;
+            p.posTelat = static_cast<int32_t>(sh.telat.size());
+            sh.telat.push_back(j.entri);
+            sh.sumTarif += p.dendaPerHari;
+            sh.sumTarifTempo += p.dendaPerHari * p.jatuhTempo;
+            sh.baruTelat.push_back(j);
+        }
+        // kalo ga ada yang pernah ngambil, titipan yang keburu balik dibuang
+        // biar ga numpuk - yang masih sah pasti ada di `telat` juga
+        if (sh.baruTelat.size() > 2 * sh.telat.size() + 64) {
+            sh.baruTelat.erase(remove_if(sh.baruTelat.begin(), sh.baruTelat.end(),
+                                         [&](const Jadwal& j) { return entri[j.entri].generasi != j.generasi; }),
+                               sh.baruTelat.end());
+        }
+    }
+
+public:
+    void tambahSlot(uint32_t nEksemplar = 1) {
+        kepala.push_back(KOSONG);
+        tambahEksemplar(static_cast<uint32_t>(kepala.size() - 1), nEksemplar);
+    }
+
+    // eksemplar baru buat judul yang udah ada
+    void tambahEksemplar(uint32_t slot, uint32_t n) {
+        for (uint32_t i = 0; i < n; i++) {
+            Pinjaman p;
+            p.slotItem = slot;
+            p.berikut = kepala[slot];
+            kepala[slot] = static_cast<uint32_t>(entri.size());
+            entri.push_back(p);
+        }
+    }
+
+    // jumlah entri yang udah kepasang buat judul ini
+    uint32_t jumlahEksemplar(uint32_t slot) const {
+        uint32_t n = 0;
+        for (uint32_t e = kepala[slot]; e != KOSONG; e = entri[e].berikut) n++;
+        return n;
+    }
+
+    void reserve(size_t n) {
+        entri.reserve(n);
+        kepala.reserve(n);
+    }
+
+    void clear() {
+        entri.clear();
+        kepala.clear();
+        for (Shard& sh : shard) {
+            lock_guard<mutex> lk(sh.m);
+            sh.heap.clear();
+            sh.telat.clear();
+            sh.baruTelat.clear();
+            sh.sumTarif = sh.sumTarifTempo = 0.0;
+            sh.aktif = 0;
+        }
+    }
+
+    // pake eksemplar pertama yang lagi nganggur. rantainya sepanjang jumlah
+    // eksemplar judul itu doang. kalo semuanya kepake (state ga sinkron),
+    // entri pertama yang ditimpa - sama kaya kelakuan satu-eksemplar dulu
+    void mulai(uint32_t slot, uint32_t slotMember, int32_t hariPinjam, int32_t jatuhTempo, double dendaPerHari) {
+        Shard& sh = shardUntuk(slot);
+        lock_guard<mutex> lk(sh.m);
+        uint32_t e = kepala[slot];
+        for (uint32_t c = e; c != KOSONG; c = entri[c].berikut) {
+            if (entri[c].slotMember == KOSONG) {
+                e = c;
+                break;
+            }
+        }
+        Pinjaman& p = entri[e];
+        if (p.posTelat >= 0) keluarDariTelat(sh, p);
+        if (p.slotMember == KOSONG) sh.aktif++;
+        p.slotMember = slotMember;
+        p.hariPinjam = hariPinjam;
+        p.jatuhTempo = jatuhTempo;
+        p.dendaPerHari = dendaPerHari;
+        p.generasi++;
+        sh.heap.push_back(Jadwal{jatuhTempo, e, p.generasi});
+        push_heap(sh.heap.begin(), sh.heap.end(), greater<Jadwal>());
+    }
+
+    // tutup pinjaman `slotMember` atas judul ini. kalo member itu ga kecatet
+    // minjem (balikin titipan orang), eksemplar pertama yang lagi keluar yang ditutup
+    void selesai(uint32_t slot, uint32_t slotMember) {
+        Shard& sh = shardUntuk(slot);
+        lock_guard<mutex> lk(sh.m);
+        uint32_t e = KOSONG;
+        for (uint32_t c = kepala[slot]; c != KOSONG; c = entri[c].berikut) {
+            if (entri[c].slotMember == KOSONG) continue;
+            if (e == KOSONG) e = c;
+            if (entri[c].slotMember == slotMember) {
+                e = c;
+                break;
+            }
+        }
+        if (e == KOSONG) return;
+        Pinjaman& p = entri[e];
+        if (p.posTelat >= 0) keluarDariTelat(sh, p);
+        p.slotMember = KOSONG;
+        p.generasi++;  // jadwalnya di heap jadi basi, dibuang pas ke-pop
+        sh.aktif--;
+    }
+
+    Pinjaman lihat(uint32_t e) const {
+        const Shard& sh = shard[entri[e].slotItem % JUMLAH_SHARD];
+        lock_guard<mutex> lk(sh.m);
+        return entri[e];
+    }
+
+    // shard-nya ga nyentuh satu sama lain, jadi tiap shard dimajuin di `kolam`
+    void majuHari(int32_t hariIni, KolamParalel& kolam) {
+        kolam.untukRentang(JUMLAH_SHARD, 1, [&](size_t a, size_t b) {
+            for (size_t s = a; s < b; s++) majuShard(shard[s], hariIni);
+        });
+    }
+
+    // entri2 yang jadi telat sejak pengambilan terakhir (yang keburu balik ga ikut)
+    vector<uint32_t> ambilBaruTelat() {
+        vector<uint32_t> hasil;
+        for (Shard& sh : shard) {
+            lock_guard<mutex> lk(sh.m);
+            for (const Jadwal& j : sh.baruTelat) {
+                if (entri[j.entri].generasi == j.generasi) hasil.push_back(j.entri);
+            }
+            sh.baruTelat.clear();
+        }
+        return hasil;
+    }
+
+    // total denda yang udah numpuk dari semua pinjaman telat per `hariIni`.
+    // sekalian majuin tiap shard dulu (yang mahal - pop heap jatuh tempo),
+    // jadi satu lintasan paralel di `kolam`; jumlahnya digabung urut per
+    // shard, hasilnya sama berapa pun thread-nya
+    double dendaBerjalan(int32_t hariIni, KolamParalel& kolam) {
+        auto peta = [&](size_t a, size_t b) {
+            double total = 0.0;
+            for (size_t s = a; s < b; s++) {
+                Shard& sh = shard[s];
+                majuShard(sh, hariIni);
+                lock_guard<mutex> lk(sh.m);
+                total += hariIni * sh.sumTarif - sh.sumTarifTempo;
+            }
+            return total;
+        };
+        return kolam.reduksi(JUMLAH_SHARD, 1, 0.0, peta, [](double x, double y) { return x + y; });
+    }
+
+    vector<uint32_t> semuaTelat() const {
+        vector<uint32_t> hasil;
+        for (const Shard& sh : shard) {
+            lock_guard<mutex> lk(sh.m);
+            hasil.insert(hasil.end(), sh.telat.begin(), sh.telat.end());
+        }
+        return hasil;
+    }
+
+    size_t jumlahAktif() const {
+        size_t total = 0;
+        for (const Shard& sh : shard) {
+            lock_guard<mutex> lk(sh.m);
+            total += sh.aktif;
+        }
+        return total;
+    }
+
+    // jumlah entri (eksemplar), buat jalan dari 0..size()-1 pake lihat()
+    size_t size() const { return entri.size(); }
+};
+
+// ===========================
+// ANTREAN RESERVASI (FIFO PER JUDUL)
+// ===========================
+// member yang kehabisan eksemplar bisa ngantre. tiap judul punya linked list
+// kepala/ekor di atas kolam simpul per shard (simpul bekas didaur ulang lewat
+// free list), jadi keluar antrean - yang kejadian tiap eksemplar balik - O(1)
+// tanpa alokasi (masuk cuma nambah cek dobel sepanjang antrean). jumlah yang
+// ngantre juga dicerminin di kata status item (lihat KatalogKolom::cobaAntre /
+// cobaBalikin) - yang mutusin "eksemplar ini jatah antrean" itu CAS di kolom,
+// antrean ini cuma nyatet urutannya siapa
+class AntreanReservasi {
+public:
+    static constexpr uint32_t KOSONG = UINT32_MAX;
+
+private:
+    static constexpr size_t JUMLAH_SHARD = 16;
+
+    struct Simpul {
+        uint32_t slotMember;
+        uint32_t berikut;
+    };
+
+    struct Ujung {
+        uint32_t kepala = KOSONG;
+        uint32_t ekor = KOSONG;
+    };
+
+    struct alignas(64) Shard {
+        mutable mutex m;
+        vector<Simpul> simpul;
+        uint32_t bebas = KOSONG;  // free list simpul
+    };
+
+    vector<Ujung> ujung;  // per slot item - cuma tumbuh pas lock struktur exclusive
+    array<Shard, JUMLAH_SHARD> shard;
+
+    Shard& shardUntuk(uint32_t slot) { return shard[slot % JUMLAH_SHARD]; }
+
+public:
+    void tambahSlot() { ujung.emplace_back(); }
+    void reserve(size_t n) { ujung.reserve(n); }
+
+    void clear() {
+        ujung.clear();
+        for (Shard& sh : shard) {
+            lock_guard<mutex> lk(sh.m);
+            sh.simpul.clear();
+            sh.bebas = KOSONG;
+        }
+    }
+
+    // masukin member ke ekor antrean judul ini. rak-nya harus lagi kosong
+    // (dicek + dicatat atomik lewat item.cobaAntre di bawah lock shard, jadi
+    // yang ngembaliin barengan pasti liat simpul ini pas giliran diserahin).
+    // `posisi` = urutan di antrean, 1 = paling depan. `sudahMasuk` dipanggil
+    // kalo sukses, masih di bawah lock shard - yang ngembaliin baru bisa
+    // ngambil simpul ini setelahnya, jadi record WAL-nya pasti duluan
+    template <typename F>
+    StatusTransaksi daftar(uint32_t slot, uint32_t slotMember, const Item& item, uint32_t& posisi, F&& sudahMasuk) {
+        Shard& sh = shardUntuk(slot);
+        lock_guard<mutex> lk(sh.m);
+        Ujung& u = ujung[slot];
+        posisi = 1;
+        for (uint32_t c = u.kepala; c != KOSONG; c = sh.simpul[c].berikut, posisi++) {
+            if (sh.simpul[c].slotMember == slotMember) return StatusTransaksi::SUDAH_ANTRE;
+        }
+        if (!item.cobaAntre()) return StatusTransaksi::ITEM_TERSEDIA;
+
+        uint32_t baru = sh.bebas;
+        if (baru != KOSONG) {
+            sh.bebas = sh.simpul[baru].berikut;
+            sh.simpul[baru] = Simpul{slotMember, KOSONG};
+        } else {
+            baru = static_cast<uint32_t>(sh.simpul.size());
+            sh.simpul.push_back(Simpul{slotMember, KOSONG});
+        }
+        if (u.ekor != KOSONG) sh.simpul[u.ekor].berikut = baru;
+        else u.kepala = baru;
+        u.ekor = baru;
+        sudahMasuk();
+        return StatusTransaksi::SUKSES;
+    }
+
+    StatusTransaksi daftar(uint32_t slot, uint32_t slotMember, const Item& item, uint32_t& posisi) {
+        return daftar(slot, slotMember, item, posisi, [] {});
+    }
+
+    // keluarin kepala antrean, KOSONG kalo antreannya kosong. dipanggil abis
+    // cobaBalikin/setEksemplar ngasih jatah ke antrean
+    uint32_t ambil(uint32_t slot) {
+        Shard& sh = shardUntuk(slot);
+        lock_guard<mutex> lk(sh.m);
+        Ujung& u = ujung[slot];
+        uint32_t c = u.kepala;
+        if (c == KOSONG) return KOSONG;
+        uint32_t slotMember = sh.simpul[c].slotMember;
+        u.kepala = sh.simpul[c].berikut;
+        if (u.kepala == KOSONG) u.ekor = KOSONG;
+        sh.simpul[c].berikut = sh.bebas;
+        sh.bebas = c;
+        return slotMember;
+    }
+
+    // kepala antrean tanpa dikeluarin, KOSONG kalo kosong. cuma stabil kalo
+    // yang manggil megang kunci item judul ini (daftar/ambil lewat situ juga)
+    uint32_t kepala(uint32_t slot) const {
+        const Shard& sh = shard[slot % JUMLAH_SHARD];
+        lock_guard<mutex> lk(sh.m);
+        uint32_t c = ujung[slot].kepala;
+        return c == KOSONG ? KOSONG : sh.simpul[c].slotMember;
+    }
+
+    // isi antrean dari depan ke belakang (snapshot, tampilan)
+    vector<uint32_t> isi(uint32_t slot) const {
+        const Shard& sh = shard[slot % JUMLAH_SHARD];
+        lock_guard<mutex> lk(sh.m);
+        vector<uint32_t> hasil;
+        for (uint32_t c = ujung[slot].kepala; c != KOSONG; c = sh.simpul[c].berikut)
+            hasil.push_back(sh.simpul[c].slotMember);
+        return hasil;
+    }
+
+    bool kosong(uint32_t slot) const {
+        const Shard& sh = shard[slot % JUMLAH_SHARD];
+        lock_guard<mutex> lk(sh.m);
+        return ujung[slot].kepala == KOSONG;
+    }
+};
+
+// ===========================
+// RIWAYAT PINJAMAN PER MEMBER (KOLOM DELTA)
+// ===========================
+// tiap pinjaman yang udah balik dicatat ke riwayat member yang ngembaliin:
+// slot item, hari balik, hari telat, denda. record-nya append-only ke
+// POTONGAN (chunk) punya member itu, dan di dalem potongan tiap field punya
+// kolom sendiri berisi varint - slot & hari disimpen selisih zigzag dari
+// record sebelumnya, telat 1 byte (+ bit "ada denda"), denda cuma ditulis
+// kalo ga nol. header potongan nyimpen rentang hari + total jumlah/telat/denda,
+// jadi agregat rentang cuma decode potongan yang kepotong batas rentang, dan
+// hitung per tipe cuma decode kolom slot + hari.
+// potongan satu member dirantai mundur, ukurannya 32 byte dulu terus dobel
+// sampe 512 biar member yang jarang minjem ga buang tempat. pembagian area
+// per kolom ngikutin pemakaian potongan sebelumnya (item acak = kolom slot
+// gendut, member yang rajin balikin = kolom denda kurus). ringkasan per member
+// (jumlah per tipe, telat, denda) di-update tiap catat, jadi top-K sepanjang
+// masa ga decode sama sekali.
+// dipecah per shard (slot member % JUMLAH_SHARD), satu arena byte per shard
+class RiwayatPinjaman {
+public:
+    static constexpr uint32_t KOSONG = UINT32_MAX;
+    static constexpr int32_t AWAL_WAKTU = INT32_MIN;
+    static constexpr int32_t AKHIR_WAKTU = INT32_MAX;
+
+    struct Record {
+        uint32_t slotItem;
+        int32_t hari;        // hari balik
+        uint32_t hariTelat;
+        uint32_t denda;      // rupiah
+    };
+
+    struct Agregat {
+        uint64_t jumlah = 0;
+        uint64_t telat = 0;
+        uint64_t denda = 0;
+
+        double rasioTelat() const { return jumlah ? 100.0 * telat / jumlah : 0.0; }
+    };
+
+    struct Peringkat {
+        uint32_t slotMember;
+        uint64_t jumlah;
+    };
+
+private:
+    static constexpr size_t JUMLAH_SHARD = 16;
+    static constexpr uint8_t KELAS_MAKS = 4;  // area data 32 << kelas byte
+    static constexpr uint32_t UNIT = 4;       // kolom dibagi per 4 byte
+    enum Kolom { K_SLOT, K_HARI, K_TELAT, K_DENDA, JUMLAH_KOLOM };
+    // kolom yang perlu di-decode; hari selalu (buat filter rentang)
+    enum : uint8_t { BUTUH_SLOT = 1, BUTUH_TELAT = 2 };
+
+    struct Header {
+        uint64_t denda;
+        uint32_t sebelum;  // potongan sebelumnya punya member yang sama
+        int32_t hariAwal;  // hari record pertama = dasar delta
+        int32_t hariAkhir;
+        uint16_t n;
+        uint16_t nTelat;
+        uint16_t pakai[JUMLAH_KOLOM];  // byte terpakai per kolom
+        uint8_t awal[JUMLAH_KOLOM];    // awal kolom, dalam UNIT
+        uint8_t kelas;
+    };
+
+    struct Ringkasan {
+        uint32_t potongan = KOSONG;  // potongan yang lagi diisi
+        uint32_t slotTerakhir = 0;
+        int32_t hariTerakhir = 0;
+        uint32_t jumlah = 0;
+        uint32_t telat = 0;
+        bool urut = true;  // hari ga pernah mundur -> rantai bisa berhenti lebih awal
+        uint64_t denda = 0;
+        array<uint32_t, JUMLAH_KODE_TIPE> perTipe{};
+    };
+
+    struct alignas(64) Shard {
+        mutable mutex m;
+        vector<uint8_t> arena;
+    };
+
+    vector<Ringkasan> ringkasan;  // per slot member - cuma tumbuh pas lock struktur exclusive
+    array<Shard, JUMLAH_SHARD> shard;
+
+    static uint32_t kapasitas(uint8_t kelas) { return 32u << kelas; }
+
+    static uint32_t batas(const Header& h, int k) {
+        uint32_t akhir = k + 1 < JUMLAH_KOLOM ? h.awal[k + 1] : kapasitas(h.kelas) / UNIT;
+        return (akhir - h.awal[k]) * UNIT;
+    }
+
+    // tiap kolom minimal 1 UNIT, sisanya dibagi sebanding `bobot`
+    static void bagiKolom(Header& h, const uint32_t* bobot) {
+        uint32_t unit = kapasitas(h.kelas) / UNIT, total = 0, terpakai = 0;
+        uint32_t bagian[JUMLAH_KOLOM];
+        for (int k = 0; k < JUMLAH_KOLOM; k++) total += bobot[k];
+        for (int k = 0; k < JUMLAH_KOLOM; k++) {
+            bagian[k] = 1 + (unit - JUMLAH_KOLOM) * bobot[k] / total;
+            terpakai += bagian[k];
+        }
+        bagian[K_SLOT] += unit - terpakai;
+        h.awal[0] = 0;
+        for (int k = 1; k < JUMLAH_KOLOM; k++) h.awal[k] = static_cast<uint8_t>(h.awal[k - 1] + bagian[k - 1]);
+    }
+
+    static uint64_t zigzag(int64_t v) { return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63); }
+    static int64_t unzigzag(uint64_t v) { return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1); }
+
+    static uint8_t tulisVarint(uint8_t* p, uint64_t v) {
+        uint8_t n = 0;
+        while (v >= 0x80) {
+            p[n++] = static_cast<uint8_t>(v | 0x80);
+            v >>= 7;
+        }
+        p[n++] = static_cast<uint8_t>(v);
+        return n;
+    }
+
+    static uint64_t bacaVarint(const uint8_t*& p) {
+        uint64_t v = *p++;
+        if (v < 0x80) return v;
+        v &= 0x7F;
+        for (int geser = 7;; geser += 7) {
+            uint8_t b = *p++;
+            v |= uint64_t(b & 0x7F) << geser;
+            if (!(b & 0x80)) return v;
+        }
+    }
+
+    static void lewatiVarint(const uint8_t*& p) {
+        while (*p++ & 0x80) {}
+    }
+
+    static Header bacaHeader(const Shard& sh, uint32_t off) {
+        Header h;
+        memcpy(&h, sh.arena.data() + off, sizeof(h));
+        return h;
+    }
+
+    static void tulisHeader(Shard& sh, uint32_t off, const Header& h) {
+        memcpy(sh.arena.data() + off, &h, sizeof(h));
+    }
+
+    // decode record satu potongan urut lama -> baru. kolom yang ga `butuh`
+    // ga disentuh (nilainya 0 di record)
+    template <typename F>
+    static void decode(const Shard& sh, uint32_t off, const Header& h, uint8_t butuh, F&& f) {
+        const uint8_t* data = sh.arena.data() + off + sizeof(Header);
+        const uint8_t* kolom[JUMLAH_KOLOM];
+        for (int k = 0; k < JUMLAH_KOLOM; k++) kolom[k] = data + h.awal[k] * UNIT;
+        Record r{0, h.hariAwal, 0, 0};
+        for (uint16_t i = 0; i < h.n; i++) {
+            if (butuh & BUTUH_SLOT) r.slotItem = static_cast<uint32_t>(r.slotItem + unzigzag(bacaVarint(kolom[K_SLOT])));
+            r.hari = static_cast<int32_t>(r.hari + unzigzag(bacaVarint(kolom[K_HARI])));
+            if (butuh & BUTUH_TELAT) {
+                uint64_t t = bacaVarint(kolom[K_TELAT]);
+                r.hariTelat = static_cast<uint32_t>(t >> 1);
+                r.denda = t & 1 ? static_cast<uint32_t>(bacaVarint(kolom[K_DENDA])) : 0;
+            }
+            f(r);
+        }
+    }
+
+    // potongan member yang nyentuh [dari, sampai], urut baru -> lama
+    template <typename F>
+    void jelajahPotongan(const Shard& sh, uint32_t slotMember, int32_t dari, int32_t sampai, F&& f) const {
+        const Ringkasan& r = ringkasan[slotMember];
+        if (r.urut && r.hariTerakhir < dari) return;
+        for (uint32_t off = r.potongan; off != KOSONG;) {
+            Header h = bacaHeader(sh, off);
+            if (h.hariAkhir < dari && r.urut) break;
+            if (h.hariAkhir >= dari && h.hariAwal <= sampai) f(off, h);
+            // hari urut: potongan yang lebih tua selesai paling telat di hariAwal yang ini
+            if (h.hariAwal < dari && r.urut) break;
+            off = h.sebelum;
+        }
+    }
+
+    static bool semuaWaktu(int32_t dari, int32_t sampai) { return dari == AWAL_WAKTU && sampai == AKHIR_WAKTU; }
+
+    // jumlah pinjaman satu member di rentang (+ filter tipe, 0 = semua).
+    // potongan yang rentangnya ketutup penuh ga perlu di-decode
+    template <typename TagFn>
+    uint64_t hitungLokal(const Shard& sh, uint32_t slotMember, int32_t dari, int32_t sampai, uint8_t kode,
+                         const TagFn& tag) const {
+        const Ringkasan& r = ringkasan[slotMember];
+        if (semuaWaktu(dari, sampai)) return kode == 0 ? r.jumlah : r.perTipe[kode];
+        uint64_t n = 0;
+        jelajahPotongan(sh, slotMember, dari, sampai, [&](uint32_t off, const Header& h) {
+            if (kode == 0 && h.hariAwal >= dari && h.hariAkhir <= sampai) {
+                n += h.n;
+                return;
+            }
+            decode(sh, off, h, kode ? BUTUH_SLOT : 0, [&](const Record& rec) {
+                n += rec.hari >= dari && rec.hari <= sampai && (kode == 0 || tag(rec.slotItem) == kode);
+            });
+        });
+        return n;
+    }
+
+    template <typename TagFn>
+    void agregatLokal(const Shard& sh, uint32_t slotMember, int32_t dari, int32_t sampai, uint8_t kode,
+                      const TagFn& tag, Agregat& a) const {
+        const Ringkasan& r = ringkasan[slotMember];
+        if (kode == 0 && semuaWaktu(dari, sampai)) {
+            a.jumlah += r.jumlah;
+            a.telat += r.telat;
+            a.denda += r.denda;
+            return;
+        }
+        jelajahPotongan(sh, slotMember, dari, sampai, [&](uint32_t off, const Header& h) {
+            if (kode == 0 && h.hariAwal >= dari && h.hariAkhir <= sampai) {
+                a.jumlah += h.n;
+                a.telat += h.nTelat;
+                a.denda += h.denda;
+                return;
+            }
+            decode(sh, off, h, BUTUH_TELAT | (kode ? BUTUH_SLOT : 0), [&](const Record& rec) {
+                if (rec.hari < dari || rec.hari > sampai || (kode != 0 && tag(rec.slotItem) != kode)) return;
+                a.jumlah++;
+                a.telat += rec.hariTelat > 0;
+                a.denda += rec.denda;
+            });
+        });
+    }
+
+public:
+    void tambahMember() { ringkasan.emplace_back(); }
+    void reserve(size_t nMember) { ringkasan.reserve(nMember); }
+
+    void clear() {
+        ringkasan.clear();
+        for (Shard& sh : shard) {
+            lock_guard<mutex> lk(sh.m);
+            sh.arena.clear();
+        }
+    }
+
+    void catat(uint32_t slotMember, uint32_t slotItem, uint8_t kode, int32_t hari, uint32_t hariTelat,
+               double denda) {
+        uint32_t rupiah = static_cast<uint32_t>(min(max(denda, 0.0), 4e9) + 0.5);
+        Shard& sh = shard[slotMember % JUMLAH_SHARD];
+        lock_guard<mutex> lk(sh.m);
+        Ringkasan& r = ringkasan[slotMember];
+
+        uint8_t enc[JUMLAH_KOLOM][10];
+        uint32_t len[JUMLAH_KOLOM];
+        auto siapkan = [&](uint32_t slotDasar, int32_t hariDasar) {
+            len[K_SLOT] = tulisVarint(enc[K_SLOT], zigzag(int64_t(slotItem) - slotDasar));
+            len[K_HARI] = tulisVarint(enc[K_HARI], zigzag(int64_t(hari) - hariDasar));
+            len[K_TELAT] = tulisVarint(enc[K_TELAT], (uint64_t(hariTelat) << 1) | (rupiah != 0));
+            len[K_DENDA] = rupiah ? tulisVarint(enc[K_DENDA], rupiah) : 0;
+        };
+
+        uint32_t off = r.potongan;
+        Header h{};
+        bool baru = true;
+        if (off != KOSONG) {
+            h = bacaHeader(sh, off);
+            siapkan(r.slotTerakhir, r.hariTerakhir);
+            // hari mundur dari awal potongan = potongan baru, biar hariAwal tetep dasar delta
+            baru = h.n == UINT16_MAX || hari < h.hariAwal;
+            for (int k = 0; k < JUMLAH_KOLOM && !baru; k++) baru = h.pakai[k] + len[k] > batas(h, k);
+        }
+        if (baru) {
+            uint32_t bobot[JUMLAH_KOLOM] = {9, 3, 3, 1};
+            if (off != KOSONG) {
+                for (int k = 0; k < JUMLAH_KOLOM; k++) bobot[k] = h.pakai[k] + len[k];
+            }
+            uint8_t kelas = off == KOSONG ? 0 : static_cast<uint8_t>(min<int>(KELAS_MAKS, h.kelas + 1));
+            uint32_t sebelum = off;
+            off = static_cast<uint32_t>(sh.arena.size());
+            sh.arena.resize(sh.arena.size() + sizeof(Header) + kapasitas(kelas));
+            h = Header{};
+            h.sebelum = sebelum;
+            h.hariAwal = h.hariAkhir = hari;
+            h.kelas = kelas;
+            bagiKolom(h, bobot);
+            siapkan(0, hari);
+            r.potongan = off;
+        }
+
+        uint8_t* data = sh.arena.data() + off + sizeof(Header);
+        for (int k = 0; k < JUMLAH_KOLOM; k++) {
+            memcpy(data + h.awal[k] * UNIT + h.pakai[k], enc[k], len[k]);
+            h.pakai[k] = static_cast<uint16_t>(h.pakai[k] + len[k]);
+        }
+        h.n++;
+        h.nTelat += hariTelat > 0;
+        h.denda += rupiah;
+        h.hariAkhir = max(h.hariAkhir, hari);
+        tulisHeader(sh, off, h);
+
+        if (r.jumlah && hari < r.hariTerakhir) r.urut = false;
+        r.slotTerakhir = slotItem;
+        r.hariTerakhir = hari;
+        r.jumlah++;
+        r.telat += hariTelat > 0;
+        r.denda += rupiah;
+        if (kode < JUMLAH_KODE_TIPE) r.perTipe[kode]++;
+    }
+
+    // kunjungi record satu member yang hari baliknya di [dari, sampai],
+    // urut lama -> baru. potongan di luar rentang dilewatin dari header-nya
+    template <typename F>
+    void jelajah(uint32_t slotMember, int32_t dari, int32_t sampai, F&& f) const {
+        const Shard& sh = shard[slotMember % JUMLAH_SHARD];
+        lock_guard<mutex> lk(sh.m);
+        uint32_t potongan[64];
+        vector<uint32_t> sisa;  // member super rajin, rantainya kepanjangan
+        size_t n = 0;
+        jelajahPotongan(sh, slotMember, dari, sampai, [&](uint32_t off, const Header&) {
+            if (n < size(potongan)) potongan[n++] = off;
+            else sisa.push_back(off);
+        });
+        auto kunjungi = [&](uint32_t off) {
+            decode(sh, off, bacaHeader(sh, off), BUTUH_SLOT | BUTUH_TELAT, [&](const Record& rec) {
+                if (rec.hari >= dari && rec.hari <= sampai) f(rec);
+            });
+        };
+        for (auto it = sisa.rbegin(); it != sisa.rend(); ++it) kunjungi(*it);
+        while (n > 0) kunjungi(potongan[--n]);
+    }
+
+    vector<Record> ambil(uint32_t slotMember, int32_t dari = AWAL_WAKTU, int32_t sampai = AKHIR_WAKTU) const {
+        vector<Record> hasil;
+        jelajah(slotMember, dari, sampai, [&](const Record& rec) { hasil.push_back(rec); });
+        return hasil;
+    }
+
+    template <typename TagFn>
+    Agregat agregatMember(uint32_t slotMember, int32_t dari, int32_t sampai, uint8_t kode, const TagFn& tag) const {
+        const Shard& sh = shard[slotMember % JUMLAH_SHARD];
+        lock_guard<mutex> lk(sh.m);
+        Agregat a;
+        agregatLokal(sh, slotMember, dari, sampai, kode, tag, a);
+        return a;
+    }
+
+    // total satu populasi - jumlah, yang telat, denda. tiap shard dihitung
+    // sendiri2 di `kolam` (lock-nya juga per shard), terus dijumlah
+    template <typename TagFn>
+    Agregat agregat(int32_t dari, int32_t sampai, uint8_t kode, const TagFn& tag,
+                    KolamParalel& kolam = kolamParalel()) const {
+        auto peta = [&](size_t awal, size_t akhir) {
+            Agregat a;
+            for (size_t s = awal; s < akhir; s++) {
+                const Shard& sh = shard[s];
+                lock_guard<mutex> lk(sh.m);
+                for (size_t m = s; m < ringkasan.size(); m += JUMLAH_SHARD) {
+                    agregatLokal(sh, static_cast<uint32_t>(m), dari, sampai, kode, tag, a);
+                }
+            }
+            return a;
+        };
+        auto gabung = [](Agregat x, const Agregat& y) {
+            x.jumlah += y.jumlah;
+            x.telat += y.telat;
+            x.denda += y.denda;
+            return x;
+        };
+        return kolam.reduksi(JUMLAH_SHARD, 1, Agregat{}, peta, gabung);
+    }
+
+    // k member yang paling banyak minjem (tipe `kode`, 0 = semua) di rentang.
+    // min-heap ukuran k, jadi O(member log k) + decode seperlunya. tiap
+    // potongan shard punya heap sendiri di `kolam`, terus heap-nya digabung.
+    // juru kunci heap yang udah penuh dibagi lewat `ambang` - buat semua
+    // potongan itu batas bawah peringkat k, jadi aman buat motong
+    template <typename TagFn>
+    vector<Peringkat> top(size_t k, uint8_t kode, int32_t dari, int32_t sampai, const TagFn& tag,
+                          KolamParalel& kolam = kolamParalel()) const {
+        auto lebihBaik = [](const Peringkat& a, const Peringkat& b) {
+            return a.jumlah != b.jumlah ? a.jumlah > b.jumlah : a.slotMember < b.slotMember;
+        };
+        auto masuk = [&](vector<Peringkat>& heap, const Peringkat& p) {
+            if (heap.size() < k) {
+                heap.push_back(p);
+                push_heap(heap.begin(), heap.end(), lebihBaik);
+            } else if (lebihBaik(p, heap.front())) {
+                pop_heap(heap.begin(), heap.end(), lebihBaik);
+                heap.back() = p;
+                push_heap(heap.begin(), heap.end(), lebihBaik);
+            }
+        };
+        if (k == 0) return {};
+        atomic<uint64_t> ambang{0};
+        auto peta = [&](size_t awal, size_t akhir) {
+            vector<Peringkat> heap;
+            for (size_t s = awal; s < akhir; s++) {
+                const Shard& sh = shard[s];
+                lock_guard<mutex> lk(sh.m);
+                for (size_t m = s; m < ringkasan.size(); m += JUMLAH_SHARD) {
+                    // member yang total sepanjang masanya aja ga nyampe juru kunci heap ga usah dihitung
+                    uint32_t batasAtas = kode ? ringkasan[m].perTipe[kode] : ringkasan[m].jumlah;
+                    if (batasAtas == 0 || batasAtas < ambang.load(memory_order_relaxed)) continue;
+                    if (heap.size() == k && batasAtas < heap.front().jumlah) continue;
+                    Peringkat p{static_cast<uint32_t>(m), hitungLokal(sh, static_cast<uint32_t>(m), dari, sampai, kode, tag)};
+                    if (p.jumlah == 0) continue;
+                    masuk(heap, p);
+                    if (heap.size() < k) continue;
+                    uint64_t lama = ambang.load(memory_order_relaxed);
+                    while (heap.front().jumlah > lama && !ambang.compare_exchange_weak(lama, heap.front().jumlah)) {
+                    }
+                }
+            }
+            return heap;
+        };
+        auto gabung = [&](vector<Peringkat> x, const vector<Peringkat>& y) {
+            for (const Peringkat& p : y) masuk(x, p);
+            return x;
+        };
+        vector<Peringkat> heap = kolam.reduksi(JUMLAH_SHARD, 1, vector<Peringkat>{}, peta, gabung);
+        sort(heap.begin(), heap.end(), lebihBaik);
+        return heap;
+    }
+
+    uint32_t jumlahMember(uint32_t slotMember) const {
+        const Shard& sh = shard[slotMember % JUMLAH_SHARD];
+        lock_guard<mutex> lk(sh.m);
+        return ringkasan[slotMember].jumlah;
+    }
+
+    struct Memori {
+        uint64_t record;
+        size_t byteArena;
+        size_t byteRingkasan;
+    };
+
+    Memori memori() const {
+        Memori m{0, 0, ringkasan.size() * sizeof(Ringkasan)};
+        for (size_t s = 0; s < JUMLAH_SHARD; s++) {
+            lock_guard<mutex> lk(shard[s].m);
+            m.byteArena += shard[s].arena.size();
+            for (size_t i = s; i < ringkasan.size(); i += JUMLAH_SHARD) m.record += ringkasan[i].jumlah;
+        }
+        return m;
+    }
+};
+
+// ===========================
+// VERSI LAMA BUAT POTRET (COPY-ON-WRITE)
+// ===========================
+// potret = tampilan katalog/member satu titik waktu buat laporan, ekspor,
+// backup. bikinnya O(1) - cuma naikin epoch pas gerbang sirkulasi ditutup.
+// abis itu transaksi jalan terus, tapi sebelum NGUBAH item/member yang
+// belum disalin buat potret terbaru, versi lamanya disalin dulu (KeadaanItem
+// dari kolom / copy Member) ke sini. potret epoch E baca slot: versi lama
+// pertama yang epoch-nya >= E kalo ada, kalo ga nilai hidupnya (berarti belum
+// diubah sejak potret dibikin). baca + salin dijaga lock shard yang sama, jadi
+// pembaca ga pernah ngeliat nilai hidup lagi setengah diubah.
+// selama ga ada potret hidup, ongkos ke jalur transaksi cuma satu load atomik
+template <typename T>
+class VersiLama {
+private:
+    static constexpr size_t JUMLAH_SHARD = 64;
+
+    struct Versi {
+        uint32_t epoch;  // potret terbaru waktu disalin
+        shared_ptr<const T> isi;
+    };
+
+    struct alignas(64) Shard {
+        mutable mutex m;
+        unordered_map<uint32_t, vector<Versi>> peta;  // slot -> versi lama, epoch naik
+    };
+
+    array<Shard, JUMLAH_SHARD> shard;
+    // per slot: epoch potret terakhir yang udah dapet salinan. deque biar
+    // nambah slot ga mindahin atomic yang udah ada (lock struktur exclusive)
+    deque<atomic<uint32_t>> epochSalin;
+
+public:
+    void tambahSlot(uint32_t epochSekarang) { epochSalin.emplace_back(epochSekarang); }
+
+    void clear() {
+        epochSalin.clear();
+        buang();
+    }
+
+    // ga ada potret hidup lagi - semua versi lama boleh dibuang
+    void buang() {
+        for (Shard& sh : shard) {
+            lock_guard<mutex> lk(sh.m);
+            sh.peta.clear();
+        }
+    }
+
+    // potret tertua yang masih hidup = `epochTertua`. versi yang epoch-nya di
+    // bawah itu ga bakal kepilih siapa2 lagi (baca nyari epoch >= potret)
+    void buangSebelum(uint32_t epochTertua) {
+        for (Shard& sh : shard) {
+            lock_guard<mutex> lk(sh.m);
+            for (auto it = sh.peta.begin(); it != sh.peta.end();) {
+                vector<Versi>& v = it->second;
+                auto batas = find_if(v.begin(), v.end(), [&](const Versi& x) { return x.epoch >= epochTertua; });
+                v.erase(v.begin(), batas);
+                it = v.empty() ? sh.peta.erase(it) : next(it);
+            }
+        }
+    }
+
+    // dipanggil SEBELUM objek di `slot` diubah. epochHidup = epoch potret
+    // terbaru yang masih hidup (0 = ga ada). `salin` bikin shared_ptr<const T>
+    template <typename Salin>
+    void sebelumUbah(uint32_t slot, uint32_t epochHidup, const T& obj, Salin&& salin) {
+        if (epochHidup == 0 || epochSalin[slot].load(memory_order_acquire) >= epochHidup) return;
+        Shard& sh = shard[slot % JUMLAH_SHARD];
+        lock_guard<mutex> lk(sh.m);
+        if (epochSalin[slot].load(memory_order_relaxed) >= epochHidup) return;  // keduluan thread lain
+        sh.peta[slot].push_back(Versi{epochHidup, salin(obj)});
+        epochSalin[slot].store(epochHidup, memory_order_release);
+    }
+
+    // panggil f(versi slot waktu potret `epoch` dibikin). `hidup()` baca nilai
+    // hidupnya - dipanggil di dalem lock shard juga. lock-nya dipegang selama
+    // f, jadi f-nya harus pendek (nulis satu baris)
+    template <typename Hidup, typename F>
+    void baca(uint32_t slot, uint32_t epoch, Hidup&& hidup, F&& f) const {
+        const Shard& sh = shard[slot % JUMLAH_SHARD];
+        lock_guard<mutex> lk(sh.m);
+        auto it = sh.peta.find(slot);
+        if (it != sh.peta.end()) {
+            for (const Versi& v : it->second) {
+                if (v.epoch >= epoch) {
+                    f(*v.isi);
+                    return;
+                }
+            }
+        }
+        f(hidup());
+    }
+
+    size_t jumlahVersi() const {
+        size_t n = 0;
+        for (const Shard& sh : shard) {
+            lock_guard<mutex> lk(sh.m);
+            for (const auto& pair : sh.peta) n += pair.second.size();
+        }
+        return n;
+    }
+};
+
+// ===========================
+// GERBANG SIRKULASI (HANDSHAKE POTRET)
+// ===========================
+// tiap transaksi sirkulasi (satu pinjam/kembali/reservasi, atau satu batch
+// utuh) lewat sini. potret nutup gerbangnya sebentar: transaksi baru nunggu,
+// yang lagi jalan dibiarin kelar, epoch dinaikin + statistik disalin, terus
+// dibuka lagi. beda sama lock exclusive, nutupnya ga nunggu potret lain yang
+// lagi hidup, dan yang nutup didahuluin dari transaksi baru (ga bisa kelaparan).
+// ongkos ke transaksi: satu fetch_add/fetch_sub di counter bergaris per thread
+class GerbangSirkulasi {
+private:
+    static constexpr size_t JUMLAH_GARIS = 16;
+
+    struct alignas(64) Garis {
+        atomic<int> aktif{0};
+    };
+
+    array<Garis, JUMLAH_GARIS> garis;
+    atomic<bool> tutup{false};
+    mutex m;
+    condition_variable cv;
+    mutex mtxPenutup;  // satu penutup sekali jalan
+
+    Garis& garisSaya() {
+        static atomic<size_t> berikutnya{0};
+        thread_local size_t idx = berikutnya++ % JUMLAH_GARIS;
+        return garis[idx];
+    }
+
+    bool semuaKeluar() const {
+        for (const Garis& g : garis) {
+            if (g.aktif.load() != 0) return false;
+        }
+        return true;
+    }
+
+    void keluarDari(Garis& g) {
+        // yang terakhir keluar pas gerbang lagi ditutup bangunin penutupnya
+        if (g.aktif.fetch_sub(1) == 1 && tutup.load()) {
+            lock_guard<mutex> lk(m);
+            cv.notify_all();
+        }
+    }
+
+public:
+    // pegangan satu transaksi - keluar otomatis pas scope-nya abis
+    class Tiket {
+    private:
+        GerbangSirkulasi& gerbang;
+        Garis& g;
+
+    public:
+        explicit Tiket(GerbangSirkulasi& gerbang) : gerbang(gerbang), g(gerbang.garisSaya()) {
+            for (;;) {
+                g.aktif.fetch_add(1);
+                if (!gerbang.tutup.load()) return;
+                gerbang.keluarDari(g);
+                unique_lock<mutex> lk(gerbang.m);
+                gerbang.cv.wait(lk, [&] { return !gerbang.tutup.load(); });
+            }
+        }
+        ~Tiket() { gerbang.keluarDari(g); }
+
+        Tiket(const Tiket&) = delete;
+        Tiket& operator=(const Tiket&) = delete;
+    };
+
+    // jalanin f() pas ga ada transaksi sirkulasi yang lagi jalan. jangan
+    // dipanggil dari thread yang lagi megang Tiket - deadlock
+    template <typename F>
+    void tutupSebentar(F&& f) {
+        lock_guard<mutex> lkPenutup(mtxPenutup);
+        tutup.store(true);
+        {
+            unique_lock<mutex> lk(m);
+            cv.wait(lk, [&] { return semuaKeluar(); });
+        }
+        f();
+        {
+            lock_guard<mutex> lk(m);
+            tutup.store(false);
+        }
+        cv.notify_all();
+    }
+};
+
+// ===========================
+// KELAS PERPUSTAKAAN (MAIN SYSTEM)
+// ===========================
+class Perpustakaan {
+private:
+    // mode arena (opsional): objek + teks Member yang dibikin Perpustakaan
+    // ditaro di sini. dideklarasi paling awal biar matinya paling akhir
+    unique_ptr<ArenaMemori> arena;
+
+    vector<unique_ptr<Member>> daftarMember;
+
+    // semua data item, per slot (slot = urutan masuk, ga ikut ke-sort jadi
+    // indeks tetep valid). Item = tampilan ke sini, ga ada objek per item
+    KatalogKolom kolom;
+    TabelPinjaman pinjamanAktif;  // siapa minjem apa + jatuh temponya, per eksemplar
+    AntreanReservasi reservasi;   // antrean FIFO per slot item
+    RiwayatPinjaman riwayat;      // pinjaman yang udah balik, per slot member
+    IndeksCari indeksCari;        // kata judul/penulis/sutradara -> slot
+    // katalog urut ID/judul/tipe, ga pernah sort ulang. abis bulk load
+    // (snapshot, impor) indeksnya ditunda, dibangun sekali pas pertama dipake
+    mutable IndeksUrut<BandingId> urutId;
+    mutable IndeksUrut<BandingJudul> urutJudul;
+    mutable IndeksUrut<BandingTipe> urutTipe;
+    mutable atomic<bool> urutTertunda;
+    mutable mutex mtxUrut;
+    UrutKatalog urutTampil;       // urutan tampilKatalog, jadi ID abis menu sort
+    vector<Member*> memberPerSlot;
+    IndeksHash<Item> indeksItem;
+    IndeksHash<Member> indeksMember;
+    
+    // statistik bulanan - buat laporan
+    StatistikBulanan statistik;
+
+    // riwayat per hari/bulan/tipe + arsip tiap kali statistik bulanan di-reset
+    MesinLaporan laporan;
+    vector<ArsipPeriode> arsip;
+    int32_t hariMulaiPeriode;
+
+    // sumber "hari ini" - default jam sistem, bisa diganti (tes, simulasi).
+    // pas replay log, harinya diambil dari record biar hasilnya sama persis
+    function<int32_t()> jam;
+    int32_t hariReplay;
+
+    int32_t hariTransaksi() const { return sedangReplay ? hariReplay : jam(); }
+
+    // record lama belum punya field hari di ekornya - pake hari ini aja
+    void bacaHariRecord(PembacaBiner& in) {
+        hariReplay = in.sisa() >= sizeof(int32_t) ? in.baca<int32_t>() : jam();
+    }
+
+    // thread safety: proses pinjam/kembali cukup shared lock (bisa barengan),
+    // yang ngubah struktur katalog/member baru exclusive. item dijaga CAS di
+    // kata status kolom, counter member dijaga lock bergaris per member
+    mutable shared_mutex mtxStruktur;
+    struct alignas(64) KunciGaris {
+        mutex m;
+    };
+    static constexpr size_t JUMLAH_GARIS = 64;
+    array<KunciGaris, JUMLAH_GARIS> kunciMember;
+
+    // kunci bergaris per slot item. urutannya selalu kunci item dulu, baru
+    // kunci member. CAS status, entri jatuh tempo, serah-terima ke antrean
+    // sama record WAL-nya jalan di satu critical section, jadi urutan LSN
+    // per item (dan per member) = urutan kejadiannya - replay ga nyimpang
+    array<KunciGaris, JUMLAH_GARIS> kunciItem;
+
+    mutex& kunciUntuk(const Member* member) {
+        return kunciMember[(reinterpret_cast<uintptr_t>(member) >> 6) % JUMLAH_GARIS].m;
+    }
+
+    mutex& kunciItemUntuk(uint32_t slot) { return kunciItem[slot % JUMLAH_GARIS].m; }
+
+    // kunci member yang balikin + kunci kepala antrean yang bakal nerima
+    // eksemplarnya (kalo ada). diambil bareng lewat std::lock - dua `kembali`
+    // yang penerimanya saling silang ga deadlock - dan yang segaris cuma sekali
+    struct KunciDuaMember {
+        unique_lock<mutex> a, b;
+        KunciDuaMember(mutex& ma, mutex* mb) : a(ma, defer_lock) {
+            if (mb && mb != &ma) {
+                b = unique_lock<mutex>(*mb, defer_lock);
+                std::lock(a, b);
+            } else {
+                a.lock();
+            }
+        }
+    };
+
+    // kunci member kepala antrean judul ini, nullptr kalo antreannya kosong.
+    // kunci item-nya harus udah dipegang biar kepalanya ga ganti
+    mutex* kunciPenerima(uint32_t slot) {
+        uint32_t kepala = reservasi.kepala(slot);
+        return kepala == AntreanReservasi::KOSONG ? nullptr : &kunciUntuk(memberPerSlot[kepala]);
+    }
+
+    // potret copy-on-write (lihat VersiLama). epochTerakhir cuma naik pas
+    // gerbang sirkulasi ditutup (ato lock struktur exclusive), epochHidup =
+    // epoch potret terbaru yang masih dipegang
+    mutable VersiLama<KeadaanItem> versiItem;
+    mutable VersiLama<Member> versiMember;
+    mutable GerbangSirkulasi gerbang;
+    mutable uint32_t epochTerakhir = 0;
+    mutable atomic<uint32_t> epochHidup{0};
+    mutable mutex mtxPotret;
+    mutable vector<uint32_t> potretHidup;
+    uint32_t generasi = 0;  // naik tiap kosongkan (muat snapshot, recovery), 6 bit bawahnya masuk handle
+
+    // wajib dipanggil sebelum status item / counter member diubah
+    void sebelumUbah(uint32_t slot, const Item& item) {
+        versiItem.sebelumUbah(slot, epochHidup.load(memory_order_acquire), item.keadaan(),
+                              [](const KeadaanItem& k) { return make_shared<const KeadaanItem>(k); });
+    }
+
+    void sebelumUbah(uint32_t slotMember, const Member& member) {
+        versiMember.sebelumUbah(slotMember, epochHidup.load(memory_order_acquire), member,
+                                [](const Member& m) { return make_shared<const Member>(m); });
+    }
+
+    static constexpr uint32_t MAGIC_SNAPSHOT = 0x53505250;  // "PRPS"
+    // v2: nambah lsn terakhir, v3: riwayat laporan, v4: pinjaman aktif,
+    // v5: antrean reservasi (jumlah eksemplar ikut di byte status item),
+    // v6: riwayat pinjaman per member
+    static constexpr uint32_t VERSI_SNAPSHOT = 6;
+
+    // tujuan semua event - default no-op, menu masang SinkTeks ke cout
+    EventSink* sink;
+    bool sinkAktif;
+
+    static EventSink& sinkNoop() {
+        static SinkNoop noop;
+        return noop;
+    }
+
+    void kirim(const Event& ev) {
+        if (sinkAktif) sink->terima(ev);
+    }
+
+    // kolam buat kerjaan sekatalog (indeks urut, validasi batch/impor,
+    // agregat riwayat). nullptr = kolam bawaan
+    KolamParalel* kolam = nullptr;
+
+    KolamParalel& paralel() const { return kolam ? *kolam : kolamParalel(); }
+
+    // write-ahead log - nullptr kalo ga diaktifin
+    unique_ptr<LogTransaksi> wal;
+    atomic<uint64_t> lsnTerakhir;  // nomor urut transaksi terakhir yang udah diterapin
+    bool sedangReplay;
+
+    // kasih nomor urut ke transaksi yang sukses, terus catat ke log.
+    // kalo log-nya rusak record-nya ditolak - keliatan lewat logRusak()
+    template <typename F>
+    void catat(LogTransaksi::Jenis jenis, F&& isi) {
+        if (wal && !sedangReplay) wal->catat(lsnTerakhir, jenis, isi);
+        else lsnTerakhir++;
+    }
+
+    // terapin ulang satu record log ke state sekarang
+    void terapkanRecord(LogTransaksi::Jenis jenis, PembacaBiner& in) {
+        switch (jenis) {
+            case LogTransaksi::TAMBAH_ITEM: {
+                DataItem data;
+                if (DataItem::bacaDari(in, data)) tambahItem(data);
+                break;
+            }
+            case LogTransaksi::REGISTER_MEMBER: {
+                auto member = Member::bacaDari(in);
+                if (member) registerMember(move(member));
+                break;
+            }
+            case LogTransaksi::PINJAM: {
+                string idMember(in.bacaString());
+                string idItem(in.bacaString());
+                int hari = in.baca<int32_t>();
+                bool pakeKredit = in.baca<uint8_t>() != 0;
+                bacaHariRecord(in);
+                if (in.isOk()) prosesPinjam(idMember, idItem, hari, pakeKredit);
+                break;
+            }
+            case LogTransaksi::KEMBALI: {
+                string idMember(in.bacaString());
+                string idItem(in.bacaString());
+                int hariAktual = in.baca<int32_t>();
+                bacaHariRecord(in);
+                if (in.isOk()) prosesKembali(idMember, idItem, hariAktual);
+                break;
+            }
+            case LogTransaksi::KEMBALI_DVD: {
+                string idMember(in.bacaString());
+                string idDVD(in.bacaString());
+                int hariAktual = in.baca<int32_t>();
+                bool rusak = in.baca<uint8_t>() != 0;
+                bacaHariRecord(in);
+                if (in.isOk()) prosesKembaliDVD(idMember, idDVD, hariAktual, rusak);
+                break;
+            }
+            case LogTransaksi::RESET_STATISTIK:
+                bacaHariRecord(in);
+                resetStatistikBulanan();
+                break;
+            case LogTransaksi::RESERVASI: {
+                string idMember(in.bacaString());
+                string idItem(in.bacaString());
+                bacaHariRecord(in);
+                if (in.isOk()) prosesReservasi(idMember, idItem);
+                break;
+            }
+            case LogTransaksi::EKSEMPLAR: {
+                string idItem(in.bacaString());
+                uint32_t total = in.baca<uint32_t>();
+                bacaHariRecord(in);
+                if (in.isOk()) aturEksemplar(idItem, total);
+                break;
+            }
+        }
+    }
+
+    // masukin item ke kolom + indeks tanpa ngeprint, false kalo ID dobel
+    // (barisnya dibatalin lagi). item barunya = slot terakhir kolom
+    bool pasangItem(const DataItem& data) {
+        uint32_t slot = kolom.tambah(data);
+        if (!daftarkanItem(slot)) {
+            kolom.buangTerakhir();
+            return false;
+        }
+        return true;
+    }
+
+    // daftarin slot yang udah ada di kolom ke indeks + tabel per slot
+    bool daftarkanItem(uint32_t slot) {
+        if (!indeksItem.tambah(slot)) return false;
+        indeksCari.tambah(slot, kolom);
+        if (!urutTertunda) {
+            urutId.tambah(slot);
+            urutJudul.tambah(slot);
+            urutTipe.tambah(slot);
+        }
+        pinjamanAktif.tambahSlot(kolom.jumlahEksemplar(slot));
+        reservasi.tambahSlot();
+        versiItem.tambahSlot(epochTerakhir);
+        return true;
+    }
+
+    bool pasangMember(unique_ptr<Member>& member) {
+        memberPerSlot.push_back(member.get());
+        if (!indeksMember.tambah(static_cast<uint32_t>(memberPerSlot.size() - 1))) {
+            memberPerSlot.pop_back();
+            return false;
+        }
+        riwayat.tambahMember();
+        versiMember.tambahSlot(epochTerakhir);
+        daftarMember.push_back(move(member));
+        return true;
+    }
+
+    void kosongkan() {
+        indeksItem.clear();
+        indeksMember.clear();
+        lsnTerakhir = 0;
+        kolom.clear();
+        pinjamanAktif.clear();
+        reservasi.clear();
+        riwayat.clear();
+        versiItem.clear();
+        versiMember.clear();
+        generasi++;
+        indeksCari.clear();
+        urutId.clear();
+        urutJudul.clear();
+        urutTipe.clear();
+        urutTampil = UrutKatalog::MASUK;
+        urutTertunda = false;
+        memberPerSlot.clear();
+        daftarMember.clear();
+        statistik.reset();
+        laporan.clear();
+        arsip.clear();
+    }
+
+    // versi tanpa lock - dipanggil dari method yang udah megang mtxStruktur
+    Item cariItemLokal(string_view id) const {
+        return itemDiSlot(indeksItem.cari(id));
+    }
+
+    // slot dari luar (handle) dicek batasnya sekalian - KOSONG juga lolos ke Item kosong
+    Item itemDiSlot(uint32_t slot) const {
+        return slot < kolom.size() ? kolom.lihat(slot) : Item();
+    }
+
+    Member* cariMemberLokal(string_view id) const {
+        return memberDiSlot(indeksMember.cari(id));
+    }
+
+    Member* memberDiSlot(uint32_t slot) const {
+        return slot < memberPerSlot.size() ? memberPerSlot[slot] : nullptr;
+    }
+
+    // catat pinjaman baru ke tabel jatuh tempo - tempo = hari pinjam + max hari tipe-nya
+    void mulaiPinjaman(uint32_t slot, uint32_t slotMember, const Item& item, int32_t hariIni) {
+        pinjamanAktif.mulai(slot, slotMember, hariIni, hariIni + item.batasHari(), item.tarifDenda());
+    }
+
+    // eksemplar yang udah dijatahin ke antrean (cobaBalikin / setEksemplar)
+    // dipinjemin ke kepala antrean, tempo-nya mulai hari ini. kunci item +
+    // kunci member penerimanya (kunciPenerima) udah harus dipegang
+    uint32_t serahkanTerkunci(uint32_t slot, const Item& item, int32_t hariIni) {
+        uint32_t slotMember = reservasi.ambil(slot);
+        if (slotMember == AntreanReservasi::KOSONG) return slotMember;
+        Member* member = memberPerSlot[slotMember];
+        sebelumUbah(slotMember, *member);
+        member->terimaReservasi();
+        mulaiPinjaman(slot, slotMember, item, hariIni);
+        statistik.catatPinjam(item.kodeTipe(), 1, 0);
+        laporan.catatPinjam(hariIni, item.kodeTipe(), 1, false);
+        return slotMember;
+    }
+
+    // versi buat aturEksemplar (lock struktur exclusive) - cuma ngunci penerimanya
+    uint32_t serahkanKeAntrean(uint32_t slot, const Item& item, int32_t hariIni) {
+        mutex* kunci = kunciPenerima(slot);
+        if (!kunci) return AntreanReservasi::KOSONG;
+        lock_guard<mutex> lkMember(*kunci);
+        return serahkanTerkunci(slot, item, hariIni);
+    }
+
+    // jalan urut `urut` mulai abis slot `setelahSlot` (KURSOR_AWAL = dari depan),
+    // lewatin `lewati` item pertama yang lolos filter, terus panggil f(slot)
+    // sampe f balikin false. tanpa filter, lewati-nya lompat per blok
+    template <typename F>
+    void jelajahUrut(UrutKatalog urut, uint8_t kode, bool hanyaTersedia, size_t lewati,
+                     uint32_t setelahSlot, F&& f) const {
+        bool pakeKursor = setelahSlot != KURSOR_AWAL;
+        if (pakeKursor && setelahSlot >= kolom.size()) return;  // kursor basi / HABIS
+        if (urut != UrutKatalog::MASUK) pastikanUrut();
+        bool tanpaFilter = kode == 0 && !hanyaTersedia;
+        auto kunjungi = [&](uint32_t slot) {
+            if (kode != 0 && kolom.getTag(slot) != kode) return urut != UrutKatalog::TIPE;  // tipe urut = udah lewat
+            if (hanyaTersedia && !kolom.isTersedia(slot)) return true;
+            if (lewati > 0) {
+                lewati--;
+                return true;
+            }
+            return f(slot);
+        };
+        auto mulaiDari = [&](const auto& indeks) {
+            if (pakeKursor) return indeks.setelah(setelahSlot);
+            if (!tanpaFilter) return indeks.awal();
+            auto pos = indeks.posisiKe(lewati);
+            lewati = 0;
+            return pos;
+        };
+
+        switch (urut) {
+            case UrutKatalog::MASUK: {
+                uint32_t slot = pakeKursor ? setelahSlot + 1 : 0;
+                if (tanpaFilter) {
+                    slot = static_cast<uint32_t>(min<size_t>(slot + lewati, kolom.size()));
+                    lewati = 0;
+                }
+                for (; slot < kolom.size(); slot++) {
+                    if (!kunjungi(slot)) return;
+                }
+                break;
+            }
+            case UrutKatalog::ID:
+                urutId.jelajah(mulaiDari(urutId), kunjungi);
+                break;
+            case UrutKatalog::JUDUL:
+                urutJudul.jelajah(mulaiDari(urutJudul), kunjungi);
+                break;
+            case UrutKatalog::TIPE:
+                // langsung loncat ke awal blok tipe-nya (kursor dari tipe lain ga kepake)
+                if (kode == 0 || (pakeKursor && kolom.getTag(setelahSlot) == kode)) {
+                    urutTipe.jelajah(mulaiDari(urutTipe), kunjungi);
+                } else {
+                    urutTipe.jelajah(urutTipe.cariPertama([&](uint32_t s) { return kolom.getTag(s) < kode; }),
+                                     kunjungi);
+                }
+                break;
+        }
+    }
+
+    // bangun indeks urut yang ditunda - sort sekali lebih murah daripada
+    // sejuta sisipan. dipanggil di bawah shared lock, jadi pake mutex sendiri
+    void pastikanUrut() const {
+        if (!urutTertunda.load(memory_order_acquire)) return;
+        lock_guard<mutex> lk(mtxUrut);
+        if (!urutTertunda.load(memory_order_relaxed)) return;
+        uint32_t n = static_cast<uint32_t>(kolom.size());
+        KolamParalel& kolam = paralel();
+        kolam.barengan([&] { urutId.bangun(n, kolam); }, [&] { urutJudul.bangun(n, kolam); },
+                       [&] { urutTipe.bangun(n, kolam); });
+        urutTertunda.store(false, memory_order_release);
+    }
+
+    void reserveLokal(size_t nItem, size_t nMember) {
+        kolom.reserve(nItem);
+        pinjamanAktif.reserve(nItem);
+        reservasi.reserve(nItem);
+        indeksItem.reserve(nItem);
+        daftarMember.reserve(nMember);
+        memberPerSlot.reserve(nMember);
+        riwayat.reserve(nMember);
+        indeksMember.reserve(nMember);
+    }
+
+public:
+    Perpustakaan()
+        : urutId(kolom), urutJudul(kolom), urutTipe(kolom), urutTertunda(false),
+          urutTampil(UrutKatalog::MASUK), indeksItem(kolom), indeksMember(memberPerSlot),
+          hariMulaiPeriode(hariSekarang()), jam(hariSekarang), hariReplay(0),
+          sink(&sinkNoop()), sinkAktif(false), lsnTerakhir(0), sedangReplay(false) {}
+
+    // ganti sumber hari (nomor hari sejak 1970-01-01), misal buat simulasi
+    void setJam(function<int32_t()> baru) {
+        unique_lock<shared_mutex> lk(mtxStruktur);
+        jam = baru ? move(baru) : function<int32_t()>(hariSekarang);
+    }
+
+    // pasang tujuan event (nullptr = no-op). sink-nya tetep punya pemanggil
+    void pasangSink(EventSink* baru) {
+        unique_lock<shared_mutex> lk(mtxStruktur);
+        sink = baru ? baru : &sinkNoop();
+        sinkAktif = sink->aktif();
+    }
+
+    EventSink* getSink() const { return sink; }
+
+    // ganti kolam paralel (nullptr = kolam bawaan). kolamnya tetep punya pemanggil
+    void pasangKolamParalel(KolamParalel* baru) {
+        unique_lock<shared_mutex> lk(mtxStruktur);
+        kolam = baru;
+    }
+
+    // tambah item ke katalog - cek duplikat lewat indeks, O(1). isinya
+    // disalin ke kolom, `data` boleh langsung dibuang abis ini:
+    //   perpus.tambahItem(Book("B001", "Judul", "Penulis"));
+    bool tambahItem(const DataItem& data) {
+        unique_lock<shared_mutex> lk(mtxStruktur);
+        if (!pasangItem(data)) {
+            kirim(Event(Event::TAMBAH_ITEM, StatusTransaksi::ID_DUPLIKAT, {}, data.getId()));
+            return false;
+        }
+        Item baru = kolom.lihat(static_cast<uint32_t>(kolom.size() - 1));
+        catat(LogTransaksi::TAMBAH_ITEM, [&](PenulisBiner& out) { baru.tulisKe(out); });
+        kirim(Event(Event::TAMBAH_ITEM, StatusTransaksi::SUKSES, {}, baru.getId()));
+        return true;
+    }
+
+    // register member baru
+    bool registerMember(unique_ptr<Member> member) {
+        unique_lock<shared_mutex> lk(mtxStruktur);
+        if (!pasangMember(member)) {
+            kirim(Event(Event::REGISTER_MEMBER, StatusTransaksi::ID_DUPLIKAT, member->getId()));
+            return false;
+        }
+        const Member& baru = *daftarMember.back();
+        catat(LogTransaksi::REGISTER_MEMBER, [&](PenulisBiner& out) { baru.tulisKe(out); });
+        kirim(Event(Event::REGISTER_MEMBER, StatusTransaksi::SUKSES, baru.getId()));
+        return true;
+    }
+
+    // bulk load file alat.txt. file-nya di-mmap, di-parse per baris, terus
+    // dimasukin sekali jalan - cek duplikat (termasuk sesama isi file) cuma
+    // satu lookup hash per item. baris yang error dicatat, sisanya lanjut.
+    // per blok baris, cek format dibagi ke kolam paralel; masukin ke kolom +
+    // indeks tetep satu thread (ga thread-safe, urutan slot harus sama kaya
+    // urutan file)
+    HasilImpor imporAlat(const string& path, size_t maksError = 100) {
+        unique_lock<shared_mutex> lk(mtxStruktur);
+        HasilImpor hasil;
+        FileTerpeta file(path);
+        if (!file.valid()) {
+            hasil.error.push_back({0, "file ga bisa dibuka"});
+            hasil.jumlahError = 1;
+            return hasil;
+        }
+
+        auto catatError = [&](size_t baris, string pesan) {
+            if (hasil.error.size() < maksError) hasil.error.push_back({baris, move(pesan)});
+            hasil.jumlahError++;
+        };
+
+        // perkiraan kasar jumlah baris buat reserve (~32 byte per baris).
+        // kalo file-nya segede katalog atau lebih, indeks urut dibangun ulang nanti
+        size_t perkiraan = file.size() / 32 + 1;
+        reserveLokal(kolom.size() + perkiraan, daftarMember.size());
+        if (perkiraan >= kolom.size()) urutTertunda = true;
+
+        constexpr size_t BARIS_PER_BLOK = 1 << 16;
+        enum : uint8_t { KOSONG, LOLOS, SALAH };
+        string_view isi(file.data(), file.size());
+        vector<string_view> baris;
+        vector<BarisAlat> cek(BARIS_PER_BLOK);
+        vector<uint8_t> status(BARIS_PER_BLOK);
+        vector<string> pesan(BARIS_PER_BLOK);
+        size_t pos = 0;
+        while (pos < isi.size()) {
+            baris.clear();
+            while (pos < isi.size() && baris.size() < BARIS_PER_BLOK) {
+                size_t akhir = isi.find('\n', pos);
+                if (akhir == string_view::npos) akhir = isi.size();
+                baris.push_back(isi.substr(pos, akhir - pos));
+                pos = akhir + 1;
+            }
+            paralel().untukRentang(baris.size(), 1024, [&](size_t a, size_t b) {
+                for (size_t i = a; i < b; i++) {
+                    if (baris[i].find_first_not_of(" \t\r") == string_view::npos) status[i] = KOSONG;
+                    else status[i] = cekBarisAlat(baris[i], cek[i], pesan[i]) ? LOLOS : SALAH;
+                }
+            });
+
+            for (size_t i = 0; i < baris.size(); i++) {
+                hasil.totalBaris++;
+                if (status[i] == KOSONG) continue;
+                if (status[i] == SALAH) {
+                    catatError(hasil.totalBaris, move(pesan[i]));
+                    continue;
+                }
+                Alat alat = buatAlat(cek[i]);
+                if (!pasangItem(alat)) {
+                    catatError(hasil.totalBaris, "ID " + alat.id + " udah ada");
+                    continue;
+                }
+                Item baru = kolom.lihat(static_cast<uint32_t>(kolom.size() - 1));
+                catat(LogTransaksi::TAMBAH_ITEM, [&](PenulisBiner& out) { baru.tulisKe(out); });
+                hasil.sukses++;
+            }
+        }
+        return hasil;
+    }
+
+    // nyalain mode arena: Member yang dibikin lewat buatMember, muatSnapshot
+    // sama replay log ditaro di blok gede, dibebasin sekaligus pas
+    // Perpustakaan mati. objek dari arena jangan dipindah ke Perpustakaan
+    // lain - umurnya nempel ke arena ini. item ga kena: datanya udah numpuk
+    // di kolom katalog, ga ada objek per item
+    void pakaiArena(size_t blokAwal = 1 << 20) {
+        unique_lock<shared_mutex> lk(mtxStruktur);
+        if (!arena) arena = make_unique<ArenaMemori>(blokAwal);
+    }
+
+    bool modeArena() const { return arena != nullptr; }
+
+    ArenaMemori::Statistik statistikArena() const {
+        return arena ? arena->statistik() : ArenaMemori::Statistik{0, 0, 0, 0};
+    }
+
+    // bikin member di arena kalo mode arena nyala, kalo ga ya heap biasa:
+    //   perpus.registerMember(perpus.buatMember("MEM001", "Nama"));
+    template <typename... Args>
+    unique_ptr<Member> buatMember(Args&&... args) {
+        LingkupArena lingkup(arena.get());
+        return make_unique<Member>(forward<Args>(args)...);
+    }
+
+    // siapin kapasitas buat bulk load biar ga realloc/rehash terus
+    void reserve(size_t nItem, size_t nMember = 0) {
+        unique_lock<shared_mutex> lk(mtxStruktur);
+        reserveLokal(nItem, nMember);
+    }
+
+    // cari item by ID - lewat indeks hash, ga scan katalog lagi. balikin
+    // tampilan ke kolom (kosong kalo ga ada) - sama kaya getKolom, jangan
+    // dipake pas ada thread lain yang nambah item
+    Item cariItemById(string_view id) {
+        PengukurMetrik ukur(OpMetrik::CARI_ITEM);
+        shared_lock<shared_mutex> lk(mtxStruktur);
+        Item item = cariItemLokal(id);
+        ukur.selesai(item ? StatusTransaksi::SUKSES : StatusTransaksi::ITEM_TIDAK_ADA);
+        return item;
+    }
+
+    // cari member by ID
+    Member* cariMemberById(string_view id) {
+        PengukurMetrik ukur(OpMetrik::CARI_MEMBER);
+        shared_lock<shared_mutex> lk(mtxStruktur);
+        Member* member = cariMemberLokal(id);
+        ukur.selesai(member ? StatusTransaksi::SUKSES : StatusTransaksi::MEMBER_TIDAK_ADA);
+        return member;
+    }
+
+    // ID luar -> handle, HANDLE_KOSONG kalo ga ada. resolve sekali di pintu
+    // masuk, abis itu transaksi lewat overload yang nerima handle. handle
+    // tetep 32 bit: 26 bit bawah = slot, 6 bit atas = generasi data (mod 64)
+    // waktu handle-nya dibikin - abis datanya diganti total (muat snapshot /
+    // pulihkan) handle lama ditolak kaya ID yang ga ada, bukan nyasar ke
+    // record lain di slot itu. generasinya muter tiap 64 kali ganti data,
+    // jadi handle jangan disimpen lintas sesi. slot >= 2^26 - 1 (katalog
+    // > 67 juta) ga dapet handle, pake jalur ID biasa
+    using Handle = uint32_t;
+    static constexpr uint32_t BIT_SLOT_HANDLE = 26;
+    static constexpr Handle SLOT_HANDLE = (Handle(1) << BIT_SLOT_HANDLE) - 1;
+    static constexpr Handle HANDLE_KOSONG = UINT32_MAX;
+
+    Handle handleItem(string_view id) const {
+        shared_lock<shared_mutex> lk(mtxStruktur);
+        return buatHandle(indeksItem.cari(id));
+    }
+
+    Handle handleMember(string_view id) const {
+        shared_lock<shared_mutex> lk(mtxStruktur);
+        return buatHandle(indeksMember.cari(id));
+    }
+
+    // akses read-only ke kolom katalog (urutan slot) - dipake benchmark dll.
+    // ga dikunci, jangan dipake pas ada thread lain yang nambah item
+    const KatalogKolom& getKolom() const { return kolom; }
+
+    // berapa item tipe `kode` yang lagi tersedia (0 = semua tipe)
+    size_t hitungTersedia(uint8_t kode = 0) const {
+        shared_lock<shared_mutex> lk(mtxStruktur);
+        return kolom.hitungTersediaTipe(kode);
+    }
+
+    // ID maks `n` item tersedia pertama bertipe `kode` (urutan slot / urutan masuk)
+    vector<string> daftarTersedia(uint8_t kode, size_t n) const {
+        shared_lock<shared_mutex> lk(mtxStruktur);
+        vector<string> hasil;
+        for (uint32_t slot : kolom.daftarTersedia(kode, n)) hasil.emplace_back(kolom.getId(slot));
+        return hasil;
+    }
+
+    // cari item lewat kata di judul/penulis/sutradara (semua kata harus ada,
+    // kata terakhir boleh awalan). balikin ID, urutan masuk
+    vector<string> cariItem(string_view query, const IndeksCari::Opsi& opsi = {}) const {
+        shared_lock<shared_mutex> lk(mtxStruktur);
+        vector<string> hasil;
+        for (uint32_t slot : indeksCari.cari(query, kolom, opsi)) hasil.emplace_back(kolom.getId(slot));
+        return hasil;
+    }
+
+    void tampilkanHasilCari(string_view query, bool hanyaTersedia) const {
+        shared_lock<shared_mutex> lk(mtxStruktur);
+        IndeksCari::Opsi opsi;
+        opsi.hanyaTersedia = hanyaTersedia;
+        vector<uint32_t> hasil = indeksCari.cari(query, kolom, opsi);
+        cout << "\n🔎 === HASIL CARI \"" << query << "\" ===" << endl;
+        if (hasil.empty()) {
+            cout << "Ga ketemu apa2 bro" << endl;
+            return;
+        }
+        for (uint32_t slot : hasil) {
+            Item v = kolom.lihat(slot);
+            cout << "  [" << v.getTipe() << "] " << v.getId() << " - " << v.getJudul();
+            if (!v.getDetail().empty()) cout << " (" << v.getDetail() << ")";
+            cout << (v.isTersedia() ? " | Tersedia" : " | Dipinjam") << endl;
+        }
+        if (hasil.size() == opsi.maks) cout << "  ... (cuma " << opsi.maks << " pertama)" << endl;
+    }
+
+    // sorting katalog by ID - pake operator overload yang udah dibuat
+    // sekarang cuma ganti urutan tampil - indeks ID-nya udah kejaga terus,
+    // katalog aslinya tetep urutan masuk. item baru langsung nongol di tempatnya
+    void sortKatalog() {
+        unique_lock<shared_mutex> lk(mtxStruktur);
+        urutTampil = UrutKatalog::ID;
+        kirim(Event(Event::SORT_KATALOG, StatusTransaksi::SUKSES));
+    }
+
+    // satu halaman katalog (halaman mulai 0), urut sesuai `urut`, difilter
+    // tipe (0 = semua) + ketersediaan. balikin ID item-nya
+    vector<string> halamanKatalog(UrutKatalog urut, size_t halaman, size_t perHalaman,
+                                  uint8_t kode = 0, bool hanyaTersedia = false) const {
+        shared_lock<shared_mutex> lk(mtxStruktur);
+        vector<string> hasil;
+        jelajahUrut(urut, kode, hanyaTersedia, halaman * perHalaman, KURSOR_AWAL, [&](uint32_t slot) {
+            if (hasil.size() == perHalaman) return false;
+            hasil.emplace_back(kolom.getId(slot));
+            return true;
+        });
+        return hasil;
+    }
+
+    // ID dalam rentang [dari, sampai]. urutannya urutan string (sama kaya
+    // operator< Item), jadi "B100".."B200" ikut bawa "B1000" dst
+    vector<string> rentangId(string_view dari, string_view sampai, size_t maks = SIZE_MAX) const {
+        shared_lock<shared_mutex> lk(mtxStruktur);
+        pastikanUrut();
+        vector<string> hasil;
+        uint64_t kunciDari = awalanTeks(dari), kunciSampai = awalanTeks(sampai);
+        auto mulai = urutId.cariPertama([&](uint32_t s) { return kolom.bandingId(s, kunciDari, dari) < 0; });
+        urutId.jelajah(mulai, [&](uint32_t slot) {
+            if (kolom.bandingId(slot, kunciSampai, sampai) > 0 || hasil.size() == maks) return false;
+            hasil.emplace_back(kolom.getId(slot));
+            return true;
+        });
+        return hasil;
+    }
+
+    // sama, tapi rentang judul
+    vector<string> rentangJudul(string_view dari, string_view sampai, size_t maks = SIZE_MAX) const {
+        shared_lock<shared_mutex> lk(mtxStruktur);
+        pastikanUrut();
+        vector<string> hasil;
+        auto mulai = urutJudul.cariPertama([&](uint32_t s) { return kolom.getJudul(s) < dari; });
+        urutJudul.jelajah(mulai, [&](uint32_t slot) {
+            if (kolom.getJudul(slot) > sampai || hasil.size() == maks) return false;
+            hasil.emplace_back(kolom.getId(slot));
+            return true;
+        });
+        return hasil;
+    }
+
+    // potret = tampilan konsisten satu titik waktu (lihat VersiLama). selama
+    // dipegang, lock struktur shared ikut dipegang: transaksi jalan terus,
+    // cuma operasi struktural (tambah item, sort, muat...) yang nunggu.
+    // JANGAN manggil method yang ngunci exclusive dari thread yang sama
+    // selama potret masih hidup - deadlock
+    class Potret {
+    private:
+        friend class Perpustakaan;
+        const Perpustakaan* perpus;
+        uint32_t epoch;
+        size_t nItem, nMember;
+        uint64_t lsn;
+        UrutKatalog urut;
+        map<string, int> pinjamanPerTipe;
+        double denda;
+        int kredit;
+        string ekor;                     // statistik s/d antrean reservasi, kalo dibikin buat backup
+        vector<uint32_t> jumlahRiwayat;  // panjang riwayat per member waktu dipotret
+        shared_lock<shared_mutex> kunci;
+
+        Potret(const Perpustakaan* perpus, uint32_t epoch) : perpus(perpus), epoch(epoch) {}
+
+    public:
+        Potret(const Potret&) = delete;
+        Potret& operator=(const Potret&) = delete;
+        ~Potret() { perpus->lepasPotret(epoch); }
+
+        size_t jumlahItem() const { return nItem; }
+        size_t jumlahMember() const { return nMember; }
+        uint64_t lsnTerakhir() const { return lsn; }
+        UrutKatalog urutTampil() const { return urut; }
+        const map<string, int>& getPinjamanPerTipe() const { return pinjamanPerTipe; }
+        double totalDenda() const { return denda; }
+        int totalKredit() const { return kredit; }
+
+        // f(const Item&, const KeadaanItem&) / f(const Member&) dipanggil sambil
+        // megang lock shard versi - cukup buat nulis satu baris, jangan I/O di
+        // dalemnya. data tetap item langsung dari kolom, status-nya versi potret
+        template <typename F>
+        void bacaItem(uint32_t slot, F&& f) const {
+            const KatalogKolom& kolom = perpus->kolom;
+            perpus->versiItem.baca(slot, epoch, [&] { return kolom.keadaan(slot); },
+                                   [&](const KeadaanItem& k) { f(kolom.lihat(slot), k); });
+        }
+
+        template <typename F>
+        void bacaMember(uint32_t slot, F&& f) const {
+            perpus->versiMember.baca(slot, epoch, [&]() -> const Member& { return *perpus->memberPerSlot[slot]; }, f);
+        }
+    };
+
+    // bikin potret. cukup lock struktur shared (dipegang terus sama potretnya)
+    // + gerbang sirkulasi ditutup sebentar buat naikin epoch + nyalin statistik -
+    // ga nunggu potret lain yang lagi hidup kelar laporannya.
+    // buatBackup = sekalian serialisasi bagian snapshot yang ga per item/member
+    unique_ptr<Potret> potret(bool buatBackup = false) const {
+        shared_lock<shared_mutex> lk(mtxStruktur);
+        unique_ptr<Potret> p;
+        gerbang.tutupSebentar([&] { p = buatPotretLokal(buatBackup); });
+        p->kunci = move(lk);
+        return p;
+    }
+
+private:
+    // pemanggil megang lock struktur exclusive, ato shared + gerbang ditutup
+    unique_ptr<Potret> buatPotretLokal(bool buatBackup) const {
+        uint32_t epoch = ++epochTerakhir;
+        {
+            lock_guard<mutex> lk(mtxPotret);
+            potretHidup.push_back(epoch);
+            epochHidup.store(epoch, memory_order_release);
+        }
+        unique_ptr<Potret> p(new Potret(this, epoch));
+        p->nItem = kolom.size();
+        p->nMember = memberPerSlot.size();
+        p->lsn = lsnTerakhir;
+        p->urut = urutTampil;
+        p->pinjamanPerTipe = statistik.pinjamanPerTipe();
+        p->denda = statistik.totalDenda();
+        p->kredit = statistik.totalKredit();
+        if (buatBackup) {
+            PenulisBiner tengah;
+            tulisTengah(tengah);
+            p->ekor = tengah.data();
+            p->jumlahRiwayat.resize(p->nMember);
+            for (uint32_t m = 0; m < p->nMember; m++) p->jumlahRiwayat[m] = riwayat.jumlahMember(m);
+        }
+        return p;
+    }
+
+    // versi lama dibuang begitu potret tertua yang masih butuh udah lepas -
+    // ga nunggu semua potret mati, jadi laporan yang tumpang tindih terus
+    // ga bikin VersiLama numpuk
+    void lepasPotret(uint32_t epoch) const {
+        lock_guard<mutex> lk(mtxPotret);
+        uint32_t tertuaLama = *min_element(potretHidup.begin(), potretHidup.end());
+        potretHidup.erase(find(potretHidup.begin(), potretHidup.end(), epoch));
+        if (potretHidup.empty()) {
+            epochHidup.store(0, memory_order_release);
+            versiItem.buang();
+            versiMember.buang();
+            return;
+        }
+        epochHidup.store(*max_element(potretHidup.begin(), potretHidup.end()), memory_order_release);
+        uint32_t tertua = *min_element(potretHidup.begin(), potretHidup.end());
+        if (tertua != tertuaLama) {
+            versiItem.buangSebelum(tertua);
+            versiMember.buangSebelum(tertua);
+        }
+    }
+
+public:
+    // jumlah versi lama yang lagi disimpen buat potret (item + member)
+    size_t jumlahVersiLama() const { return versiItem.jumlahVersi() + versiMember.jumlahVersi(); }
+
+    // tulis maks `n` item yang lolos filter ke `out`, mulai abis `kursor`.
+    // balikin kursor buat halaman berikutnya, KURSOR_HABIS kalo udah ga ada sisa.
+    // header CSV cuma ditulis di halaman pertama
+    uint32_t streamKatalog(BufferKeluaran& out, FormatListing fmt, const FilterListing& filter = {},
+                           uint32_t kursor = KURSOR_AWAL, size_t n = SIZE_MAX) const {
+        return streamKatalog(*potret(), out, fmt, filter, kursor, n);
+    }
+
+    // sama, tapi dari potret yang udah ada. item yang masuk abis potret dilewatin,
+    // filter tersedia pake status waktu potret
+    uint32_t streamKatalog(const Potret& p, BufferKeluaran& out, FormatListing fmt,
+                           const FilterListing& filter = {}, uint32_t kursor = KURSOR_AWAL,
+                           size_t n = SIZE_MAX) const {
+        if (kursor == KURSOR_AWAL) tulisHeaderItem(out, fmt);
+        size_t ditulis = 0;
+        uint32_t terakhir = kursor;
+        bool masihAda = false;
+        jelajahUrut(filter.urut, filter.kode, false, 0, kursor, [&](uint32_t slot) {
+            if (slot >= p.jumlahItem()) return true;
+            bool lolos = true;
+            p.bacaItem(slot, [&](const Item& item, const KeadaanItem& k) {
+                if (filter.hanyaTersedia && !k.isTersedia()) {
+                    lolos = false;
+                    return;
+                }
+                if (ditulis == n) return;
+                tulisBarisItem(out, fmt, item, k);
+            });
+            if (!lolos) return true;
+            if (ditulis == n) {
+                masihAda = true;  // ada item ke-(n+1) - halaman berikutnya ga kosong
+                return false;
+            }
+            out.cekPenuh();
+            terakhir = slot;
+            ditulis++;
+            return true;
+        });
+        return masihAda ? terakhir : KURSOR_HABIS;
+    }
+
+    // member cuma ada urutan daftar, jadi kursornya langsung slot member
+    uint32_t streamMember(BufferKeluaran& out, FormatListing fmt, uint32_t kursor = KURSOR_AWAL,
+                          size_t n = SIZE_MAX) const {
+        return streamMember(*potret(), out, fmt, kursor, n);
+    }
+
+    uint32_t streamMember(const Potret& p, BufferKeluaran& out, FormatListing fmt,
+                          uint32_t kursor = KURSOR_AWAL, size_t n = SIZE_MAX) const {
+        if (kursor == KURSOR_AWAL) tulisHeaderMember(out, fmt);
+        size_t total = p.jumlahMember();
+        size_t mulai = kursor == KURSOR_AWAL ? 0 : min(size_t(kursor) + 1, total);
+        size_t akhir = mulai + min(n, total - mulai);
+        for (size_t slot = mulai; slot < akhir; slot++) {
+            p.bacaMember(static_cast<uint32_t>(slot), [&](const Member& m) { tulisBarisMember(out, fmt, m); });
+            out.cekPenuh();
+        }
+        return akhir < total && akhir > mulai ? static_cast<uint32_t>(akhir - 1) : KURSOR_HABIS;
+    }
+
+    // ekspor semua katalog/member ke file (CSV / JSON Lines / teks)
+    bool eksporKatalog(const string& path, FormatListing fmt, const FilterListing& filter = {}) const {
+        FILE* f = fopen(path.c_str(), "wb");
+        if (!f) return false;
+        bool ok;
+        {
+            BufferKeluaran out(f);
+            streamKatalog(*potret(), out, fmt, filter);
+            out.flush();
+            ok = out.ok();
+        }
+        return (fclose(f) == 0) && ok;
+    }
+
+    bool eksporMember(const string& path, FormatListing fmt) const {
+        FILE* f = fopen(path.c_str(), "wb");
+        if (!f) return false;
+        bool ok;
+        {
+            BufferKeluaran out(f);
+            streamMember(*potret(), out, fmt);
+            out.flush();
+            ok = out.ok();
+        }
+        return (fclose(f) == 0) && ok;
+    }
+
+    // tampilkan semua katalog - lewat buffer gede, ga endl per baris lagi
+    void tampilkanKatalog() const {
+        BufferKeluaran out(stdout);
+        out.tambah("\n📚 === KATALOG PERPUSTAKAAN ===\n");
+        unique_ptr<Potret> p = potret();
+        if (p->jumlahItem() == 0) {
+            out.tambah("Kosong bro, belum ada item\n");
+            return;
+        }
+        FilterListing filter;
+        filter.urut = p->urutTampil();
+        streamKatalog(*p, out, FormatListing::TEKS, filter);
+    }
+
+    // tampilkan semua member
+    void tampilkanMember() const {
+        BufferKeluaran out(stdout);
+        out.tambah("\n👥 === DAFTAR MEMBER ===\n");
+        unique_ptr<Potret> p = potret();
+        if (p->jumlahMember() == 0) {
+            out.tambah("Belum ada member yang daftar nih\n");
+            return;
+        }
+        streamMember(*p, out, FormatListing::TEKS);
+    }
+
+    size_t jumlahItem() const {
+        shared_lock<shared_mutex> lk(mtxStruktur);
+        return kolom.size();
+    }
+
+    size_t jumlahMember() const {
+        shared_lock<shared_mutex> lk(mtxStruktur);
+        return daftarMember.size();
+    }
+
+    UrutKatalog urutTampilSekarang() const {
+        shared_lock<shared_mutex> lk(mtxStruktur);
+        return urutTampil;
+    }
+
+private:
+    // isi prosesPinjam - slot udah di-resolve, mtxStruktur udah dipegang shared.
+    // idMember/idItem cuma buat event + log
+    HasilTransaksi pinjamLokal(PengukurMetrik& ukur, uint32_t slotMember, uint32_t slot,
+                               string_view idMember, string_view idItem, int hari, bool pakeKredit) {
+        GerbangSirkulasi::Tiket tiket(gerbang);
+        Member* member = memberDiSlot(slotMember);
+        Item item = itemDiSlot(slot);
+
+        Event ev(Event::PINJAM, StatusTransaksi::SUKSES, idMember, idItem);
+        if (!member) {
+            ev.hasil.status = StatusTransaksi::MEMBER_TIDAK_ADA;
+        } else if (!item) {
+            ev.hasil.status = StatusTransaksi::ITEM_TIDAK_ADA;
+        } else {
+            int32_t hariIni = hariTransaksi();
+            {
+                // entri jatuh tempo dibuka di critical section yang sama sama CAS-nya -
+                // kalo di luar, `kembali` yang nyelip duluan nemu entri yang belum ada
+                // dan pinjaman aktifnya ketinggalan nempel di eksemplar yang udah di rak.
+                // record WAL-nya juga, lihat kunciItem
+                lock_guard<mutex> lkItem(kunciItemUntuk(slot));
+                lock_guard<mutex> lkMember(kunciUntuk(member));
+                sebelumUbah(slotMember, *member);
+                sebelumUbah(slot, item);
+                ev.hasil = member->pinjam(item, hari, pakeKredit);
+                ev.sisaKredit = member->getKreditGratis();
+                if (ev.hasil.ok()) {
+                    mulaiPinjaman(slot, slotMember, item, hariIni);
+                    catat(LogTransaksi::PINJAM, [&](PenulisBiner& out) {
+                        out.tulisString(idMember);
+                        out.tulisString(idItem);
+                        out.tulis<int32_t>(hari);
+                        out.tulis<uint8_t>(pakeKredit);
+                        out.tulis<int32_t>(hariIni);
+                    });
+                }
+            }
+            if (ev.hasil.ok()) {
+                statistik.catatPinjam(item.kodeTipe(), 1, ev.hasil.pakeKredit ? 1 : 0);
+                laporan.catatPinjam(hariIni, item.kodeTipe(), 1, ev.hasil.pakeKredit);
+            } else if (ev.hasil.status == StatusTransaksi::HARI_KEBANYAKAN) {
+                ev.hari = item.batasHari();
+            }
+        }
+        ukur.selesai(ev.hasil.status);
+        kirim(ev);
+        return ev.hasil;
+    }
+
+    HasilTransaksi kembaliLokal(PengukurMetrik& ukur, uint32_t slotMember, uint32_t slot,
+                                string_view idMember, string_view idItem, int hariAktual) {
+        GerbangSirkulasi::Tiket tiket(gerbang);
+        Member* member = memberDiSlot(slotMember);
+        Item item = itemDiSlot(slot);
+
+        Event ev(Event::KEMBALI, StatusTransaksi::SUKSES, idMember, idItem);
+        if (!member) {
+            ev.hasil.status = StatusTransaksi::MEMBER_TIDAK_ADA;
+        } else if (!item) {
+            ev.hasil.status = StatusTransaksi::ITEM_TIDAK_ADA;
+        } else {
+            int32_t hariIni = hariTransaksi();
+            uint32_t penerima = AntreanReservasi::KOSONG;
+            {
+                lock_guard<mutex> lkItem(kunciItemUntuk(slot));
+                KunciDuaMember lkMember(kunciUntuk(member), kunciPenerima(slot));
+                sebelumUbah(slotMember, *member);
+                sebelumUbah(slot, item);
+                // catatan pinjaman ditutup SEBELUM eksemplarnya diterusin ke antrean.
+                // kalo kebalik, `mulai` penerimanya bisa nimpa entri yang belum ditutup,
+                // terus `selesai` di sini malah nutup pinjaman dia
+                pinjamanAktif.selesai(slot, slotMember);
+                ev.hasil = member->balikinItem(item, hariAktual);
+                ev.level = member->getLevel();
+                if (ev.hasil.ok()) {
+                    if (ev.hasil.diteruskan) penerima = serahkanTerkunci(slot, item, hariIni);
+                    catat(LogTransaksi::KEMBALI, [&](PenulisBiner& out) {
+                        out.tulisString(idMember);
+                        out.tulisString(idItem);
+                        out.tulis<int32_t>(hariAktual);
+                        out.tulis<int32_t>(hariIni);
+                    });
+                }
+            }
+            if (ev.hasil.ok()) {
+                ev.hari = hariAktual - item.batasHari();
+                statistik.catatDenda(ev.hasil.denda);
+                laporan.catatKembali(hariIni, item.kodeTipe(), ev.hari > 0, ev.hasil.denda);
+                riwayat.catat(slotMember, slot, item.kodeTipe(), hariIni, max(0, ev.hari), ev.hasil.denda);
+                if (penerima != AntreanReservasi::KOSONG) ev.idPenerima = memberPerSlot[penerima]->getId();
+            }
+        }
+        ukur.selesai(ev.hasil.status);
+        kirim(ev);
+        return ev.hasil;
+    }
+
+    HasilTransaksi kembaliDVDLokal(PengukurMetrik& ukur, uint32_t slotMember, uint32_t slot,
+                                   string_view idMember, string_view idDVD, int hariAktual, bool rusak) {
+        GerbangSirkulasi::Tiket tiket(gerbang);
+        Member* member = memberDiSlot(slotMember);
+        Item item = itemDiSlot(slot);
+
+        Event ev(Event::KEMBALI_DVD, StatusTransaksi::SUKSES, idMember, idDVD);
+        ev.rusak = rusak;
+        if (!member) {
+            ev.hasil.status = StatusTransaksi::MEMBER_TIDAK_ADA;
+        } else if (!item) {
+            ev.hasil.status = StatusTransaksi::ITEM_TIDAK_ADA;
+        } else if (item.kodeTipe() != DVD::KODE) {
+            ev.hasil.status = StatusTransaksi::BUKAN_DVD;
+        } else {
+            int32_t hariIni = hariTransaksi();
+            uint32_t penerima = AntreanReservasi::KOSONG;
+            {
+                lock_guard<mutex> lkItem(kunciItemUntuk(slot));
+                KunciDuaMember lkMember(kunciUntuk(member), kunciPenerima(slot));
+                sebelumUbah(slotMember, *member);
+                sebelumUbah(slot, item);
+                pinjamanAktif.selesai(slot, slotMember);  // sebelum diterusin, lihat kembaliLokal
+                ev.hasil = member->balikinDVD(item, hariAktual, rusak);
+                ev.level = member->getLevel();
+                if (ev.hasil.ok()) {
+                    if (ev.hasil.diteruskan) penerima = serahkanTerkunci(slot, item, hariIni);
+                    catat(LogTransaksi::KEMBALI_DVD, [&](PenulisBiner& out) {
+                        out.tulisString(idMember);
+                        out.tulisString(idDVD);
+                        out.tulis<int32_t>(hariAktual);
+                        out.tulis<uint8_t>(rusak);
+                        out.tulis<int32_t>(hariIni);
+                    });
+                }
+            }
+            if (ev.hasil.ok()) {
+                ev.hari = max(0, hariAktual - item.batasHari());
+                statistik.catatDenda(ev.hasil.denda);
+                laporan.catatKembali(hariIni, DVD::KODE, ev.hari > 0, ev.hasil.denda);
+                riwayat.catat(slotMember, slot, DVD::KODE, hariIni, ev.hari, ev.hasil.denda);
+                if (penerima != AntreanReservasi::KOSONG) ev.idPenerima = memberPerSlot[penerima]->getId();
+            }
+        }
+        ukur.selesai(ev.hasil.status);
+        kirim(ev);
+        return ev.hasil;
+    }
+
+    // pemanggil megang lock struktur (generasi cuma ganti pas exclusive)
+    Handle buatHandle(uint32_t slot) const {
+        if (slot >= SLOT_HANDLE) return HANDLE_KOSONG;  // termasuk IndeksHash::KOSONG
+        return static_cast<Handle>(generasi << BIT_SLOT_HANDLE) | slot;
+    }
+
+    // slot dari handle, IndeksHash::KOSONG kalo handle-nya basi (generasi lain)
+    uint32_t slotDari(Handle h) const {
+        if (h == HANDLE_KOSONG || (h >> BIT_SLOT_HANDLE) != (generasi & (HANDLE_KOSONG >> BIT_SLOT_HANDLE))) {
+            return IndeksHash<Item>::KOSONG;
+        }
+        return h & SLOT_HANDLE;
+    }
+
+    // ID asli handle buat event/log, kosong kalo handle-nya ga valid
+    string_view idItemDi(uint32_t slot) const {
+        Item item = itemDiSlot(slot);
+        return item ? item.getId() : string_view();
+    }
+
+    string_view idMemberDi(uint32_t slotMember) const {
+        const Member* member = memberDiSlot(slotMember);
+        return member ? member->getId() : string_view();
+    }
+
+public:
+    // proses peminjaman - aman dipanggil dari banyak thread sekaligus.
+    // hasilnya dibalikin + dikirim ke sink sebagai event
+    HasilTransaksi prosesPinjam(string_view idMember, string_view idItem, 
+                                int hari, bool pakeKredit = false) {
+        PengukurMetrik ukur(OpMetrik::PINJAM);
+        shared_lock<shared_mutex> lk(mtxStruktur);
+        return pinjamLokal(ukur, indeksMember.cari(idMember), indeksItem.cari(idItem), idMember, idItem,
+                           hari, pakeKredit);
+    }
+
+    // versi handle (dari handleMember/handleItem) - ID-nya ga di-hash ulang tiap transaksi
+    HasilTransaksi prosesPinjam(Handle hMember, Handle hItem, int hari, bool pakeKredit = false) {
+        PengukurMetrik ukur(OpMetrik::PINJAM);
+        shared_lock<shared_mutex> lk(mtxStruktur);
+        uint32_t slotMember = slotDari(hMember), slot = slotDari(hItem);
+        return pinjamLokal(ukur, slotMember, slot, idMemberDi(slotMember), idItemDi(slot), hari, pakeKredit);
+    }
+
+    // proses pengembalian item biasa
+    HasilTransaksi prosesKembali(string_view idMember, string_view idItem, int hariAktual) {
+        PengukurMetrik ukur(OpMetrik::KEMBALI);
+        shared_lock<shared_mutex> lk(mtxStruktur);
+        return kembaliLokal(ukur, indeksMember.cari(idMember), indeksItem.cari(idItem), idMember, idItem,
+                            hariAktual);
+    }
+
+    HasilTransaksi prosesKembali(Handle hMember, Handle hItem, int hariAktual) {
+        PengukurMetrik ukur(OpMetrik::KEMBALI);
+        shared_lock<shared_mutex> lk(mtxStruktur);
+        uint32_t slotMember = slotDari(hMember), slot = slotDari(hItem);
+        return kembaliLokal(ukur, slotMember, slot, idMemberDi(slotMember), idItemDi(slot), hariAktual);
+    }
+
+    // proses pengembalian DVD dengan cek rusak
+    HasilTransaksi prosesKembaliDVD(string_view idMember, string_view idDVD, 
+                                    int hariAktual, bool rusak) {
+        PengukurMetrik ukur(OpMetrik::KEMBALI_DVD);
+        shared_lock<shared_mutex> lk(mtxStruktur);
+        return kembaliDVDLokal(ukur, indeksMember.cari(idMember), indeksItem.cari(idDVD), idMember, idDVD,
+                               hariAktual, rusak);
+    }
+
+    HasilTransaksi prosesKembaliDVD(Handle hMember, Handle hItem, int hariAktual, bool rusak) {
+        PengukurMetrik ukur(OpMetrik::KEMBALI_DVD);
+        shared_lock<shared_mutex> lk(mtxStruktur);
+        uint32_t slotMember = slotDari(hMember), slot = slotDari(hItem);
+        return kembaliDVDLokal(ukur, slotMember, slot, idMemberDi(slotMember), idItemDi(slot), hariAktual, rusak);
+    }
+
+    // proses banyak transaksi sekaligus tanpa output. lewatan pertama
+    // resolve + validasi semua ID, lewatan kedua nerapin berurutan sesuai
+    // input - hasilnya sama persis kaya manggil prosesX satu2 dengan urutan
+    // yang sama. statistik dijumlahin lokal dulu, baru disetor sekali
+    vector<HasilTransaksi> prosesBatch(const PermintaanTransaksi* req, size_t n) {
+        PengukurMetrik ukur(OpMetrik::BATCH);
+        vector<HasilTransaksi> hasil(n, HasilTransaksi::dari(StatusTransaksi::SUKSES));
+        vector<pair<uint32_t, uint32_t>> target(n);  // slot member, slot item
+        shared_lock<shared_mutex> lk(mtxStruktur);
+        GerbangSirkulasi::Tiket tiket(gerbang);  // satu batch = satu transaksi buat potret
+
+        // lewatan pertama cuma baca indeks, tiap permintaan berdiri sendiri.
+        // cuma batch gede yang dibagi ke kolam paralel - batch kecil dari worker
+        // server/headless langsung di thread-nya, biar ga numpuk rebutan kolam
+        constexpr size_t BATAS_PARALEL = 1 << 14;
+        auto resolve = [&](size_t a, size_t b) {
+            for (size_t i = a; i < b; i++) {
+                uint32_t slotMember = indeksMember.cari(req[i].idMember);
+                Member* member = memberDiSlot(slotMember);
+                uint32_t slot = indeksItem.cari(req[i].idItem);
+                Item item = itemDiSlot(slot);
+                if (!member) hasil[i].status = StatusTransaksi::MEMBER_TIDAK_ADA;
+                else if (!item) hasil[i].status = StatusTransaksi::ITEM_TIDAK_ADA;
+                else if (req[i].jenis == PermintaanTransaksi::KEMBALI_DVD && item.kodeTipe() != DVD::KODE)
+                    hasil[i].status = StatusTransaksi::BUKAN_DVD;
+                target[i] = {slotMember, slot};
+            }
+        };
+        if (n < BATAS_PARALEL) resolve(0, n);
+        else paralel().untukRentang(n, 2048, resolve);
+
+        array<int, 256> pinjamPerKode{};
+        int kredit = 0;
+        double totalDenda = 0.0;
+        int32_t hariIni = hariTransaksi();
+        AgregatLaporan agregat;
+        auto catatKembaliLokal = [&](const Item& item, int hariAktual, double denda) {
+            uint8_t kode = item.kodeTipe();
+            if (kode >= JUMLAH_KODE_TIPE) return;
+            agregat.kembali[kode]++;
+            agregat.terlambat[kode] += hariAktual > item.batasHari();
+            agregat.denda[kode] += denda;
+        };
+        auto catatRiwayat = [&](uint32_t slotMember, uint32_t slot, const Item& item, int hariAktual, double denda) {
+            riwayat.catat(slotMember, slot, item.kodeTipe(), hariIni, max(0, hariAktual - item.batasHari()), denda);
+        };
+
+        for (size_t i = 0; i < n; i++) {
+            if (hasil[i].status != StatusTransaksi::SUKSES) continue;
+            const PermintaanTransaksi& r = req[i];
+            Member* member = memberPerSlot[target[i].first];
+            uint32_t slot = target[i].second;
+            Item item = kolom.lihat(slot);
+            lock_guard<mutex> lkItem(kunciItemUntuk(slot));
+            KunciDuaMember lkMember(kunciUntuk(member),
+                                    r.jenis == PermintaanTransaksi::PINJAM ? nullptr : kunciPenerima(slot));
+            sebelumUbah(target[i].first, *member);
+            sebelumUbah(slot, item);
+
+            if (r.jenis == PermintaanTransaksi::PINJAM) {
+                hasil[i] = member->pinjam(item, r.hari, r.opsi);
+                if (hasil[i].status != StatusTransaksi::SUKSES) continue;
+                mulaiPinjaman(slot, target[i].first, item, hariIni);  // masih di bawah kunci, lihat pinjamLokal
+                pinjamPerKode[item.kodeTipe()]++;
+                if (hasil[i].pakeKredit) kredit++;
+                if (item.kodeTipe() < JUMLAH_KODE_TIPE) agregat.pinjam[item.kodeTipe()]++;
+                agregat.kredit += hasil[i].pakeKredit;
+                catat(LogTransaksi::PINJAM, [&](PenulisBiner& out) {
+                    out.tulisString(r.idMember);
+                    out.tulisString(r.idItem);
+                    out.tulis<int32_t>(r.hari);
+                    out.tulis<uint8_t>(r.opsi);
+                    out.tulis<int32_t>(hariIni);
+                });
+            } else if (r.jenis == PermintaanTransaksi::KEMBALI) {
+                pinjamanAktif.selesai(slot, target[i].first);  // sebelum diterusin, lihat kembaliLokal
+                hasil[i] = member->balikinItem(item, r.hari);
+                if (hasil[i].status != StatusTransaksi::SUKSES) continue;
+                totalDenda += hasil[i].denda;
+                catatKembaliLokal(item, r.hari, hasil[i].denda);
+                catatRiwayat(target[i].first, slot, item, r.hari, hasil[i].denda);
+                if (hasil[i].diteruskan) serahkanTerkunci(slot, item, hariIni);
+                catat(LogTransaksi::KEMBALI, [&](PenulisBiner& out) {
+                    out.tulisString(r.idMember);
+                    out.tulisString(r.idItem);
+                    out.tulis<int32_t>(r.hari);
+                    out.tulis<int32_t>(hariIni);
+                });
+            } else {
+                pinjamanAktif.selesai(slot, target[i].first);  // sama, sebelum diterusin
+                hasil[i] = member->balikinDVD(item, r.hari, r.opsi);
+                if (hasil[i].status != StatusTransaksi::SUKSES) continue;
+                totalDenda += hasil[i].denda;
+                catatKembaliLokal(item, r.hari, hasil[i].denda);
+                catatRiwayat(target[i].first, slot, item, r.hari, hasil[i].denda);
+                if (hasil[i].diteruskan) serahkanTerkunci(slot, item, hariIni);
+                catat(LogTransaksi::KEMBALI_DVD, [&](PenulisBiner& out) {
+                    out.tulisString(r.idMember);
+                    out.tulisString(r.idItem);
+                    out.tulis<int32_t>(r.hari);
+                    out.tulis<uint8_t>(r.opsi);
+                    out.tulis<int32_t>(hariIni);
+                });
+            }
+        }
+
+        bool kreditTercatat = false;
+        for (size_t kode = 0; kode < pinjamPerKode.size(); kode++) {
+            if (pinjamPerKode[kode] == 0) continue;
+            statistik.catatPinjam(static_cast<uint8_t>(kode), pinjamPerKode[kode], kreditTercatat ? 0 : kredit);
+            kreditTercatat = true;
+        }
+        statistik.catatDenda(totalDenda);
+        if (!agregat.kosong()) laporan.catat(hariIni, agregat);
+#if PERPUS_METRIK
+        // status per request tetep dihitung di op-nya, latensinya cuma per batch
+        for (size_t i = 0; i < n; i++) {
+            static const OpMetrik OP[] = {OpMetrik::PINJAM, OpMetrik::KEMBALI, OpMetrik::KEMBALI_DVD};
+            metrik.catat(OP[req[i].jenis], hasil[i].status);
+        }
+#endif
+        ukur.selesai(StatusTransaksi::SUKSES);
+        return hasil;
+    }
+
+    vector<HasilTransaksi> prosesBatch(const vector<PermintaanTransaksi>& req) {
+        return prosesBatch(req.data(), req.size());
+    }
+
+    // masuk antrean reservasi judul yang eksemplarnya lagi abis semua. begitu
+    // ada yang balik, langsung dipinjemin ke kepala antrean (serahkanTerkunci)
+    HasilTransaksi prosesReservasi(string_view idMember, string_view idItem) {
+        PengukurMetrik ukur(OpMetrik::RESERVASI);
+        shared_lock<shared_mutex> lk(mtxStruktur);
+        GerbangSirkulasi::Tiket tiket(gerbang);
+        uint32_t slotMember = indeksMember.cari(idMember);
+        Member* member = memberDiSlot(slotMember);
+        uint32_t slot = indeksItem.cari(idItem);
+        Item item = itemDiSlot(slot);
+
+        Event ev(Event::RESERVASI, StatusTransaksi::SUKSES, idMember, idItem);
+        if (!member) {
+            ev.hasil.status = StatusTransaksi::MEMBER_TIDAK_ADA;
+        } else if (!item) {
+            ev.hasil.status = StatusTransaksi::ITEM_TIDAK_ADA;
+        } else {
+            uint32_t posisi = 0;
+            int32_t hariIni = hariTransaksi();
+            lock_guard<mutex> lkItem(kunciItemUntuk(slot));  // kepala antrean cuma ganti di bawah kunci item
+            sebelumUbah(slot, item);
+            // dicatat sebelum lock antreannya lepas - kalo telat, `kembali` yang nyelip
+            // bisa nyerahin eksemplarnya ke member ini & nulis KEMBALI duluan, terus
+            // pas replay RESERVASI-nya gagal ITEM_TERSEDIA (pinjamannya ilang)
+            ev.hasil.status = reservasi.daftar(slot, slotMember, item, posisi, [&] {
+                catat(LogTransaksi::RESERVASI, [&](PenulisBiner& out) {
+                    out.tulisString(idMember);
+                    out.tulisString(idItem);
+                    out.tulis<int32_t>(hariIni);
+                });
+            });
+            if (ev.hasil.ok()) ev.hari = static_cast<int32_t>(posisi);
+        }
+        ukur.selesai(ev.hasil.status);
+        kirim(ev);
+        return ev.hasil;
+    }
+
+    // ganti jumlah eksemplar satu judul. eksemplar tambahan yang nganggur
+    // langsung dipinjemin ke antrean reservasi dulu, sisanya baru ke rak
+    HasilTransaksi aturEksemplar(string_view idItem, uint32_t total) {
+        unique_lock<shared_mutex> lk(mtxStruktur);
+        uint32_t slot = indeksItem.cari(idItem);
+        Item item = itemDiSlot(slot);
+        // potret megang lock shared, jadi ga ada yang hidup barengan sama ini.
+        // tetep disalin biar aturannya sama kaya jalur transaksi
+        if (item) sebelumUbah(slot, item);
+
+        Event ev(Event::EKSEMPLAR, StatusTransaksi::SUKSES, {}, idItem);
+        uint32_t keAntrean = 0;
+        if (!item) {
+            ev.hasil.status = StatusTransaksi::ITEM_TIDAK_ADA;
+        } else if (!kolom.setEksemplar(slot, total, keAntrean)) {
+            ev.hasil.status = StatusTransaksi::EKSEMPLAR_TIDAK_VALID;
+        } else {
+            int32_t hariIni = hariTransaksi();
+            uint32_t terpasang = pinjamanAktif.jumlahEksemplar(slot);
+            if (total > terpasang) pinjamanAktif.tambahEksemplar(slot, total - terpasang);
+            for (uint32_t i = 0; i < keAntrean; i++) serahkanKeAntrean(slot, item, hariIni);
+            ev.hari = static_cast<int32_t>(total);
+            catat(LogTransaksi::EKSEMPLAR, [&](PenulisBiner& out) {
+                out.tulisString(idItem);
+                out.tulis<uint32_t>(total);
+                out.tulis<int32_t>(hariIni);
+            });
+        }
+        kirim(ev);
+        return ev.hasil;
+    }
+
+    void tampilkanAntrean(string_view idItem) const {
+        shared_lock<shared_mutex> lk(mtxStruktur);
+        uint32_t slot = indeksItem.cari(idItem);
+        Item item = itemDiSlot(slot);
+        if (!item) {
+            cout << "❌ Item ga ada di katalog!" << endl;
+            return;
+        }
+        vector<uint32_t> isi = reservasi.isi(slot);
+        cout << "\n📋 === ANTREAN RESERVASI " << item.getId() << " ===" << endl;
+        cout << "Eksemplar di rak: " << item.eksemplarDiRak() << "/" << item.jumlahEksemplar()
+             << " | ngantre: " << isi.size() << endl;
+        for (size_t i = 0; i < isi.size(); i++) {
+            const Member* m = memberPerSlot[isi[i]];
+            cout << "  " << i + 1 << ". " << m->getId() << " - " << m->getNama() << endl;
+        }
+    }
+
+    // riwayat pinjaman yang udah balik, hari balik di [dari, sampai]
+    void tampilkanRiwayatMember(string_view idMember, int32_t dari = RiwayatPinjaman::AWAL_WAKTU,
+                                int32_t sampai = RiwayatPinjaman::AKHIR_WAKTU) const {
+        shared_lock<shared_mutex> lk(mtxStruktur);
+        uint32_t slotMember = indeksMember.cari(idMember);
+        const Member* member = memberDiSlot(slotMember);
+        if (!member) {
+            cout << "❌ Member ga ketemu!" << endl;
+            return;
+        }
+        auto tag = [this](uint32_t slot) { return kolom.getTag(slot); };
+        vector<RiwayatPinjaman::Record> isi = riwayat.ambil(slotMember, dari, sampai);
+        RiwayatPinjaman::Agregat a = riwayat.agregatMember(slotMember, dari, sampai, 0, tag);
+        cout << "\n📜 === RIWAYAT PINJAMAN " << member->getId() << " - " << member->getNama() << " ===" << endl;
+        cout << "Total: " << a.jumlah << " pinjaman | telat: " << a.telat << " (" << fixed << setprecision(1)
+             << a.rasioTelat() << "%) | denda: Rp" << setprecision(0) << a.denda << endl;
+        for (const RiwayatPinjaman::Record& r : isi) {
+            cout << "  " << formatTanggal(r.hari) << "  " << kolom.getId(r.slotItem) << " - " << kolom.getJudul(r.slotItem);
+            if (r.hariTelat) cout << " (telat " << r.hariTelat << " hari, Rp" << r.denda << ")";
+            cout << endl;
+        }
+    }
+
+    // k member paling rajin minjem tipe `kode` (0 = semua) di rentang hari balik
+    vector<pair<string, uint64_t>> topPeminjam(size_t k, uint8_t kode = 0,
+                                               int32_t dari = RiwayatPinjaman::AWAL_WAKTU,
+                                               int32_t sampai = RiwayatPinjaman::AKHIR_WAKTU) const {
+        shared_lock<shared_mutex> lk(mtxStruktur);
+        vector<pair<string, uint64_t>> hasil;
+        if (kode >= JUMLAH_KODE_TIPE) return hasil;
+        auto tag = [this](uint32_t slot) { return kolom.getTag(slot); };
+        for (const RiwayatPinjaman::Peringkat& p : riwayat.top(k, kode, dari, sampai, tag, paralel())) {
+            hasil.emplace_back(memberPerSlot[p.slotMember]->getId(), p.jumlah);
+        }
+        return hasil;
+    }
+
+    RiwayatPinjaman::Agregat agregatRiwayat(uint8_t kode = 0, int32_t dari = RiwayatPinjaman::AWAL_WAKTU,
+                                            int32_t sampai = RiwayatPinjaman::AKHIR_WAKTU) const {
+        shared_lock<shared_mutex> lk(mtxStruktur);
+        if (kode >= JUMLAH_KODE_TIPE) return {};
+        return riwayat.agregat(dari, sampai, kode, [this](uint32_t slot) { return kolom.getTag(slot); }, paralel());
+    }
+
+    void tampilkanTopPeminjam(size_t k, uint8_t kode = 0) const {
+        vector<pair<string, uint64_t>> top = topPeminjam(k, kode);
+        cout << "\n🏆 === TOP " << k << " PEMINJAM" << (kode ? string(" ") + NAMA_TIPE[kode] : string()) << " ===" << endl;
+        if (top.empty()) cout << "  Belum ada pinjaman yang dibalikin" << endl;
+        for (size_t i = 0; i < top.size(); i++) {
+            cout << "  " << i + 1 << ". " << top[i].first << ": " << top[i].second << " kali" << endl;
+        }
+    }
+
+    // rasio telat per tipe sepanjang masa + 30 hari terakhir, plus ongkos memori riwayat
+    void tampilkanAnalitikRiwayat() const {
+        int32_t hariIni = jam();
+        cout << "\n📈 === ANALITIK RIWAYAT PINJAMAN ===" << endl;
+        cout << setw(10) << left << "Tipe" << right << setw(10) << "Pinjam" << setw(10) << "Telat %"
+             << setw(14) << "Denda (Rp)" << setw(12) << "30hr telat%" << endl;
+        for (uint8_t k = 0; k < JUMLAH_KODE_TIPE; k++) {
+            RiwayatPinjaman::Agregat a = agregatRiwayat(k);
+            if (k && !a.jumlah) continue;
+            RiwayatPinjaman::Agregat baru = agregatRiwayat(k, hariIni - 29, hariIni);
+            cout << setw(10) << left << (k ? NAMA_TIPE[k] : "Semua") << right << setw(10) << a.jumlah
+                 << setw(10) << fixed << setprecision(1) << a.rasioTelat() << setw(14) << setprecision(0)
+                 << a.denda << setw(12) << setprecision(1) << baru.rasioTelat() << endl;
+        }
+        shared_lock<shared_mutex> lk(mtxStruktur);
+        RiwayatPinjaman::Memori m = riwayat.memori();
+        cout << "💾 Memori riwayat: " << m.byteArena << " byte kolom + " << m.byteRingkasan
+             << " byte ringkasan";
+        if (m.record) cout << " (" << setprecision(1) << double(m.byteArena) / m.record << " byte/pinjaman)";
+        cout << endl;
+    }
+
+    // laporan bulanan - statistik lengkap
+    void laporanBulanan() const {
+        PengukurMetrik ukur(OpMetrik::LAPORAN);
+        unique_ptr<Potret> p = potret();
+        const map<string, int>& pinjamanPerTipe = p->getPinjamanPerTipe();
+        cout << "\n📊 === LAPORAN BULANAN PERPUSTAKAAN ===" << endl;
+        cout << "\n📖 Peminjaman per Tipe:" << endl;
+        if (pinjamanPerTipe.empty()) {
+            cout << "  Belum ada peminjaman bulan ini" << endl;
+        } else {
+            for (const auto& pair : pinjamanPerTipe) {
+                cout << "  " << pair.first << ": " << pair.second << " kali" << endl;
+            }
+        }
+        
+        cout << "\n💰 Total Denda Bulan Ini: Rp" 
+             << fixed << setprecision(0) << p->totalDenda() << endl;
+        cout << "🎁 Total Kredit Gratis Terpakai: " << p->totalKredit() << endl;
+        cout << "\n📚 Total Item di Katalog: " << p->jumlahItem() << endl;
+        cout << "👥 Total Member Terdaftar: " << p->jumlahMember() << endl;
+        ukur.selesai(StatusTransaksi::SUKSES);
+    }
+
+    // agregat rentang hari [dari, sampai] - O(jumlah ember), bukan O(transaksi)
+    AgregatLaporan laporanRentang(int32_t dari, int32_t sampai) const {
+        shared_lock<shared_mutex> lk(mtxStruktur);
+        return laporan.rentang(dari, sampai);
+    }
+
+    AgregatLaporan laporanBulanKe(int32_t bulanKe) const {
+        shared_lock<shared_mutex> lk(mtxStruktur);
+        return laporan.satuBulan(bulanKe);
+    }
+
+    vector<ArsipPeriode> getArsip() const {
+        shared_lock<shared_mutex> lk(mtxStruktur);
+        return arsip;
+    }
+
+    struct InfoTerlambat {
+        string idItem;
+        string idMember;
+        int32_t hariPinjam;
+        int32_t jatuhTempo;
+        int32_t hariTelat;
+        double dendaBerjalan;
+    };
+
+private:
+    vector<InfoTerlambat> infoTerlambat(const vector<uint32_t>& entri, int32_t hariIni) const {
+        vector<InfoTerlambat> hasil;
+        hasil.reserve(entri.size());
+        for (uint32_t e : entri) {
+            TabelPinjaman::Pinjaman p = pinjamanAktif.lihat(e);
+            if (p.slotMember == TabelPinjaman::KOSONG) continue;  // keburu dibalikin
+            int32_t telat = hariIni - p.jatuhTempo;
+            hasil.push_back(InfoTerlambat{string(kolom.getId(p.slotItem)),
+                                          string(memberPerSlot[p.slotMember]->getId()), p.hariPinjam,
+                                          p.jatuhTempo, telat, telat * p.dendaPerHari});
+        }
+        return hasil;
+    }
+
+public:
+    // pinjaman yang BARU lewat jatuh tempo sejak pengecekan terakhir -
+    // biayanya O(yang kadaluarsa), bukan O(semua pinjaman)
+    vector<InfoTerlambat> cekJatuhTempo() {
+        shared_lock<shared_mutex> lk(mtxStruktur);
+        int32_t hariIni = jam();
+        pinjamanAktif.majuHari(hariIni, paralel());
+        return infoTerlambat(pinjamanAktif.ambilBaruTelat(), hariIni);
+    }
+
+    // semua pinjaman yang lagi telat per hari ini
+    vector<InfoTerlambat> daftarTerlambat() {
+        shared_lock<shared_mutex> lk(mtxStruktur);
+        int32_t hariIni = jam();
+        pinjamanAktif.majuHari(hariIni, paralel());
+        return infoTerlambat(pinjamanAktif.semuaTelat(), hariIni);
+    }
+
+    // total denda yang udah numpuk dari pinjaman telat yang belum balik
+    double dendaTerakru() {
+        shared_lock<shared_mutex> lk(mtxStruktur);
+        return pinjamanAktif.dendaBerjalan(jam(), paralel());
+    }
+
+    size_t jumlahPinjamanAktif() const {
+        shared_lock<shared_mutex> lk(mtxStruktur);
+        return pinjamanAktif.jumlahAktif();
+    }
+
+    void tampilkanTerlambat() {
+        vector<InfoTerlambat> telat = daftarTerlambat();
+        cout << "\n⏰ === PINJAMAN TERLAMBAT ===" << endl;
+        cout << "Pinjaman aktif: " << jumlahPinjamanAktif() << " | telat: " << telat.size() << endl;
+        for (const InfoTerlambat& t : telat) {
+            cout << "  " << t.idItem << " dipinjem " << t.idMember << " - tempo " << formatTanggal(t.jatuhTempo)
+                 << ", telat " << t.hariTelat << " hari (Rp" << fixed << setprecision(0)
+                 << t.dendaBerjalan << ")" << endl;
+        }
+        cout << "💸 Denda berjalan: Rp" << fixed << setprecision(0) << dendaTerakru() << endl;
+    }
+
+    // riwayat `nBulan` bulan kalender terakhir + periode yang udah diarsip
+    void laporanRiwayat(int nBulan = 6) const {
+        shared_lock<shared_mutex> lk(mtxStruktur);
+        static const char* NAMA_BULAN[] = {"Jan", "Feb", "Mar", "Apr", "Mei", "Jun",
+                                           "Jul", "Agu", "Sep", "Okt", "Nov", "Des"};
+        int32_t bulanIni = bulanDariHari(jam());
+        cout << "\n🗓️  === RIWAYAT " << nBulan << " BULAN TERAKHIR ===" << endl;
+        cout << setw(10) << left << "Bulan" << right << setw(8) << "Pinjam" << setw(8) << "Balik"
+             << setw(10) << "Telat %" << setw(14) << "Denda (Rp)" << setw(8) << "Kredit" << endl;
+        for (int32_t b = bulanIni - nBulan + 1; b <= bulanIni; b++) {
+            AgregatLaporan a = laporan.satuBulan(b);
+            uint32_t balik = 0;
+            for (uint32_t x : a.kembali) balik += x;
+            cout << setw(10) << left << (string(NAMA_BULAN[b % 12]) + " " + to_string(b / 12)) << right
+                 << setw(8) << a.totalPinjam() << setw(8) << balik
+                 << setw(10) << fixed << setprecision(1) << a.rasioTerlambat()
+                 << setw(14) << setprecision(0) << a.totalDenda() << setw(8) << a.kredit << endl;
+        }
+
+        AgregatLaporan bulanBerjalan = laporan.satuBulan(bulanIni);
+        cout << "\n📖 Bulan ini per tipe:" << endl;
+        for (uint8_t k = 1; k < JUMLAH_KODE_TIPE; k++) {
+            if (!bulanBerjalan.pinjam[k] && !bulanBerjalan.kembali[k]) continue;
+            cout << "  " << NAMA_TIPE[k] << ": " << bulanBerjalan.pinjam[k] << " pinjam, "
+                 << setprecision(1) << bulanBerjalan.rasioTerlambat(k) << "% telat, Rp"
+                 << setprecision(0) << bulanBerjalan.denda[k] << endl;
+        }
+
+        cout << "\n🗄️  Arsip statistik bulanan (" << arsip.size() << " periode):" << endl;
+        for (const ArsipPeriode& a : arsip) {
+            int total = 0;
+            for (const auto& pair : a.pinjamanPerTipe) total += pair.second;
+            cout << "  " << formatTanggal(a.hariMulai) << " s/d " << formatTanggal(a.hariSelesai)
+                 << ": " << total << " pinjam, denda Rp" << setprecision(0) << a.denda
+                 << ", kredit " << a.kredit << endl;
+        }
+    }
+
+    // simpen semua state ke file snapshot biner:
+    // [magic u32][versi u32][panjang payload u64][payload...]
+    // lewat potret, jadi konsisten sama lsn-nya tanpa nahan transaksi
+    // selama nulis - exclusive-nya cuma pas potretnya dibikin
+    bool simpanSnapshot(const string& path) const {
+        return simpanLokal(path, *potret(true));
+    }
+
+private:
+    // potret harus dibikin pake buatBackup
+    bool simpanLokal(const string& path, const Potret& p) const {
+        PenulisBiner out;
+        out.tulis<uint32_t>(MAGIC_SNAPSHOT);
+        out.tulis<uint32_t>(VERSI_SNAPSHOT);
+        size_t posPanjang = out.posisi();
+        out.tulis<uint64_t>(0);
+        size_t awalPayload = out.posisi();
+
+        out.tulis<uint64_t>(p.lsnTerakhir());
+        out.tulis<uint64_t>(p.jumlahItem());
+        for (uint32_t slot = 0; slot < p.jumlahItem(); slot++) {
+            p.bacaItem(slot, [&](const Item& item, const KeadaanItem& k) { item.tulisKe(out, k); });
+        }
+
+        out.tulis<uint64_t>(p.jumlahMember());
+        for (uint32_t slot = 0; slot < p.jumlahMember(); slot++) {
+            p.bacaMember(slot, [&](const Member& member) { member.tulisKe(out); });
+        }
+        out.tulisMentah(p.ekor);
+
+        // riwayat per member: [id member][n u32][slot item, hari, telat, denda]*n.
+        // slot item disimpen mentah - katalog dimuat ulang dengan urutan slot yang sama.
+        // riwayat cuma nambah di belakang, jadi cukup dipotong ke panjang waktu potret
+        size_t posJumlah = out.posisi();
+        out.tulis<uint64_t>(0);
+        uint64_t nRiwayat = 0;
+        for (uint32_t slotMember = 0; slotMember < p.jumlahMember(); slotMember++) {
+            uint32_t n = p.jumlahRiwayat[slotMember];
+            if (n == 0) continue;
+            vector<RiwayatPinjaman::Record> isi = riwayat.ambil(slotMember);
+            out.tulisString(memberPerSlot[slotMember]->getId());
+            out.tulis<uint32_t>(n);
+            for (uint32_t i = 0; i < n; i++) {
+                const RiwayatPinjaman::Record& r = isi[i];
+                out.tulis<uint32_t>(r.slotItem);
+                out.tulis<int32_t>(r.hari);
+                out.tulis<uint32_t>(r.hariTelat);
+                out.tulis<uint32_t>(r.denda);
+            }
+            nRiwayat++;
+        }
+        out.timpa<uint64_t>(posJumlah, nRiwayat);
+
+        out.timpa<uint64_t>(posPanjang, out.posisi() - awalPayload);
+        return tulisFileAtomik(path, out.data());
+    }
+
+    // bagian snapshot dari statistik sampe antrean reservasi. ga bisa dibaca
+    // per versi kaya item/member, jadi diserialisasi pas potret dibikin
+    // (gerbang sirkulasi ditutup). isinya kecil dibanding katalog
+    void tulisTengah(PenulisBiner& out) const {
+        map<string, int> pinjamanPerTipe = statistik.pinjamanPerTipe();
+        out.tulis<uint32_t>(static_cast<uint32_t>(pinjamanPerTipe.size()));
+        for (const auto& pair : pinjamanPerTipe) {
+            out.tulisString(pair.first);
+            out.tulis<int32_t>(pair.second);
+        }
+        out.tulis<double>(statistik.totalDenda());
+        out.tulis<int32_t>(statistik.totalKredit());
+
+        out.tulis<int32_t>(hariMulaiPeriode);
+        out.tulis<uint32_t>(static_cast<uint32_t>(arsip.size()));
+        for (const ArsipPeriode& a : arsip) {
+            out.tulis<int32_t>(a.hariMulai);
+            out.tulis<int32_t>(a.hariSelesai);
+            out.tulis<uint32_t>(static_cast<uint32_t>(a.pinjamanPerTipe.size()));
+            for (const auto& pair : a.pinjamanPerTipe) {
+                out.tulisString(pair.first);
+                out.tulis<int32_t>(pair.second);
+            }
+            out.tulis<double>(a.denda);
+            out.tulis<int32_t>(a.kredit);
+        }
+        laporan.tulisKe(out);
+
+        // pinjaman aktif disimpen pake ID (slot belum tentu sama pas dimuat)
+        size_t posJumlah = out.posisi();
+        out.tulis<uint64_t>(0);
+        uint64_t nAktif = 0;
+        for (uint32_t e = 0; e < pinjamanAktif.size(); e++) {
+            TabelPinjaman::Pinjaman p = pinjamanAktif.lihat(e);
+            if (p.slotMember == TabelPinjaman::KOSONG) continue;
+            out.tulisString(kolom.getId(p.slotItem));
+            out.tulisString(memberPerSlot[p.slotMember]->getId());
+            out.tulis<int32_t>(p.hariPinjam);
+            out.tulis<int32_t>(p.jatuhTempo);
+            out.tulis<double>(p.dendaPerHari);
+            nAktif++;
+        }
+        out.timpa<uint64_t>(posJumlah, nAktif);
+
+        // antrean reservasi, urut dari kepala: [id item][id member]
+        posJumlah = out.posisi();
+        out.tulis<uint64_t>(0);
+        uint64_t nAntre = 0;
+        for (uint32_t slot = 0; slot < kolom.size(); slot++) {
+            if (kolom.panjangAntrean(slot) == 0) continue;
+            for (uint32_t slotMember : reservasi.isi(slot)) {
+                out.tulisString(kolom.getId(slot));
+                out.tulisString(memberPerSlot[slotMember]->getId());
+                nAntre++;
+            }
+        }
+        out.timpa<uint64_t>(posJumlah, nAntre);
+    }
+
+public:
+
+    // muat snapshot, state lama diganti total. kalo file-nya rusak/beda versi,
+    // state sekarang ga disentuh sama sekali
+    bool muatSnapshot(const string& path) {
+        FileTerpeta file(path);
+        if (!file.valid()) return false;
+
+        PembacaBiner in(file.data(), file.size());
+        if (in.baca<uint32_t>() != MAGIC_SNAPSHOT) return false;
+        uint32_t versi = in.baca<uint32_t>();
+        if (versi < 1 || versi > VERSI_SNAPSHOT) return false;
+        if (in.baca<uint64_t>() != in.sisa()) return false;
+
+        // v1 belum punya lsn - anggep aja 0
+        uint64_t lsn = versi >= 2 ? in.baca<uint64_t>() : 0;
+
+        // parse dulu semuanya ke tempat sementara - item langsung ke kolom
+        // baru, satu record dipake ulang. mode arena: generasi baru dapet
+        // arena sendiri, arena lama dibuang bareng member lama
+        unique_ptr<ArenaMemori> arenaBaru = arena ? make_unique<ArenaMemori>() : nullptr;
+        LingkupArena lingkup(arenaBaru.get());
+        uint64_t nItem = in.baca<uint64_t>();
+        if (nItem > in.sisa()) return false;
+        KatalogKolom kolomBaru;
+        kolomBaru.reserve(nItem);
+        DataItem data;
+        for (uint64_t i = 0; i < nItem; i++) {
+            if (!DataItem::bacaDari(in, data)) return false;
+            kolomBaru.tambah(data);
+        }
+
+        uint64_t nMember = in.baca<uint64_t>();
+        if (nMember > in.sisa()) return false;
+        vector<unique_ptr<Member>> members;
+        members.reserve(nMember);
+        for (uint64_t i = 0; i < nMember; i++) {
+            auto member = Member::bacaDari(in);
+            if (!member) return false;
+            members.push_back(move(member));
+        }
+
+        map<string, int> statTipe;
+        uint32_t nTipe = in.baca<uint32_t>();
+        for (uint32_t i = 0; i < nTipe && in.isOk(); i++) {
+            string tipe(in.bacaString());
+            statTipe[tipe] = in.baca<int32_t>();
+        }
+        double denda = in.baca<double>();
+        int kredit = in.baca<int32_t>();
+
+        // v3: riwayat laporan - dibaca ke mesin sementara dulu
+        int32_t mulaiPeriode = jam();
+        vector<ArsipPeriode> arsipBaru;
+        MesinLaporan laporanBaru;
+        if (versi >= 3) {
+            mulaiPeriode = in.baca<int32_t>();
+            uint32_t nArsip = in.baca<uint32_t>();
+            if (nArsip > in.sisa()) return false;
+            for (uint32_t i = 0; i < nArsip && in.isOk(); i++) {
+                ArsipPeriode a;
+                a.hariMulai = in.baca<int32_t>();
+                a.hariSelesai = in.baca<int32_t>();
+                uint32_t n = in.baca<uint32_t>();
+                for (uint32_t j = 0; j < n && in.isOk(); j++) {
+                    string tipe(in.bacaString());
+                    a.pinjamanPerTipe[tipe] = in.baca<int32_t>();
+                }
+                a.denda = in.baca<double>();
+                a.kredit = in.baca<int32_t>();
+                arsipBaru.push_back(move(a));
+            }
+            laporanBaru.bacaDari(in);
+        }
+
+        struct PinjamanTersimpan {
+            string idItem, idMember;
+            int32_t hariPinjam, jatuhTempo;
+            double dendaPerHari;
+        };
+        vector<PinjamanTersimpan> aktif;
+        if (versi >= 4) {
+            uint64_t nAktif = in.baca<uint64_t>();
+            if (nAktif > in.sisa()) return false;
+            for (uint64_t i = 0; i < nAktif && in.isOk(); i++) {
+                PinjamanTersimpan p;
+                p.idItem = string(in.bacaString());
+                p.idMember = string(in.bacaString());
+                p.hariPinjam = in.baca<int32_t>();
+                p.jatuhTempo = in.baca<int32_t>();
+                p.dendaPerHari = in.baca<double>();
+                aktif.push_back(move(p));
+            }
+        }
+        vector<pair<string, string>> antre;  // id item, id member
+        if (versi >= 5) {
+            uint64_t nAntre = in.baca<uint64_t>();
+            if (nAntre > in.sisa()) return false;
+            for (uint64_t i = 0; i < nAntre && in.isOk(); i++) {
+                string idItem(in.bacaString());
+                antre.emplace_back(move(idItem), string(in.bacaString()));
+            }
+        }
+        vector<pair<string, vector<RiwayatPinjaman::Record>>> riwayatBaru;
+        if (versi >= 6) {
+            uint64_t nRiwayat = in.baca<uint64_t>();
+            if (nRiwayat > in.sisa()) return false;
+            for (uint64_t i = 0; i < nRiwayat && in.isOk(); i++) {
+                string idMember(in.bacaString());
+                uint32_t n = in.baca<uint32_t>();
+                if (n > in.sisa() / 16) return false;
+                vector<RiwayatPinjaman::Record> isi(n);
+                for (RiwayatPinjaman::Record& r : isi) {
+                    r.slotItem = in.baca<uint32_t>();
+                    r.hari = in.baca<int32_t>();
+                    r.hariTelat = in.baca<uint32_t>();
+                    r.denda = in.baca<uint32_t>();
+                    if (r.slotItem >= kolomBaru.size()) return false;
+                }
+                riwayatBaru.emplace_back(move(idMember), move(isi));
+            }
+        }
+        if (!in.isOk()) return false;
+
+        // baru ganti state beneran
+        unique_lock<shared_mutex> lk(mtxStruktur);
+        kosongkan();
+        if (arenaBaru) arena = move(arenaBaru);
+        kolom = move(kolomBaru);
+        reserveLokal(kolom.size(), members.size());
+        urutTertunda = true;
+        for (uint32_t slot = 0; slot < kolom.size(); slot++) {
+            if (!daftarkanItem(slot)) { kosongkan(); return false; }
+        }
+        for (auto& member : members) {
+            if (!pasangMember(member)) { kosongkan(); return false; }
+        }
+        statistik.pulihkan(statTipe, denda, kredit);
+        for (const PinjamanTersimpan& p : aktif) {
+            uint32_t slot = indeksItem.cari(p.idItem);
+            uint32_t slotMember = indeksMember.cari(p.idMember);
+            if (slot == IndeksHash<Item>::KOSONG || slotMember == IndeksHash<Member>::KOSONG) continue;
+            pinjamanAktif.mulai(slot, slotMember, p.hariPinjam, p.jatuhTempo, p.dendaPerHari);
+        }
+        for (const auto& a : antre) {
+            uint32_t slot = indeksItem.cari(a.first);
+            uint32_t slotMember = indeksMember.cari(a.second);
+            if (slot == IndeksHash<Item>::KOSONG || slotMember == IndeksHash<Member>::KOSONG) continue;
+            uint32_t posisi;
+            reservasi.daftar(slot, slotMember, kolom.lihat(slot), posisi);
+        }
+        for (const auto& rw : riwayatBaru) {
+            uint32_t slotMember = indeksMember.cari(rw.first);
+            if (slotMember == IndeksHash<Member>::KOSONG) continue;
+            for (const RiwayatPinjaman::Record& r : rw.second) {
+                riwayat.catat(slotMember, r.slotItem, kolom.getTag(r.slotItem), r.hari, r.hariTelat, r.denda);
+            }
+        }
+        hariMulaiPeriode = mulaiPeriode;
+        arsip = move(arsipBaru);
+        swap(laporan, laporanBaru);
+        lsnTerakhir = lsn;
+        return true;
+    }
+
+    // replay log di atas state sekarang (biasanya abis muatSnapshot), terus
+    // log-nya dibuka buat transaksi baru. record yang lsn-nya udah kecover
+    // snapshot di-skip. balikin jumlah transaksi yang dipulihin
+    size_t aktifkanLog(const string& path, KonfigurasiLog konfig = KonfigurasiLog()) {
+        wal.reset();
+        size_t dipulihkan = 0;
+        {
+            // replay diem2 aja - sink dimatiin dulu sementara
+            bool aktifLama = sinkAktif;
+            sinkAktif = false;
+            sedangReplay = true;
+            LingkupArena lingkup(arena.get());
+            LogTransaksi::replay(path, [&](uint64_t lsn, LogTransaksi::Jenis jenis,
+                                           PembacaBiner& in) {
+                if (lsn <= lsnTerakhir) return;
+                terapkanRecord(jenis, in);
+                lsnTerakhir = lsn;
+                dipulihkan++;
+            });
+            sedangReplay = false;
+            sinkAktif = aktifLama;
+        }
+        wal = make_unique<LogTransaksi>(path, konfig);
+        if (!wal->valid()) wal.reset();
+        return dipulihkan;
+    }
+
+    // simpen snapshot baru terus kosongin log, soalnya isinya udah kecover.
+    // kalo crash di antaranya aman: record lama ke-skip berkat lsn.
+    // lock exclusive dipegang terus biar ga ada transaksi nyelip terus kepotong
+    bool checkpoint(const string& pathSnapshot) {
+        unique_lock<shared_mutex> lk(mtxStruktur);
+        if (wal) wal->sinkron();
+        // ga lewat potret(): log-nya dipotong semua, jadi ga boleh ada
+        // transaksi yang masuk di antara potret sama potong
+        if (!simpanLokal(pathSnapshot, *buatPotretLokal(true))) return false;
+        return !wal || wal->potong();
+    }
+
+    // true = WAL gagal ditulis (disk penuh / fsync error): transaksi sesudahnya
+    // ga tahan crash sampe checkpoint berikutnya sukses
+    bool logRusak() const { return wal && wal->rusak(); }
+
+    // reset statistik bulanan - panggil tiap awal bulan
+    // statistik periode berjalan diarsip dulu baru dinolin
+    void resetStatistikBulanan() {
+        unique_lock<shared_mutex> lk(mtxStruktur);
+        int32_t hariIni = hariTransaksi();
+        arsip.push_back(ArsipPeriode{hariMulaiPeriode, hariIni, statistik.pinjamanPerTipe(),
+                                     statistik.totalDenda(), statistik.totalKredit()});
+        hariMulaiPeriode = hariIni;
+        statistik.reset();
+        catat(LogTransaksi::RESET_STATISTIK, [&](PenulisBiner& out) { out.tulis<int32_t>(hariIni); });
+        kirim(Event(Event::RESET_STATISTIK, StatusTransaksi::SUKSES));
+    }
+};
+
+// ===========================
+// MENU INTERFACE
+// ===========================
+// file snapshot - dimuat pas start, disimpen pas exit / menu 11.
+// transaksi di antaranya dicatat ke log, di-replay pas start berikutnya
+const string FILE_SNAPSHOT = "perpustakaan.snap";
+const string FILE_LOG = "transaksi.wal";
+const string FILE_KEBIJAKAN = "kebijakan.txt";  // opsional, ganti pake --kebijakan <path>
+
+void tampilkanMenu() {
+    cout << "\n╔════════════════════════════════════╗" << endl;
+    cout << "║   SISTEM PERPUSTAKAAN AMBIS 📚    ║" << endl;
+    cout << "╚════════════════════════════════════╝" << endl;
+    cout << "1. Tambah Item (Book/Magazine/DVD)" << endl;
+    cout << "2. Register Member" << endl;
+    cout << "3. Tampilkan Katalog" << endl;
+    cout << "4. Tampilkan Member" << endl;
+    cout << "5. Pinjam Item" << endl;
+    cout << "6. Kembalikan Item" << endl;
+    cout << "7. Kembalikan DVD (dengan cek rusak)" << endl;
+    cout << "8. Sort Katalog" << endl;
+    cout << "9. Laporan Bulanan" << endl;
+    cout << "10. Reset Statistik Bulanan" << endl;
+    cout << "11. Simpan Data (snapshot)" << endl;
+    cout << "12. Impor Alat dari File" << endl;
+    cout << "13. Riwayat Laporan" << endl;
+    cout << "14. Pinjaman Terlambat" << endl;
+    cout << "15. Cari Item (judul/penulis/sutradara)" << endl;
+    cout << "16. Ekspor Katalog/Member (CSV/JSONL)" << endl;
+    cout << "17. Metrik Performa" << endl;
+    cout << "18. Reservasi & Eksemplar" << endl;
+    cout << "19. Riwayat & Analitik Member" << endl;
+    cout << "0. Exit" << endl;
+    cout << "Pilih menu: ";
+}
+
+// ===========================
+// FUNGSI TEST CASES
+// ===========================
+void runTestCases(Perpustakaan& perpus) {
+    cout << "\n🧪 === RUNNING TEST CASES ===" << endl;
+    cout << "Test cases dari file testcases.txt\n" << endl;
+
+    // Test 1: Tambah 3 item berbeda
+    cout << "\n[TEST 1] Tambah 3 item berbeda" << endl;
+    perpus.tambahItem(Book("B001", "Laskar Pelangi", "Andrea Hirata", false));
+    perpus.tambahItem(Magazine("M001", "National Geographic", "Edisi Januari 2025"));
+    perpus.tambahItem(DVD("D001", "Pengabdi Setan 2", "Joko Anwar"));
+    perpus.sortKatalog();
+
+    // Test 2: Register member dan pinjam
+    cout << "\n[TEST 2] Register member dan pinjam Book" << endl;
+    perpus.registerMember(make_unique<Member>("MEM001", "Budi Santoso"));
+    perpus.prosesPinjam("MEM001", "B001", 10, false);
+
+    // Test 3: Pinjam DVD dan kembalikan telat dengan rusak
+    cout << "\n[TEST 3] Pinjam DVD dan balikin telat + rusak" << endl;
+    perpus.prosesPinjam("MEM001", "D001", 3, false);
+    perpus.prosesKembaliDVD("MEM001", "D001", 5, true);  // telat 2 hari + rusak
+
+    // Test 4: Tambah member baru, pinjam sampe level up
+    cout << "\n[TEST 4] Member baru, pinjam sampai level up" << endl;
+    perpus.registerMember(make_unique<Member>("MEM002", "Siti Nurhaliza"));
+    perpus.tambahItem(Book("B002", "Harry Potter", "JK Rowling", false));
+    perpus.tambahItem(Magazine("M002", "Tempo", "Edisi Februari"));
+    perpus.tambahItem(Book("B003", "Ronggeng Dukuh Paruk", "Ahmad Tohari", true));
+    
+    // Pinjam 5 kali buat naik ke level 1
+    for (int i = 0; i < 5; i++) {
+        perpus.prosesPinjam("MEM002", "M002", 5, false);
+        perpus.prosesKembali("MEM002", "M002", 5);
+    }
+
+    // Test 5: Pake kredit gratis
+    cout << "\n[TEST 5] Pake kredit gratis hasil level up" << endl;
+    perpus.prosesPinjam("MEM002", "B002", 10, true);  // pake kredit
+    perpus.prosesKembali("MEM002", "B002", 10);
+
+    // Test 6: Coba pinjam buku langka lebih dari max hari
+    cout << "\n[TEST 6] Coba pinjam buku langka melebihi max hari" << endl;
+    perpus.prosesPinjam("MEM001", "B003", 10, false);  // buku langka max 3 hari
+
+    // Test 7: Kembalikan tepat waktu
+    cout << "\n[TEST 7] Pinjam dan kembalikan tepat waktu" << endl;
+    perpus.prosesPinjam("MEM001", "B003", 3, false);
+    perpus.prosesKembali("MEM001", "B003", 3);
+
+    // Test 8: Generate laporan bulanan
+    cout << "\n[TEST 8] Generate laporan bulanan" << endl;
+    perpus.laporanBulanan();
+
+    cout << "\n✅ Semua test cases selesai!\n" << endl;
+}
+
+// ===========================
+// MODE HEADLESS
+// ===========================
+// buat disetir script / program lain tanpa prompt:
+//   ./sistem --headless perintah.txt > jawaban.txt     (atau --headless - buat stdin)
+// protokol teks: satu perintah per baris, kolom dipisah '|', baris kosong
+// sama '#' di-skip (ga dapet jawaban):
+//   book|<id>|<judul>|<penulis>|<langka 0/1>
+//   majalah|<id>|<judul>|<edisi>
+//   dvd|<id>|<judul>|<sutradara>
+//   alat|<id>|<nama>|<elektronik 0/1>|<daya/bahan>
+//   member|<id>|<nama>
+//   pinjam|<idMember>|<idItem>|<hari>|<kredit 0/1>
+//   kembali|<idMember>|<idItem>|<hariAktual>
+//   kembalidvd|<idMember>|<idDVD>|<hariAktual>|<rusak 0/1>
+//   sort, reset, simpan, laporan, riwayat|<nBulan>, terlambat
+//   cari|<kata kunci>|<cuma tersedia 0/1>
+//   ekspor|<katalog|member>|<csv|jsonl>|<path>
+//   metrik (counter + histogram latensi format Prometheus)
+//   reservasi|<idMember>|<idItem>     (masuk antrean judul yang eksemplarnya abis)
+//   eksemplar|<idItem>|<jumlah>       (ganti total eksemplar satu judul)
+//   antrean|<idItem>
+//   riwayatmember|<idMember>          (pinjaman yang udah dibalikin member itu)
+//   toppeminjam|<semua|Book|Magazine|DVD|Alat>|<k>
+// tiap perintah dapet satu baris jawaban, urutannya sama kaya input:
+//   OK [kredit] [levelup] [denda=<rupiah>] [diteruskan]  |  ERR <STATUS>  |  ERR FORMAT baris <n>: <pesan>
+// "diteruskan" = eksemplar yang dibalikin langsung dipinjemin ke antrean reservasi.
+// simpan pas --persisten 0 dijawab ERR IO (ga nimpa snapshot asli), lewat
+// server simpan + ekspor selalu ERR IO.
+// laporan/riwayat/terlambat/cari/metrik/antrean/riwayatmember/toppeminjam jawabannya
+// "TEKS <n>" terus n baris teks
+// yang sama kaya di menu.
+//
+// protokol biner (--format biner), per frame: [u32 panjang][u8 kode][isi].
+// panjang = 1 + ukuran isi, kode = urutan perintah di atas mulai 1 (book=1 ..
+// simpan=11), isi pake encoding PenulisBiner (string = u32 + byte, angka i32,
+// 0/1 = u8) dengan urutan kolom yang sama. jawabannya fix 11 byte per frame:
+// [u8 kode][u8 status][u8 flag][f64 denda], flag bit0 kredit, bit1 naik level,
+// bit2 diteruskan ke antrean reservasi.
+// perintah laporan cuma ada di protokol teks
+//
+// input dibaca per blok gede, pinjam/kembali yang berurutan dikumpulin terus
+// dijalanin lewat prosesBatch (hasilnya sama persis kaya satu2), jawabannya
+// ditulis thread lain. perintah selain transaksi nge-flush batch dulu
+struct Perintah {
+    enum Kode : uint8_t {
+        KOSONG = 0,
+        TAMBAH_BOOK,
+        TAMBAH_MAJALAH,
+        TAMBAH_DVD,
+        TAMBAH_ALAT,
+        REGISTER_MEMBER,
+        PINJAM,
+        KEMBALI,
+        KEMBALI_DVD,
+        SORT,
+        RESET,
+        SIMPAN,  // kode terakhir yang ada di protokol biner
+        LAPORAN,
+        RIWAYAT,
+        TERLAMBAT,
+        CARI,
+        EKSPOR,
+        METRIK,
+        RESERVASI,
+        EKSEMPLAR,
+        ANTREAN,
+        RIWAYAT_MEMBER,
+        TOP_PEMINJAM,
+        JUMLAH_KODE
+    };
+    Kode kode = KOSONG;
+    string_view teks[3];  // kolom string sesuai urutan
+    int32_t angka = 0;    // kolom 'i'
+    bool flag = false;    // kolom 0/1
+};
+
+// nama di protokol teks + pola kolomnya: s = string, i = angka >= 0, f = 0/1
+struct SpesPerintah {
+    const char* nama;
+    const char* pola;
+};
+
+const SpesPerintah SPES_PERINTAH[Perintah::JUMLAH_KODE] = {
+    {"", ""},           {"book", "sssf"},  {"majalah", "sss"}, {"dvd", "sss"},      {"alat", "ssfs"},
+    {"member", "ss"},   {"pinjam", "ssif"}, {"kembali", "ssi"}, {"kembalidvd", "ssif"},
+    {"sort", ""},       {"reset", ""},     {"simpan", ""},     {"laporan", ""},     {"riwayat", "i"},
+    {"terlambat", ""},  {"cari", "sf"},    {"ekspor", "sss"},  {"metrik", ""},      {"reservasi", "ss"},
+    {"eksemplar", "si"}, {"antrean", "s"},  {"riwayatmember", "s"}, {"toppeminjam", "si"}};
+
+// status jawaban biner di luar StatusTransaksi
+constexpr uint8_t STATUS_FORMAT = 0xFF;  // frame/baris ga valid
+constexpr uint8_t STATUS_IO = 0xFE;      // simpan/ekspor gagal nulis file
+
+// parse satu baris protokol teks. baris kosong/komentar = kode KOSONG.
+// false + `pesan` kalo formatnya salah
+bool parsePerintahTeks(string_view baris, Perintah& p, string& pesan) {
+    if (!baris.empty() && baris.back() == '\r') baris.remove_suffix(1);
+    p = Perintah();
+    if (baris.empty() || baris[0] == '#') return true;
+
+    string_view kolom[6];
+    size_t n = 0, mulai = 0;
+    while (true) {
+        size_t akhir = baris.find('|', mulai);
+        if (n == 6) {
+            pesan = "kebanyakan kolom";
+            return false;
+        }
+        kolom[n++] = baris.substr(mulai, akhir == string_view::npos ? string_view::npos : akhir - mulai);
+        if (akhir == string_view::npos) break;
+        mulai = akhir + 1;
+    }
+
+    int kode = 1;
+    while (kode < Perintah::JUMLAH_KODE && kolom[0] != SPES_PERINTAH[kode].nama) kode++;
+    if (kode == Perintah::JUMLAH_KODE) {
+        pesan = "perintah '" + string(kolom[0]) + "' ga dikenal";
+        return false;
+    }
+    const char* pola = SPES_PERINTAH[kode].pola;
+    if (strlen(pola) != n - 1) {
+        pesan = string(kolom[0]) + " butuh " + to_string(strlen(pola)) + " kolom, dapet " + to_string(n - 1);
+        return false;
+    }
+
+    size_t nTeks = 0;
+    for (size_t i = 0; pola[i]; i++) {
+        string_view t = kolom[i + 1];
+        if (pola[i] == 's') {
+            p.teks[nTeks++] = t;
+        } else if (pola[i] == 'i') {
+            int nilai;
+            if (!parseInt(t, nilai)) {
+                pesan = "kolom " + to_string(i + 1) + " harus angka";
+                return false;
+            }
+            p.angka = nilai;
+        } else {
+            if (t != "0" && t != "1") {
+                pesan = "kolom " + to_string(i + 1) + " harus 0/1";
+                return false;
+            }
+            p.flag = t == "1";
+        }
+    }
+    p.kode = static_cast<Perintah::Kode>(kode);
+    return true;
+}
+
+// parse satu frame biner tanpa header panjang: [u8 kode][isi]
+bool parsePerintahBiner(string_view frame, Perintah& p) {
+    p = Perintah();
+    PembacaBiner in(frame.data(), frame.size());
+    uint8_t kode = in.baca<uint8_t>();
+    if (kode == Perintah::KOSONG || kode > Perintah::SIMPAN) return false;
+    size_t nTeks = 0;
+    for (const char* c = SPES_PERINTAH[kode].pola; *c; c++) {
+        if (*c == 's') {
+            p.teks[nTeks++] = in.bacaString();
+        } else if (*c == 'i') {
+            p.angka = in.baca<int32_t>();
+            if (p.angka < 0) return false;
+        } else {
+            uint8_t f = in.baca<uint8_t>();
+            if (f > 1) return false;
+            p.flag = f;
+        }
+    }
+    p.kode = static_cast<Perintah::Kode>(kode);
+    return in.isOk() && in.sisa() == 0;
+}
+
+// input dibaca per blok gede. baris/frame yang dibalikin nunjuk ke buffer
+// ini, jadi cuma valid sampe isiUlang berikutnya
+class PembacaAliran {
+private:
+    FILE* f;
+    vector<char> buf;
+    size_t mulai, akhir;
+    bool eof;
+
+    static constexpr uint32_t BATAS_FRAME = 64 << 20;
+
+    size_t bacaBlok(char* tujuan, size_t n) {
+#ifdef PERPUS_POSIX
+        // read() balik begitu ada data - penting kalo inputnya pipe dari
+        // program yang nungguin jawaban dulu sebelum ngirim perintah berikutnya
+        ssize_t r;
+        do {
+            r = read(fileno(f), tujuan, n);
+        } while (r < 0 && errno == EINTR);
+        return r > 0 ? static_cast<size_t>(r) : 0;
+#else
+        return fread(tujuan, 1, n, f);
+#endif
+    }
+
+public:
+    explicit PembacaAliran(FILE* f, size_t kapasitas = 1 << 20)
+        : f(f), buf(kapasitas), mulai(0), akhir(0), eof(false) {}
+
+    // baris terakhir yang ga ada '\n'-nya tetep dibalikin pas udah EOF
+    bool ambilBaris(string_view& baris) {
+        const char* p = buf.data();
+        const void* nl = memchr(p + mulai, '\n', akhir - mulai);
+        if (!nl) {
+            if (!eof || mulai == akhir) return false;
+            baris = string_view(p + mulai, akhir - mulai);
+            mulai = akhir;
+            return true;
+        }
+        size_t pos = static_cast<const char*>(nl) - p;
+        baris = string_view(p + mulai, pos - mulai);
+        mulai = pos + 1;
+        return true;
+    }
+
+    // satu frame utuh tanpa header panjang
+    bool ambilFrame(string_view& frame) {
+        if (akhir - mulai < sizeof(uint32_t)) return false;
+        uint32_t n;
+        memcpy(&n, buf.data() + mulai, sizeof(n));
+        if (n == 0 || n > BATAS_FRAME || akhir - mulai - sizeof(n) < n) return false;
+        frame = string_view(buf.data() + mulai + sizeof(n), n);
+        mulai += sizeof(n) + n;
+        return true;
+    }
+
+    // header frame berikutnya ga masuk akal - stream-nya udah ga bisa diikutin
+    bool frameRusak() const {
+        if (akhir - mulai < sizeof(uint32_t)) return false;
+        uint32_t n;
+        memcpy(&n, buf.data() + mulai, sizeof(n));
+        return n == 0 || n > BATAS_FRAME;
+    }
+
+    // geser sisa ke depan terus baca lagi. false = udah EOF dan ga ada yang
+    // bisa diproses lagi
+    bool isiUlang() {
+        if (eof) return false;
+        memmove(buf.data(), buf.data() + mulai, akhir - mulai);
+        akhir -= mulai;
+        mulai = 0;
+        if (akhir == buf.size()) buf.resize(buf.size() * 2);  // baris/frame lebih gede dari buffer
+        size_t n = bacaBlok(buf.data() + akhir, buf.size() - akhir);
+        if (n == 0) {
+            eof = true;
+            return akhir > 0;
+        }
+        akhir += n;
+        return true;
+    }
+
+    size_t sisa() const { return akhir - mulai; }
+};
+
+// keluaran yang ditulis thread sendiri: pemanggil cuma nambahin ke buffer
+// depan, pas penuh buffernya dituker sama yang nganggur terus thread penulis
+// yang fwrite. kalo penulisnya ketinggalan, pemanggil nunggu - maksimal dua
+// buffer di memori
+class PenulisAsinkron {
+private:
+    FILE* f;
+    size_t batas;
+    string depan, belakang;
+    bool adaKiriman, berhenti;
+    size_t total;
+    mutex mtx;
+    condition_variable cv;
+    thread penulis;
+
+    void loop() {
+        unique_lock<mutex> lk(mtx);
+        while (true) {
+            cv.wait(lk, [&] { return adaKiriman || berhenti; });
+            if (!adaKiriman) break;
+            lk.unlock();
+            fwrite(belakang.data(), 1, belakang.size(), f);
+            fflush(f);
+            lk.lock();
+            belakang.clear();
+            adaKiriman = false;
+            cv.notify_all();
+        }
+    }
+
+public:
+    explicit PenulisAsinkron(FILE* f, size_t batas = 1 << 18)
+        : f(f), batas(batas), adaKiriman(false), berhenti(false), total(0) {
+        depan.reserve(batas + 4096);
+        belakang.reserve(batas + 4096);
+        penulis = thread([this] { loop(); });
+    }
+
+    ~PenulisAsinkron() { tutup(); }
+
+    PenulisAsinkron(const PenulisAsinkron&) = delete;
+    PenulisAsinkron& operator=(const PenulisAsinkron&) = delete;
+
+    // buffer depan buat ditambahin langsung, abis itu panggil cekPenuh()
+    string& isi() { return depan; }
+
+    void tambah(string_view s) {
+        depan.append(s.data(), s.size());
+        cekPenuh();
+    }
+
+    void cekPenuh() {
+        if (depan.size() >= batas) kirim();
+    }
+
+    // serahin isi buffer depan ke thread penulis (ga nunggu ditulis)
+    void kirim() {
+        if (depan.empty()) return;
+        unique_lock<mutex> lk(mtx);
+        cv.wait(lk, [&] { return !adaKiriman; });
+        total += depan.size();
+        swap(depan, belakang);
+        adaKiriman = true;
+        cv.notify_all();
+    }
+
+    // kirim + tunggu sampe beneran udah ditulis
+    void flush() {
+        kirim();
+        unique_lock<mutex> lk(mtx);
+        cv.wait(lk, [&] { return !adaKiriman; });
+    }
+
+    void tutup() {
+        if (!penulis.joinable()) return;
+        flush();
+        {
+            lock_guard<mutex> lk(mtx);
+            berhenti = true;
+        }
+        cv.notify_all();
+        penulis.join();
+    }
+
+    size_t jumlahByte() const { return total + depan.size(); }
+};
+
+// tampung semua yang ditulis ke cout selama f() jalan. rdbuf-nya global,
+// jadi dua thread yang nangkep barengan harus gantian
+template <typename F>
+string tangkapCout(F&& f) {
+    static mutex mtx;
+    lock_guard<mutex> lk(mtx);
+    ostringstream ss;
+    streambuf* lama = cout.rdbuf(ss.rdbuf());
+    f();
+    cout.rdbuf(lama);
+    return ss.str();
+}
+
+// perintah yang nulis file di disk - dimatiin kalo yang nyuruh ga berhak.
+// simpan = checkpoint ke FILE_SNAPSHOT: cuma buat run yang emang lanjutin
+// snapshot itu (--persisten 1), run coba2 ga boleh nimpa data asli.
+// ekspor = nulis ke path bebas dari klien. server matiin dua2nya: siapa aja
+// yang bisa konek ke socket-nya bisa nimpa file apa aja punya proses ini
+struct IzinFile {
+    bool simpan = true;
+    bool ekspor = true;
+};
+
+// jalanin Perintah ke Perpustakaan + tulis jawabannya ke `keluar`. kalo
+// `penulis` dikasih, `keluar` itu buffer-nya dan dikirim tiap penuh
+class EksekutorHeadless {
+private:
+    Perpustakaan& perpus;
+    string& keluar;
+    PenulisAsinkron* penulis;
+    bool biner;
+    IzinFile izin;
+    vector<PermintaanTransaksi> batch;
+    size_t jumlahPerintah, jumlahError;
+    Perintah perintah;  // buffer parse jalankanBaris
+    string pesan;
+
+    static constexpr size_t MAKS_BATCH = 4096;
+
+    void jawab(Perintah::Kode kode, uint8_t status, bool kredit, bool naikLevel, double denda,
+               bool diteruskan = false) {
+        jumlahPerintah++;
+        jumlahError += status != 0;
+        string& s = keluar;
+        if (biner) {
+            char rec[11];
+            rec[0] = static_cast<char>(kode);
+            rec[1] = static_cast<char>(status);
+            rec[2] = static_cast<char>(kredit | (naikLevel << 1) | (diteruskan << 2));
+            memcpy(rec + 3, &denda, sizeof(denda));
+            s.append(rec, sizeof(rec));
+        } else if (status == 0) {
+            s += "OK";
+            if (kredit) s += " kredit";
+            if (naikLevel) s += " levelup";
+            if (denda > 0) {
+                char tmp[40];
+                snprintf(tmp, sizeof(tmp), " denda=%.0f", denda);
+                s += tmp;
+            }
+            if (diteruskan) s += " diteruskan";
+            s += '\n';
+        } else {
+            s += "ERR ";
+            s += status == STATUS_IO ? "IO" : namaStatus(static_cast<StatusTransaksi>(status));
+            s += '\n';
+        }
+        cekPenuh();
+    }
+
+    void cekPenuh() {
+        if (penulis) penulis->cekPenuh();
+    }
+
+    void jawab(Perintah::Kode kode, const HasilTransaksi& h) {
+        jawab(kode, static_cast<uint8_t>(h.status), h.ok() && h.pakeKredit, h.naikLevel, h.denda,
+              h.ok() && h.diteruskan);
+    }
+
+    void jawab(Perintah::Kode kode, bool ok, StatusTransaksi gagal) {
+        jawab(kode, ok ? 0 : static_cast<uint8_t>(gagal), false, false, 0.0);
+    }
+
+    // jawaban multi-baris: header "TEKS <jumlah baris>" terus baris2-nya
+    void jawabTeks(const string& teks) {
+        jumlahPerintah++;
+        size_t nBaris = count(teks.begin(), teks.end(), '\n');
+        bool kurangNewline = !teks.empty() && teks.back() != '\n';
+        keluar += "TEKS " + to_string(nBaris + kurangNewline) + "\n";
+        keluar += teks;
+        if (kurangNewline) keluar += '\n';
+        cekPenuh();
+    }
+
+public:
+    EksekutorHeadless(Perpustakaan& perpus, string& keluar, bool biner, PenulisAsinkron* penulis = nullptr,
+                      IzinFile izin = {})
+        : perpus(perpus), keluar(keluar), penulis(penulis), biner(biner), izin(izin), jumlahPerintah(0),
+          jumlahError(0) {
+        batch.reserve(MAKS_BATCH);
+    }
+
+    void gagalFormat(Perintah::Kode kode, size_t baris, const string& pesan) {
+        flushBatch();  // jawabannya tetep harus urut
+        if (biner) {
+            jawab(kode, STATUS_FORMAT, false, false, 0.0);
+            return;
+        }
+        jumlahPerintah++;
+        jumlahError++;
+        keluar += "ERR FORMAT baris " + to_string(baris) + ": " + pesan + "\n";
+        cekPenuh();
+    }
+
+    void jalankan(const Perintah& p, size_t baris) {
+        PermintaanTransaksi::Jenis jenis;
+        switch (p.kode) {
+            case Perintah::PINJAM: jenis = PermintaanTransaksi::PINJAM; break;
+            case Perintah::KEMBALI: jenis = PermintaanTransaksi::KEMBALI; break;
+            case Perintah::KEMBALI_DVD: jenis = PermintaanTransaksi::KEMBALI_DVD; break;
+            default: jenis = PermintaanTransaksi::PINJAM; flushBatch();
+        }
+
+        const string_view* t = p.teks;
+        switch (p.kode) {
+            case Perintah::PINJAM:
+            case Perintah::KEMBALI:
+            case Perintah::KEMBALI_DVD:
+                batch.push_back({jenis, p.flag, p.angka, t[0], t[1]});
+                if (batch.size() >= MAKS_BATCH) flushBatch();
+                break;
+            case Perintah::TAMBAH_BOOK:
+                jawab(p.kode, perpus.tambahItem(Book(t[0], t[1], t[2], p.flag)),
+                      StatusTransaksi::ID_DUPLIKAT);
+                break;
+            case Perintah::TAMBAH_MAJALAH:
+                jawab(p.kode, perpus.tambahItem(Magazine(t[0], t[1], t[2])),
+                      StatusTransaksi::ID_DUPLIKAT);
+                break;
+            case Perintah::TAMBAH_DVD:
+                jawab(p.kode, perpus.tambahItem(DVD(t[0], t[1], t[2])),
+                      StatusTransaksi::ID_DUPLIKAT);
+                break;
+            case Perintah::TAMBAH_ALAT:
+                jawab(p.kode, perpus.tambahItem(Alat(t[0], t[1], p.flag, t[2])),
+                      StatusTransaksi::ID_DUPLIKAT);
+                break;
+            case Perintah::REGISTER_MEMBER:
+                jawab(p.kode, perpus.registerMember(perpus.buatMember(t[0], t[1])), StatusTransaksi::ID_DUPLIKAT);
+                break;
+            case Perintah::SORT:
+                perpus.sortKatalog();
+                jawab(p.kode, true, StatusTransaksi::SUKSES);
+                break;
+            case Perintah::RESET:
+                perpus.resetStatistikBulanan();
+                jawab(p.kode, true, StatusTransaksi::SUKSES);
+                break;
+            case Perintah::SIMPAN:
+                jawab(p.kode, izin.simpan && perpus.checkpoint(FILE_SNAPSHOT) ? 0 : STATUS_IO, false, false, 0.0);
+                break;
+            case Perintah::LAPORAN:
+                jawabTeks(tangkapCout([&] { perpus.laporanBulanan(); }));
+                break;
+            case Perintah::RIWAYAT:
+                jawabTeks(tangkapCout([&] { perpus.laporanRiwayat(max(1, p.angka)); }));
+                break;
+            case Perintah::TERLAMBAT:
+                jawabTeks(tangkapCout([&] { perpus.tampilkanTerlambat(); }));
+                break;
+            case Perintah::CARI:
+                jawabTeks(tangkapCout([&] { perpus.tampilkanHasilCari(t[0], p.flag); }));
+                break;
+            case Perintah::METRIK:
+                jawabTeks(formatPrometheus(metrik.baca()));
+                break;
+            case Perintah::RESERVASI:
+                jawab(p.kode, perpus.prosesReservasi(string(t[0]), string(t[1])));
+                break;
+            case Perintah::EKSEMPLAR:
+                jawab(p.kode, perpus.aturEksemplar(string(t[0]), static_cast<uint32_t>(p.angka)));
+                break;
+            case Perintah::ANTREAN:
+                jawabTeks(tangkapCout([&] { perpus.tampilkanAntrean(string(t[0])); }));
+                break;
+            case Perintah::RIWAYAT_MEMBER:
+                jawabTeks(tangkapCout([&] { perpus.tampilkanRiwayatMember(string(t[0])); }));
+                break;
+            case Perintah::TOP_PEMINJAM: {
+                uint8_t kode = 1;
+                while (kode < JUMLAH_KODE_TIPE && t[0] != NAMA_TIPE[kode]) kode++;
+                if (t[0] == "semua") kode = 0;
+                if (kode == JUMLAH_KODE_TIPE) {
+                    gagalFormat(p.kode, baris, "toppeminjam|<semua|Book|Magazine|DVD|Alat>|<k>");
+                    break;
+                }
+                jawabTeks(tangkapCout([&] { perpus.tampilkanTopPeminjam(static_cast<size_t>(p.angka), kode); }));
+                break;
+            }
+            case Perintah::EKSPOR: {
+                bool member = t[0] == "member";
+                if ((!member && t[0] != "katalog") || (t[1] != "csv" && t[1] != "jsonl")) {
+                    gagalFormat(p.kode, baris, "ekspor|<katalog|member>|<csv|jsonl>|<path>");
+                    break;
+                }
+                FormatListing fmt = t[1] == "csv" ? FormatListing::CSV : FormatListing::JSONL;
+                string path(t[2]);
+                bool ok = izin.ekspor && (member ? perpus.eksporMember(path, fmt) : perpus.eksporKatalog(path, fmt));
+                jawab(p.kode, ok ? 0 : STATUS_IO, false, false, 0.0);
+                break;
+            }
+            default:
+                break;
+        }
+    }
+
+    // satu baris protokol teks
+    void jalankanBaris(string_view baris, size_t nomor) {
+        if (!parsePerintahTeks(baris, perintah, pesan)) gagalFormat(Perintah::KOSONG, nomor, pesan);
+        else if (perintah.kode != Perintah::KOSONG) jalankan(perintah, nomor);
+    }
+
+    // batch nunjuk ke buffer input - harus beres sebelum buffernya digeser
+    void flushBatch() {
+        if (batch.empty()) return;
+        vector<HasilTransaksi> hasil = perpus.prosesBatch(batch);
+        for (size_t i = 0; i < batch.size(); i++) {
+            Perintah::Kode kode = batch[i].jenis == PermintaanTransaksi::PINJAM    ? Perintah::PINJAM
+                                  : batch[i].jenis == PermintaanTransaksi::KEMBALI ? Perintah::KEMBALI
+                                                                                   : Perintah::KEMBALI_DVD;
+            jawab(kode, hasil[i]);
+        }
+        batch.clear();
+    }
+
+    size_t getJumlahPerintah() const { return jumlahPerintah; }
+    size_t getJumlahError() const { return jumlahError; }
+};
+
+struct HasilHeadless {
+    size_t perintah = 0;
+    size_t error = 0;
+    size_t byteKeluar = 0;
+    bool inputRusak = false;  // biner: frame kepotong / header ngaco
+};
+
+// baca perintah dari `masuk` sampe EOF, jawabannya ke `keluar`
+HasilHeadless jalankanHeadless(Perpustakaan& perpus, FILE* masuk, FILE* keluar, bool biner, IzinFile izin = {}) {
+    PembacaAliran in(masuk);
+    PenulisAsinkron out(keluar);
+    EksekutorHeadless eks(perpus, out.isi(), biner, &out, izin);
+    HasilHeadless hasil;
+    Perintah p;
+    size_t nomor = 0;
+
+    while (in.isiUlang()) {
+        string_view potong;
+        if (biner) {
+            while (in.ambilFrame(potong)) {
+                nomor++;
+                if (parsePerintahBiner(potong, p)) eks.jalankan(p, nomor);
+                else eks.gagalFormat(static_cast<Perintah::Kode>(potong[0]), nomor, "frame ga valid");
+            }
+            if (in.frameRusak()) {
+                hasil.inputRusak = true;
+                break;
+            }
+        } else {
+            while (in.ambilBaris(potong)) eks.jalankanBaris(potong, ++nomor);
+        }
+        eks.flushBatch();
+        // biar yang nyetir lewat pipe dapet jawabannya sebelum kita nunggu input lagi
+        out.kirim();
+    }
+    if (biner && in.sisa() > 0) hasil.inputRusak = true;
+    eks.flushBatch();
+    out.tutup();
+
+    hasil.perintah = eks.getJumlahPerintah();
+    hasil.error = eks.getJumlahError();
+    hasil.byteKeluar = out.jumlahByte();
+    return hasil;
+}
+
+// ./sistem --headless <path|-> [--format teks|biner] [--persisten 0|1] [--event <path>]
+// persisten (bawaan 1) = lanjutin snapshot + WAL kaya menu, checkpoint pas
+// input abis. --event = semua event transaksi ditulis biner (SinkBiner) ke
+// file itu. ringkasan ke stderr biar stdout isinya jawaban doang
+int modeHeadless(const string& path, bool biner, bool persisten, const char* pathEvent) {
+    FILE* masuk = path == "-" ? stdin : fopen(path.c_str(), "rb");
+    if (!masuk) {
+        cerr << "❌ File perintah " << path << " ga bisa dibuka" << endl;
+        return 1;
+    }
+
+    unique_ptr<SinkBiner> sinkEvent;
+    if (pathEvent) {
+        sinkEvent = make_unique<SinkBiner>(pathEvent);
+        if (!sinkEvent->valid()) {
+            cerr << "❌ File event " << pathEvent << " ga bisa dibuat" << endl;
+            if (masuk != stdin) fclose(masuk);
+            return 1;
+        }
+    }
+
+    Perpustakaan perpus;
+    if (persisten) {
+        if (perpus.muatSnapshot(FILE_SNAPSHOT)) cerr << "📂 Data dimuat dari " << FILE_SNAPSHOT << endl;
+        size_t dipulihkan = perpus.aktifkanLog(FILE_LOG);
+        if (dipulihkan > 0) cerr << "🔁 " << dipulihkan << " transaksi dipulihin dari " << FILE_LOG << endl;
+    }
+    // dipasang abis replay WAL biar file event isinya transaksi sesi ini doang
+    if (sinkEvent) perpus.pasangSink(sinkEvent.get());
+
+    auto mulai = chrono::steady_clock::now();
+    IzinFile izin;
+    izin.simpan = persisten;  // tanpa persisten, `simpan` jawabnya ERR IO
+    HasilHeadless hasil = jalankanHeadless(perpus, masuk, stdout, biner, izin);
+    double detik = chrono::duration<double>(chrono::steady_clock::now() - mulai).count();
+    if (masuk != stdin) fclose(masuk);
+
+    cerr << "📊 " << hasil.perintah << " perintah (" << hasil.error << " gagal) dalam " << fixed
+         << setprecision(3) << detik << " s" << endl;
+    if (hasil.inputRusak) cerr << "⚠️  Input biner kepotong / frame ga valid, sisanya di-skip" << endl;
+    if (perpus.logRusak()) cerr << "⚠️  " << FILE_LOG << " sempet gagal ditulis" << endl;
+    if (sinkEvent) {
+        perpus.pasangSink(nullptr);
+        if (!sinkEvent->tutup()) cerr << "⚠️  " << pathEvent << " sempet gagal ditulis, event-nya ga lengkap" << endl;
+    }
+    if (persisten && !perpus.checkpoint(FILE_SNAPSHOT)) {
+        cerr << "⚠️  Gagal nyimpen data ke " << FILE_SNAPSHOT << endl;
+        return 1;
+    }
+    return hasil.inputRusak ? 1 : 0;
+}
+
+#ifdef PERPUS_EPOLL
+// ===========================
+// MODE SERVER
+// ===========================
+// beberapa meja sirkulasi pake satu Perpustakaan bareng lewat socket lokal:
+//   ./sistem --server unix:/tmp/perpus.sock      atau      ./sistem --server tcp:7070
+// (tcp cuma dengerin 127.0.0.1). protokolnya sama persis kaya headless teks:
+// satu perintah per baris, satu jawaban per perintah, urutannya kejaga.
+// klien boleh ngirim banyak perintah sekaligus tanpa nunggu jawaban
+// (pipelining). satu thread epoll ngurus semua socket, perintah yang udah
+// utuh dikirim sekaligus ke kolam pekerja - per koneksi cuma boleh satu
+// tugas jalan, sisanya nunggu di buffer. berhenti pake Ctrl+C / SIGTERM
+
+// kolam thread sederhana: satu antrian bareng, yang nganggur ambil duluan
+class KolamPekerja {
+private:
+    vector<thread> pekerja;
+    vector<function<void()>> antrian;
+    size_t kepala;  // tugas berikutnya di antrian
+    mutex mtx;
+    condition_variable cv;
+    bool berhenti;
+
+    void loop() {
+        unique_lock<mutex> lk(mtx);
+        while (true) {
+            cv.wait(lk, [&] { return kepala < antrian.size() || berhenti; });
+            if (kepala == antrian.size()) break;
+            function<void()> tugas = move(antrian[kepala++]);
+            if (kepala == antrian.size()) {
+                antrian.clear();
+                kepala = 0;
+            }
+            lk.unlock();
+            tugas();
+            lk.lock();
+        }
+    }
+
+public:
+    explicit KolamPekerja(unsigned n) : kepala(0), berhenti(false) {
+        for (unsigned i = 0; i < max(1u, n); i++) pekerja.emplace_back([this] { loop(); });
+    }
+
+    ~KolamPekerja() { tutup(); }
+
+    void kirim(function<void()> tugas) {
+        {
+            lock_guard<mutex> lk(mtx);
+            antrian.push_back(move(tugas));
+        }
+        cv.notify_one();
+    }
+
+    // tugas yang udah masuk tetep diberesin dulu
+    void tutup() {
+        {
+            lock_guard<mutex> lk(mtx);
+            berhenti = true;
+        }
+        cv.notify_all();
+        for (auto& t : pekerja) {
+            if (t.joinable()) t.join();
+        }
+    }
+
+    size_t jumlah() const { return pekerja.size(); }
+};
+
+struct AlamatServer {
+    bool unixSocket = false;
+    string path;
+    uint16_t port = 0;
+};
+
+// "unix:<path>", "tcp:<port>" atau port doang
+bool parseAlamat(const string& teks, AlamatServer& alamat) {
+    string_view t = teks;
+    if (t.substr(0, 5) == "unix:") {
+        alamat.unixSocket = true;
+        alamat.path = string(t.substr(5));
+        return !alamat.path.empty() && alamat.path.size() < sizeof(sockaddr_un::sun_path);
+    }
+    if (t.substr(0, 4) == "tcp:") t.remove_prefix(4);
+    int port;
+    if (!parseInt(t, port) || port == 0 || port > 65535) return false;
+    alamat.unixSocket = false;
+    alamat.port = static_cast<uint16_t>(port);
+    return true;
+}
+
+socklen_t isiSockaddr(const AlamatServer& alamat, sockaddr_storage& ss) {
+    memset(&ss, 0, sizeof(ss));
+    if (alamat.unixSocket) {
+        sockaddr_un* un = reinterpret_cast<sockaddr_un*>(&ss);
+        un->sun_family = AF_UNIX;
+        memcpy(un->sun_path, alamat.path.data(), alamat.path.size());
+        return sizeof(sockaddr_un);
+    }
+    sockaddr_in* in = reinterpret_cast<sockaddr_in*>(&ss);
+    in->sin_family = AF_INET;
+    in->sin_port = htons(alamat.port);
+    in->sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    return sizeof(sockaddr_in);
+}
+
+// socket listen non-blocking, -1 kalo gagal
+int bukaSocketServer(const AlamatServer& alamat) {
+    int fd = socket(alamat.unixSocket ? AF_UNIX : AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) return -1;
+    if (alamat.unixSocket) {
+        unlink(alamat.path.c_str());  // sisa server sebelumnya
+    } else {
+        int satu = 1;
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &satu, sizeof(satu));
+    }
+    sockaddr_storage ss;
+    socklen_t n = isiSockaddr(alamat, ss);
+    if (bind(fd, reinterpret_cast<sockaddr*>(&ss), n) < 0 || listen(fd, SOMAXCONN) < 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// koneksi klien (blocking), -1 kalo gagal
+int sambungKe(const AlamatServer& alamat) {
+    int fd = socket(alamat.unixSocket ? AF_UNIX : AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) return -1;
+    sockaddr_storage ss;
+    socklen_t n = isiSockaddr(alamat, ss);
+    if (connect(fd, reinterpret_cast<sockaddr*>(&ss), n) < 0) {
+        close(fd);
+        return -1;
+    }
+    if (!alamat.unixSocket) {
+        int satu = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &satu, sizeof(satu));
+    }
+    return fd;
+}
+
+// sinyal stop cuma nulis ke eventfd - sisanya diurus loop epoll
+volatile sig_atomic_t sinyalBerhentiServer = 0;
+atomic<int> fdSinyalServer(-1);
+
+extern "C" void tanganiSinyalServer(int) {
+    sinyalBerhentiServer = 1;
+    int fd = fdSinyalServer.load();
+    if (fd >= 0) {
+        uint64_t satu = 1;
+        ssize_t r = write(fd, &satu, sizeof(satu));
+        (void)r;
+    }
+}
+
+class ServerPerpustakaan {
+public:
+    struct Statistik {
+        size_t koneksi = 0;
+        size_t perintah = 0;
+        size_t error = 0;
+        size_t tugas = 0;  // kiriman ke kolam - perintah/tugas = rata2 pipelining
+    };
+
+private:
+    struct Koneksi {
+        int fd;
+        string masuk;
+        string keluar;
+        size_t posKeluar = 0;
+        size_t nomorBaris = 0;   // buat pesan ERR FORMAT
+        bool sibuk = false;      // ada tugas di kolam pekerja
+        bool tutupBaca = false;  // klien udah selesai ngirim
+        uint32_t minat = 0;      // event epoll yang lagi didaftarin
+    };
+
+    struct Selesai {
+        uint64_t id;
+        string jawaban;
+        size_t baris, perintah, error;
+    };
+
+    // kalo yang masuk / jawaban yang belum kekirim numpuk segini, berhenti
+    // baca dari koneksi itu dulu (klien yang ngirim doang tanpa baca).
+    // satu baris segini tanpa '\n' = ERR FORMAT terus koneksinya ditutup
+    static constexpr size_t BATAS_BUFFER = 4 << 20;
+    static constexpr uint64_t ID_LISTEN = 0, ID_BANGUN = 1;
+
+    Perpustakaan& perpus;
+    int fdListen, fdEpoll, fdBangun;
+    map<uint64_t, Koneksi> koneksi;  // id koneksi (bukan fd, fd bisa kepake ulang)
+    uint64_t idBerikut;
+    atomic<bool> berhenti;
+    Statistik stat;
+    mutex mtxSelesai;
+    vector<Selesai> selesai;
+    KolamPekerja kolam;  // paling akhir biar pekerjanya mati duluan
+
+    void daftar(int fd, uint32_t ev, uint64_t id, int op = EPOLL_CTL_ADD) {
+        epoll_event e{};
+        e.events = ev;
+        e.data.u64 = id;
+        epoll_ctl(fdEpoll, op, fd, &e);
+    }
+
+    void aturMinat(uint64_t id, Koneksi& k) {
+        size_t belumKirim = k.keluar.size() - k.posKeluar;
+        uint32_t ev = 0;
+        if (!k.tutupBaca && k.masuk.size() < BATAS_BUFFER && belumKirim < BATAS_BUFFER) ev |= EPOLLIN;
+        if (belumKirim > 0) ev |= EPOLLOUT;
+        if (ev == k.minat) return;
+        daftar(k.fd, ev, id, EPOLL_CTL_MOD);
+        k.minat = ev;
+    }
+
+    void tutup(map<uint64_t, Koneksi>::iterator it) {
+        close(it->second.fd);
+        koneksi.erase(it);  // tugas yang masih jalan jawabannya dibuang
+    }
+
+    void terima() {
+        while (true) {
+            int fd = accept4(fdListen, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (fd < 0) return;
+            int satu = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &satu, sizeof(satu));  // gagal di unix socket, gapapa
+            uint64_t id = idBerikut++;
+            Koneksi& k = koneksi[id];
+            k.fd = fd;
+            k.minat = EPOLLIN;
+            daftar(fd, EPOLLIN, id);
+            stat.koneksi++;
+        }
+    }
+
+    // false = koneksinya putus
+    bool tulis(Koneksi& k) {
+        while (k.posKeluar < k.keluar.size()) {
+            ssize_t n = send(k.fd, k.keluar.data() + k.posKeluar, k.keluar.size() - k.posKeluar, MSG_NOSIGNAL);
+            if (n > 0) {
+                k.posKeluar += n;
+            } else if (n < 0 && errno == EINTR) {
+                continue;
+            } else {
+                return n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK);
+            }
+        }
+        k.keluar.clear();
+        k.posKeluar = 0;
+        return true;
+    }
+
+    bool baca(Koneksi& k) {
+        char tmp[1 << 16];
+        while (k.masuk.size() < BATAS_BUFFER) {
+            ssize_t n = read(k.fd, tmp, sizeof(tmp));
+            if (n > 0) {
+                k.masuk.append(tmp, n);
+            } else if (n == 0) {
+                k.tutupBaca = true;
+                return true;
+            } else if (errno == EINTR) {
+                continue;
+            } else {
+                return errno == EAGAIN || errno == EWOULDBLOCK;
+            }
+        }
+        return true;
+    }
+
+    // semua baris yang udah utuh dikirim jadi satu tugas
+    void kirimTugas(uint64_t id, Koneksi& k) {
+        if (k.sibuk || k.keluar.size() - k.posKeluar >= BATAS_BUFFER) return;
+        size_t akhir = k.masuk.rfind('\n');
+        if (akhir == string::npos) {
+            if (k.masuk.size() >= BATAS_BUFFER) {
+                // buffer penuh tapi barisnya belum kelar - EPOLLIN udah dimatiin,
+                // jadi kalo didiemin koneksinya nyangkut selamanya. tolak, abis
+                // jawabannya kekirim koneksinya ditutup (lihat lanjut)
+                k.keluar += "ERR FORMAT baris " + to_string(k.nomorBaris + 1) + ": baris lebih dari " +
+                            to_string(BATAS_BUFFER) + " byte\n";
+                string().swap(k.masuk);
+                k.tutupBaca = true;
+                stat.perintah++;
+                stat.error++;
+                return;
+            }
+            if (!k.tutupBaca || k.masuk.empty()) return;
+            akhir = k.masuk.size() - 1;  // baris terakhir tanpa '\n'
+        }
+        string tugas = k.masuk.substr(0, akhir + 1);
+        k.masuk.erase(0, akhir + 1);
+        k.sibuk = true;
+        stat.tugas++;
+        size_t nomorAwal = k.nomorBaris;
+        kolam.kirim([this, id, nomorAwal, tugas = move(tugas)] {
+            Selesai hasil{id, string(), 0, 0, 0};
+            hasil.jawaban.reserve(tugas.size() / 4 + 64);
+            // snapshot disimpen server sendiri pas berhenti, ekspor ga boleh dari klien
+            EksekutorHeadless eks(perpus, hasil.jawaban, false, nullptr, IzinFile{false, false});
+            size_t pos = 0;
+            while (pos < tugas.size()) {
+                size_t nl = tugas.find('\n', pos);
+                if (nl == string::npos) nl = tugas.size();
+                eks.jalankanBaris(string_view(tugas).substr(pos, nl - pos), nomorAwal + ++hasil.baris);
+                pos = nl + 1;
+            }
+            eks.flushBatch();
+            hasil.perintah = eks.getJumlahPerintah();
+            hasil.error = eks.getJumlahError();
+            {
+                lock_guard<mutex> lk(mtxSelesai);
+                selesai.push_back(move(hasil));
+            }
+            uint64_t satu = 1;
+            ssize_t r = write(fdBangun, &satu, sizeof(satu));
+            (void)r;
+        });
+    }
+
+    // abis ada perubahan di koneksi: kirim tugas baru, tutup kalo udah beres
+    void lanjut(map<uint64_t, Koneksi>::iterator it) {
+        Koneksi& k = it->second;
+        kirimTugas(it->first, k);
+        if (k.tutupBaca && !k.sibuk && k.masuk.empty() && k.posKeluar == k.keluar.size()) {
+            tutup(it);
+            return;
+        }
+        aturMinat(it->first, k);
+    }
+
+    void ambilSelesai() {
+        uint64_t nilai;
+        ssize_t r = read(fdBangun, &nilai, sizeof(nilai));
+        (void)r;
+        if (sinyalBerhentiServer) berhenti = true;
+
+        vector<Selesai> daftarSelesai;
+        {
+            lock_guard<mutex> lk(mtxSelesai);
+            daftarSelesai.swap(selesai);
+        }
+        for (Selesai& s : daftarSelesai) {
+            stat.perintah += s.perintah;
+            stat.error += s.error;
+            auto it = koneksi.find(s.id);
+            if (it == koneksi.end()) continue;
+            Koneksi& k = it->second;
+            k.sibuk = false;
+            k.nomorBaris += s.baris;
+            if (k.posKeluar == k.keluar.size()) {
+                k.keluar = move(s.jawaban);
+                k.posKeluar = 0;
+            } else {
+                k.keluar += s.jawaban;
+            }
+            if (!tulis(k)) {
+                tutup(it);
+                continue;
+            }
+            lanjut(it);
+        }
+    }
+
+public:
+    ServerPerpustakaan(Perpustakaan& perpus, int fdListen, unsigned nPekerja)
+        : perpus(perpus), fdListen(fdListen), fdEpoll(epoll_create1(EPOLL_CLOEXEC)),
+          fdBangun(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)), idBerikut(2), berhenti(false), kolam(nPekerja) {
+        daftar(fdListen, EPOLLIN, ID_LISTEN);
+        daftar(fdBangun, EPOLLIN, ID_BANGUN);
+    }
+
+    ~ServerPerpustakaan() {
+        kolam.tutup();
+        for (auto& [id, k] : koneksi) close(k.fd);
+        close(fdBangun);
+        close(fdEpoll);
+    }
+
+    ServerPerpustakaan(const ServerPerpustakaan&) = delete;
+    ServerPerpustakaan& operator=(const ServerPerpustakaan&) = delete;
+
+    int getFdBangun() const { return fdBangun; }
+    unsigned jumlahPekerja() const { return static_cast<unsigned>(kolam.jumlah()); }
+
+    // jalan sampe berhentikan() / sinyal
+    void jalan() {
+        vector<epoll_event> ev(512);
+        while (!berhenti) {
+            int n = epoll_wait(fdEpoll, ev.data(), static_cast<int>(ev.size()), -1);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                break;
+            }
+            for (int i = 0; i < n; i++) {
+                uint64_t id = ev[i].data.u64;
+                if (id == ID_LISTEN) {
+                    terima();
+                    continue;
+                }
+                if (id == ID_BANGUN) {
+                    ambilSelesai();
+                    continue;
+                }
+                auto it = koneksi.find(id);
+                if (it == koneksi.end()) continue;
+                Koneksi& k = it->second;
+                bool ok = !(ev[i].events & EPOLLERR);
+                if (ok && (ev[i].events & EPOLLOUT)) ok = tulis(k);
+                if (ok && (ev[i].events & (EPOLLIN | EPOLLHUP))) ok = baca(k);
+                if (!ok) tutup(it);
+                else lanjut(it);
+            }
+        }
+    }
+
+    // aman dipanggil dari thread lain
+    void berhentikan() {
+        berhenti = true;
+        uint64_t satu = 1;
+        ssize_t r = write(fdBangun, &satu, sizeof(satu));
+        (void)r;
+    }
+
+    Statistik statistik() const { return stat; }
+};
+
+// ./sistem --server <alamat> [--pekerja n] [--persisten 0|1]
+int modeServer(const string& teksAlamat, unsigned nPekerja, bool persisten) {
+    AlamatServer alamat;
+    if (!parseAlamat(teksAlamat, alamat)) {
+        cout << "❌ Alamat " << teksAlamat << " ga valid (unix:<path> / tcp:<port>)" << endl;
+        return 1;
+    }
+    int fdListen = bukaSocketServer(alamat);
+    if (fdListen < 0) {
+        cout << "❌ Gagal buka socket " << teksAlamat << ": " << strerror(errno) << endl;
+        return 1;
+    }
+
+    Perpustakaan perpus;
+    if (persisten) {
+        if (perpus.muatSnapshot(FILE_SNAPSHOT)) cout << "📂 Data dimuat dari " << FILE_SNAPSHOT << endl;
+        size_t dipulihkan = perpus.aktifkanLog(FILE_LOG);
+        if (dipulihkan > 0) cout << "🔁 " << dipulihkan << " transaksi dipulihin dari " << FILE_LOG << endl;
+    }
+
+    ServerPerpustakaan::Statistik stat;
+    {
+        ServerPerpustakaan server(perpus, fdListen, nPekerja);
+        fdSinyalServer = server.getFdBangun();
+        signal(SIGINT, tanganiSinyalServer);
+        signal(SIGTERM, tanganiSinyalServer);
+        signal(SIGPIPE, SIG_IGN);
+        cout << "🖥️  Server jalan di " << teksAlamat << " (" << server.jumlahPekerja()
+             << " pekerja), Ctrl+C buat berhenti" << endl;
+        server.jalan();
+        fdSinyalServer = -1;
+        stat = server.statistik();
+    }
+    close(fdListen);
+    if (alamat.unixSocket) unlink(alamat.path.c_str());
+
+    cout << "\n📊 " << stat.koneksi << " koneksi, " << stat.perintah << " perintah (" << stat.error
+         << " gagal) dalam " << stat.tugas << " tugas" << endl;
+    if (persisten && !perpus.checkpoint(FILE_SNAPSHOT)) {
+        cout << "⚠️  Gagal nyimpen data ke " << FILE_SNAPSHOT << endl;
+        return 1;
+    }
+    return 0;
+}
+#endif
+
+// ===========================
+// BENCHMARK
+// ===========================
+// jalaninnya lewat argumen: ./sistem --bench <nama>
+// compile pake -O2 biar angkanya representatif
+
+template <typename F>
+double ukurDetik(F&& f) {
+    auto mulai = chrono::steady_clock::now();
+    f();
+    return chrono::duration<double>(chrono::steady_clock::now() - mulai).count();
+}
+
+// opsi tambahan benchmark dari argumen: ./sistem --bench beban --item 500000 --seed 7
+struct OpsiBench {
+    map<string, string> nilai;
+
+    long long angka(const string& kunci, long long bawaan) const {
+        auto it = nilai.find(kunci);
+        return it == nilai.end() ? bawaan : atoll(it->second.c_str());
+    }
+
+    double desimal(const string& kunci, double bawaan) const {
+        auto it = nilai.find(kunci);
+        return it == nilai.end() ? bawaan : atof(it->second.c_str());
+    }
+
+    string teks(const string& kunci, const string& bawaan) const {
+        auto it = nilai.find(kunci);
+        return it == nilai.end() ? bawaan : it->second;
+    }
+};
+
+// popularitas zipf: peringkat k kepilih sebanding 1/k^s. CDF-nya dihitung
+// sekali, ambil sampel = binary search. peringkat -> nomor item diacak pake
+// permutasi biar item populer ga numpuk di slot awal
+class GeneratorZipf {
+private:
+    vector<double> cdf;
+    vector<uint32_t> peta;
+
+public:
+    GeneratorZipf(size_t n, double s, uint64_t seed) : cdf(n), peta(n) {
+        double total = 0.0;
+        for (size_t k = 0; k < n; k++) {
+            total += 1.0 / pow(double(k + 1), s);
+            cdf[k] = total;
+        }
+        for (double& c : cdf) c /= total;
+        for (size_t k = 0; k < n; k++) peta[k] = static_cast<uint32_t>(k);
+        mt19937_64 rng(seed);
+        shuffle(peta.begin(), peta.end(), rng);
+    }
+
+    template <typename Rng>
+    uint32_t ambil(Rng& rng) const {
+        double u = uniform_real_distribution<double>(0.0, 1.0)(rng);
+        size_t k = upper_bound(cdf.begin(), cdf.end(), u) - cdf.begin();
+        return peta[min(k, cdf.size() - 1)];
+    }
+};
+
+// persentil dari sampel yang udah diurutin
+template <typename T>
+T persentil(const vector<T>& urut, double q) {
+    if (urut.empty()) return T();
+    return urut[min(urut.size() - 1, static_cast<size_t>(q * urut.size()))];
+}
+
+// bandingin cari ID lewat indeks hash vs scan linear model lama
+void benchmarkLookup() {
+    cout << "\n⏱️  === BENCHMARK LOOKUP ID ===" << endl;
+    cout << setw(10) << "N item" << setw(16) << "hash (ns/op)"
+         << setw(18) << "linear (ns/op)" << endl;
+
+    for (size_t n : {size_t(1000), size_t(100000), size_t(1000000)}) {
+        Perpustakaan perpus;
+        perpus.reserve(n);
+        for (size_t i = 0; i < n; i++) {
+            perpus.tambahItem(Book("B" + to_string(i), "Judul " + to_string(i), "Anon"));
+        }
+
+        mt19937 rng(42);
+        uniform_int_distribution<size_t> acak(0, n - 1);
+        vector<string> kunci(200000);
+        for (auto& k : kunci) k = "B" + to_string(acak(rng));
+
+        size_t ketemu = 0;
+        double tHash = ukurDetik([&] {
+            for (const auto& k : kunci) ketemu += static_cast<bool>(perpus.cariItemById(k));
+        });
+
+        // scan linear kaya implementasi lama - query-nya dikit aja, lemot soalnya
+        size_t nLinear = max<size_t>(20, 20000000 / n);
+        const KatalogKolom& kolom = perpus.getKolom();
+        double tLinear = ukurDetik([&] {
+            for (size_t q = 0; q < nLinear; q++) {
+                const string& k = kunci[q % kunci.size()];
+                for (uint32_t slot = 0; slot < kolom.size(); slot++) {
+                    if (kolom.getId(slot) == k) { ketemu++; break; }
+                }
+            }
+        });
+
+        cout << setw(10) << n
+             << setw(16) << fixed << setprecision(1) << tHash * 1e9 / kunci.size()
+             << setw(18) << tLinear * 1e9 / nLinear
+             << "   (hit: " << ketemu << ")" << endl;
+    }
+}
+
+// simpan + muat ulang snapshot 1 juta item - ngukur waktu cold start
+void benchmarkSnapshot() {
+    cout << "\n⏱️  === BENCHMARK SNAPSHOT ===" << endl;
+    const size_t n = 1000000;
+    const string path = "bench.snap";
+    Perpustakaan perpus;
+    perpus.reserve(n, n / 10);
+    for (size_t i = 0; i < n; i++) {
+        string id = to_string(i);
+        if (i % 3 == 0) perpus.tambahItem(Book("B" + id, "Buku " + id, "Anon", i % 7 == 0));
+        else if (i % 3 == 1) perpus.tambahItem(Magazine("M" + id, "Majalah " + id, "Edisi " + id));
+        else perpus.tambahItem(DVD("D" + id, "Film " + id, "Sutradara"));
+    }
+    for (size_t i = 0; i < n / 10; i++) {
+        perpus.registerMember(make_unique<Member>("MEM" + to_string(i), "Member " + to_string(i)));
+    }
+
+    bool okSimpan = false, okMuat = false;
+    double tSimpan = ukurDetik([&] { okSimpan = perpus.simpanSnapshot(path); });
+    Perpustakaan baru;
+    double tMuat = ukurDetik([&] { okMuat = baru.muatSnapshot(path); });
+    remove(path.c_str());
+
+    cout << fixed << setprecision(1);
+    cout << "Simpan " << n << " item: " << tSimpan * 1e3 << " ms" << (okSimpan ? "" : " (GAGAL)") << endl;
+    cout << "Muat ulang: " << tMuat * 1e3 << " ms" << (okMuat ? "" : " (GAGAL)")
+         << " | item: " << baru.jumlahItem() << endl;
+}
+
+// impor file alat.txt sintetis 2 juta baris (ada yang dobel & rusak dikit)
+void benchmarkImpor() {
+    cout << "\n⏱️  === BENCHMARK IMPOR ALAT ===" << endl;
+    const size_t n = 2000000;
+    const string path = "bench_alat.txt";
+    {
+        string isi;
+        isi.reserve(n * 36);
+        for (size_t i = 0; i < n; i++) {
+            if (i % 100000 == 99999) { isi += "Rusak baris ini\n"; continue; }
+            size_t id = (i % 50000 == 49999) ? i - 1 : i;  // sesekali ID dobel
+            if (i & 1) isi += "Elektronik Mikroskop E" + to_string(id) + " 220 1\n";
+            else isi += "NonElektronik TabungReaksi N" + to_string(id) + " kaca 1\n";
+        }
+        ofstream(path, ios::binary) << isi;
+    }
+
+    Perpustakaan perpus;
+    HasilImpor hasil;
+    double t = ukurDetik([&] { hasil = perpus.imporAlat(path); });
+    remove(path.c_str());
+
+    cout << fixed << setprecision(1);
+    cout << "Baris: " << hasil.totalBaris << " | sukses: " << hasil.sukses
+         << " | error: " << hasil.jumlahError << endl;
+    cout << "Waktu: " << t * 1e3 << " ms (" << setprecision(2)
+         << hasil.totalBaris / t / 1e6 << " juta baris/detik)" << endl;
+}
+
+// stress test multi-thread: banyak thread pinjam/balikin item acak barengan.
+// tiap pinjam sukses dicek pake counter pemegang eksternal - kalo ada item
+// yang kepinjem dua kali, ketauan. dijalanin di katalog kecil (rebutan parah)
+// sama katalog gede (jarang rebutan) buat liat scaling 1..32 thread
+void benchmarkStres() {
+    cout << "\n⏱️  === STRESS TEST KONKUREN ===" << endl;
+    const size_t nMember = 1000;
+    const size_t opsTotal = 400000;
+
+    for (size_t nItem : {size_t(64), size_t(100000)}) {
+        cout << "\nKatalog " << nItem << " item:" << endl;
+        cout << setw(8) << "thread" << setw(14) << "ops/detik"
+             << setw(12) << "sukses" << setw(14) << "pelanggaran" << endl;
+
+        for (size_t nThread : {1, 2, 4, 8, 16, 32}) {
+            Perpustakaan perpus;
+            vector<string> idItem(nItem), idMember(nMember);
+            perpus.reserve(nItem, nMember);
+            for (size_t i = 0; i < nItem; i++) {
+                idItem[i] = "I" + to_string(i);
+                if (i % 3 == 0) perpus.tambahItem(Book(idItem[i], "Buku", "Anon"));
+                else if (i % 3 == 1) perpus.tambahItem(Magazine(idItem[i], "Majalah", "1"));
+                else perpus.tambahItem(DVD(idItem[i], "Film", "Anon"));
+            }
+            for (size_t i = 0; i < nMember; i++) {
+                idMember[i] = "MEM" + to_string(i);
+                perpus.registerMember(make_unique<Member>(idMember[i], "Member"));
+            }
+
+            vector<atomic<int>> pemegang(nItem);
+            for (auto& p : pemegang) p = 0;
+            atomic<size_t> pelanggaran{0}, suksesPinjam{0};
+
+            double t = ukurDetik([&] {
+                vector<thread> pekerja;
+                for (size_t th = 0; th < nThread; th++) {
+                    pekerja.emplace_back([&, th] {
+                        mt19937 rng(static_cast<unsigned>(th * 7919 + 1));
+                        vector<size_t> dipegang;
+                        const string& mem = idMember[th % nMember];
+                        for (size_t op = 0; op < opsTotal / nThread; op++) {
+                            if (dipegang.size() < 4 && (rng() & 1)) {
+                                size_t i = rng() % nItem;
+                                if (perpus.prosesPinjam(mem, idItem[i], 1).ok()) {
+                                    if (pemegang[i].fetch_add(1) != 0) pelanggaran++;
+                                    dipegang.push_back(i);
+                                    suksesPinjam++;
+                                }
+                            } else if (!dipegang.empty()) {
+                                size_t i = dipegang.back();
+                                dipegang.pop_back();
+                                pemegang[i].fetch_sub(1);
+                                if (!perpus.prosesKembali(mem, idItem[i], 1).ok()) pelanggaran++;
+                            }
+                        }
+                        for (size_t i : dipegang) {
+                            pemegang[i].fetch_sub(1);
+                            if (!perpus.prosesKembali(mem, idItem[i], 1).ok()) pelanggaran++;
+                        }
+                    });
+                }
+                for (auto& p : pekerja) p.join();
+            });
+
+            // abis semua balik, katalog harus tersedia semua - kata status & bitset
+            const KatalogKolom& kolom = perpus.getKolom();
+            for (uint32_t slot = 0; slot < kolom.size(); slot++) {
+                if (kolom.eksemplarDiRak(slot) != kolom.jumlahEksemplar(slot)) pelanggaran++;
+            }
+            if (kolom.hitungTersedia() != kolom.size()) pelanggaran++;
+            cout << setw(8) << nThread << setw(14) << fixed << setprecision(0) << opsTotal / t
+                 << setw(12) << suksesPinjam.load() << setw(14) << pelanggaran.load() << endl;
+        }
+    }
+}
+
+// rekonsiliasi akhir hari: balikin 50 ribu pinjaman, satu2 lewat
+// prosesKembali vs sekali jalan lewat prosesBatch
+void benchmarkBatch() {
+    cout << "\n⏱️  === BENCHMARK BATCH TRANSAKSI ===" << endl;
+    const size_t n = 50000;
+    const size_t nMember = 1000;
+    Perpustakaan perpus;
+    vector<string> idItem(n), idMember(nMember);
+    perpus.reserve(n, nMember);
+    for (size_t i = 0; i < n; i++) {
+        idItem[i] = "B" + to_string(i);
+        perpus.tambahItem(Book(idItem[i], "Buku", "Anon"));
+    }
+    for (size_t i = 0; i < nMember; i++) {
+        idMember[i] = "MEM" + to_string(i);
+        perpus.registerMember(make_unique<Member>(idMember[i], "Member"));
+    }
+
+    mt19937 rng(7);
+    vector<PermintaanTransaksi> pinjam(n), kembali(n);
+    for (size_t i = 0; i < n; i++) {
+        const string& mem = idMember[rng() % nMember];
+        pinjam[i] = {PermintaanTransaksi::PINJAM, false, 7, mem, idItem[i]};
+        kembali[i] = {PermintaanTransaksi::KEMBALI, false, static_cast<int32_t>(rng() % 20 + 1), mem, idItem[i]};
+    }
+    shuffle(kembali.begin(), kembali.end(), rng);
+
+    perpus.prosesBatch(pinjam);
+    double tSatu = ukurDetik([&] {
+        for (const auto& r : kembali) {
+            perpus.prosesKembali(string(r.idMember), string(r.idItem), r.hari);
+        }
+    });
+
+    perpus.prosesBatch(pinjam);
+    size_t sukses = 0;
+    double tBatch = ukurDetik([&] {
+        for (const auto& h : perpus.prosesBatch(kembali)) sukses += h.status == StatusTransaksi::SUKSES;
+    });
+
+    cout << fixed << setprecision(2);
+    cout << "Satu2 (prosesKembali): " << tSatu * 1e3 << " ms" << endl;
+    cout << "prosesBatch:           " << tBatch * 1e3 << " ms (" << sukses << "/" << n << " sukses)" << endl;
+}
+
+// scan satu katalog lewat Item per slot (satu item sekali jalan, kaya loop
+// objek dulu) vs operasi sekolom (bitmap / array padet), plus memori kolom
+// dibanding layout lama: objek Item polimorfik di heap per item
+size_t perkiraanMemoriObjekLama(const Item& item) {
+    // layout lama: unique_ptr di katalog + pointer di itemPerSlot + objeknya
+    // (vptr, teks id/judul/detail, kata status, eksemplar, kode, varian).
+    // tiap alokasi heap kira2 kena overhead malloc 16 byte, teks <= 15 char masih SSO
+    struct ObjekLama {
+        void* vptr;
+        Teks id, judul, detail;
+        uint64_t status;
+        uint32_t eksemplar;
+        uint8_t kode;
+        bool varian;
+    };
+    auto teks = [](string_view s) { return s.size() > 15 ? s.size() + 1 + 16 : 0; };
+    return sizeof(unique_ptr<ObjekLama>) + sizeof(ObjekLama*) + sizeof(ObjekLama) + 16 +
+           teks(item.getId()) + teks(item.getJudul()) + teks(item.getDetail());
+}
+
+void benchmarkKolom() {
+    const size_t n = 1000000;
+    cout << "\n⏱️  === BENCHMARK SCAN KATALOG (PER ITEM vs KOLOM) ===" << endl;
+
+    Perpustakaan perpus;
+    perpus.reserve(n);
+    for (size_t i = 0; i < n; i++) {
+        string id = to_string(i);
+        DataItem item;
+        switch (i % 4) {
+            case 0: item = Book("B" + id, "Buku Pemrograman Jilid " + id, "Penulis Terkenal Sekali", i % 10 == 0); break;
+            case 1: item = Magazine("M" + id, "Majalah Teknologi " + id, "Edisi " + id); break;
+            case 2: item = DVD("D" + id, "Film Dokumenter " + id, "Sutradara Kondang"); break;
+            default: item = Alat("A" + id, "Alat Praktikum " + id, i % 8 == 3, "Spesifikasi standar lab"); break;
+        }
+        item.setTersedia(i % 3 != 0);
+        perpus.tambahItem(item);
+    }
+
+    const KatalogKolom& kolom = perpus.getKolom();
+    const uint32_t nSlot = static_cast<uint32_t>(kolom.size());
+    const int ulang = 20;
+
+    size_t tersediaItem = 0, tersediaKolom = 0;
+    double tTersediaItem = ukurDetik([&] {
+        for (int u = 0; u < ulang; u++)
+            for (uint32_t slot = 0; slot < nSlot; slot++) tersediaItem += kolom.lihat(slot).isTersedia();
+    });
+    double tTersediaKolom = ukurDetik([&] {
+        for (int u = 0; u < ulang; u++) tersediaKolom += kolom.hitungTersedia();
+    });
+
+    size_t dvdItem = 0, dvdKolom = 0;
+    double tTipeItem = ukurDetik([&] {
+        for (int u = 0; u < ulang; u++)
+            for (uint32_t slot = 0; slot < nSlot; slot++) dvdItem += kolom.lihat(slot).kodeTipe() == DVD::KODE;
+    });
+    double tTipeKolom = ukurDetik([&] {
+        for (int u = 0; u < ulang; u++) dvdKolom += kolom.hitungTipe(DVD::KODE);
+    });
+
+    // kolom: itung dulu per (tipe, varian), baru dikali tarif tabel sekali per kombinasi
+    double dendaItem = 0.0, dendaKolom = 0.0;
+    double tDendaItem = ukurDetik([&] {
+        for (int u = 0; u < ulang; u++)
+            for (uint32_t slot = 0; slot < nSlot; slot++) dendaItem += kolom.lihat(slot).hitungDenda(5);
+    });
+    double tDendaKolom = ukurDetik([&] {
+        for (int u = 0; u < ulang; u++) {
+            array<array<size_t, 2>, JUMLAH_KODE_TIPE> jumlah{};
+            for (uint32_t slot = 0; slot < nSlot; slot++) jumlah[kolom.getTag(slot)][kolom.getVarian(slot)]++;
+            for (uint8_t kode = 0; kode < JUMLAH_KODE_TIPE; kode++) {
+                for (int v = 0; v < 2; v++) dendaKolom += jumlah[kode][v] * kebijakan().tarifDenda(kode, v) * 5;
+            }
+        }
+    });
+
+    size_t memLama = 0;
+    for (uint32_t slot = 0; slot < nSlot; slot++) memLama += perkiraanMemoriObjekLama(kolom.lihat(slot));
+
+    auto baris = [&](const char* nama, double tItem, double tKolom, bool cocok) {
+        cout << setw(22) << left << nama << right
+             << setw(12) << fixed << setprecision(2) << tItem * 1e3 / ulang << " ms"
+             << setw(12) << tKolom * 1e3 / ulang << " ms"
+             << setw(9) << setprecision(1) << tItem / tKolom << "x"
+             << (cocok ? "" : "   ❌ hasil beda!") << endl;
+    };
+    cout << n << " item, " << ulang << " kali scan" << endl;
+    cout << setw(22) << left << "scan" << right << setw(15) << "per item" << setw(15) << "kolom" << setw(10) << "speedup" << endl;
+    baris("hitung tersedia", tTersediaItem, tTersediaKolom, tersediaItem == tersediaKolom);
+    baris("hitung tipe DVD", tTipeItem, tTipeKolom, dvdItem == dvdKolom);
+    baris("total denda 5 hari", tDendaItem, tDendaKolom, dendaItem == dendaKolom);
+    cout << "memori layout objek lama (perkiraan): " << memLama / (1024 * 1024) << " MB" << endl;
+    cout << "memori kolom (pemilik data item):     " << kolom.ukuranMemori() / (1024 * 1024) << " MB ("
+         << setprecision(1) << double(kolom.ukuranMemori()) / n << " byte/item)" << endl;
+}
+
+// query ketersediaan per tipe: loop per item vs kernel bitmap (tiap kernel
+// yang didukung CPU). kasus padat buat hitung, kasus jarang buat cari
+void benchmarkTersedia() {
+    const size_t n = 4000000;
+    cout << "\n⏱️  === BENCHMARK KETERSEDIAAN PER TIPE ===" << endl;
+
+    for (double rasio : {0.66, 0.001}) {
+        KatalogKolom kolom;
+        kolom.reserve(n);
+        mt19937 rng(7);
+        uniform_real_distribution<double> acak(0.0, 1.0);
+        for (size_t i = 0; i < n; i++) {
+            string id = to_string(i);
+            DataItem item;
+            if (i % 4 == 2) item = DVD("D" + id, "Film", "Anon");
+            else item = Book("B" + id, "Buku", "Anon");
+            item.setTersedia(acak(rng) < rasio);
+            kolom.tambah(item);
+        }
+
+        const int ulang = 20;
+        size_t nKata = (n + 63) / 64;
+        cout << "\n" << n << " item, " << fixed << setprecision(1) << rasio * 100 << "% tersedia" << endl;
+        cout << setw(16) << left << "cara" << right << setw(14) << "hitung (ms)"
+             << setw(12) << "GB/s" << setw(14) << "iterasi (ms)" << setw(10) << "DVD" << endl;
+
+        size_t acuan = 0;
+        double tLoop = ukurDetik([&] {
+            for (int u = 0; u < ulang; u++) {
+                acuan = 0;
+                for (uint32_t slot = 0; slot < kolom.size(); slot++) {
+                    acuan += kolom.getTag(slot) == DVD::KODE && kolom.isTersedia(slot);
+                }
+            }
+        });
+        cout << setw(16) << left << "loop per item" << right << setw(14) << setprecision(3)
+             << tLoop * 1e3 / ulang << setw(12) << "-" << setw(14) << "-" << setw(10) << acuan << endl;
+
+        for (const KernelBitset& kernel : daftarKernelBitset()) {
+            size_t jumlah = 0, iter = 0;
+            double tHitung = ukurDetik([&] {
+                for (int u = 0; u < ulang; u++) jumlah = kolom.hitungTersediaTipe(DVD::KODE, kernel);
+            });
+            double tIter = ukurDetik([&] {
+                for (int u = 0; u < ulang; u++) {
+                    iter = 0;
+                    for (uint32_t slot = kolom.cariTersedia(DVD::KODE, 0, kernel); slot < kolom.size();
+                         slot = kolom.cariTersedia(DVD::KODE, slot + 1, kernel)) {
+                        iter++;
+                    }
+                }
+            });
+            double gbs = 2.0 * nKata * sizeof(uint64_t) * ulang / tHitung / 1e9;
+            cout << setw(16) << left << kernel.nama << right << setw(14) << tHitung * 1e3 / ulang
+                 << setw(12) << setprecision(2) << gbs << setw(14) << setprecision(3) << tIter * 1e3 / ulang
+                 << setw(10) << jumlah
+                 << (jumlah == acuan && iter == acuan ? "" : "   ❌ hasil beda!") << endl;
+        }
+    }
+}
+
+// bulk load 1M item + 100rb member: heap biasa vs mode arena. yang diitung
+// panggilan operator new global (malloc) per item, waktu load, sama waktu
+// bongkar. item ga pernah kena arena (datanya langsung ke kolom), jadi beda
+// heap vs arena di sini dateng dari objek Member
+void benchmarkArena() {
+    const size_t n = 1000000;
+    const string path = "bench_arena.snap";
+    cout << "\n⏱️  === BENCHMARK ALOKASI (HEAP vs ARENA) ===" << endl;
+    {
+        Perpustakaan sumber;
+        sumber.reserve(n, n / 10);
+        for (size_t i = 0; i < n; i++) {
+            string id = to_string(i);
+            sumber.tambahItem(Book("BOOK-" + id, "Judul Buku Yang Lumayan Panjang " + id,
+                                   "Penulis Dengan Nama Panjang"));
+        }
+        for (size_t i = 0; i < n / 10; i++) {
+            sumber.registerMember(make_unique<Member>("MEM" + to_string(i), "Nama Member Yang Panjang"));
+        }
+        sumber.simpanSnapshot(path);
+    }
+
+    cout << setw(22) << left << "cara" << right << setw(12) << "load (ms)" << setw(14) << "malloc/item"
+         << setw(14) << "bongkar (ms)" << setw(12) << "blok arena" << endl;
+
+    auto baris = [&](const char* nama, bool pakeArena, bool lewatSnapshot) {
+        auto perpus = make_unique<Perpustakaan>();
+        if (pakeArena) perpus->pakaiArena();
+#if PERPUS_HITUNG_ALOKASI
+        uint64_t awal = penghitungAlokasi.jumlah.load();
+#endif
+        double tLoad = ukurDetik([&] {
+            if (lewatSnapshot) {
+                perpus->muatSnapshot(path);
+            } else {
+                perpus->reserve(n);
+                for (size_t i = 0; i < n; i++) {
+                    string id = to_string(i);
+                    perpus->tambahItem(Book("BOOK-" + id, "Judul Buku Yang Lumayan Panjang " + id,
+                                            "Penulis Dengan Nama Panjang"));
+                }
+            }
+        });
+#if PERPUS_HITUNG_ALOKASI
+        uint64_t malloc = penghitungAlokasi.jumlah.load() - awal;
+#endif
+        size_t blok = perpus->statistikArena().blok;
+        double tBongkar = ukurDetik([&] { perpus.reset(); });
+        cout << setw(22) << left << nama << right << setw(12) << fixed << setprecision(1) << tLoad * 1e3
+             << setw(14) << setprecision(3)
+#if PERPUS_HITUNG_ALOKASI
+             << double(malloc) / n
+#else
+             << "-"
+#endif
+             << setw(14) << setprecision(1) << tBongkar * 1e3 << setw(12) << blok << endl;
+    };
+    baris("tambahItem ke kolom", false, false);
+    baris("muatSnapshot heap", false, true);
+    baris("muatSnapshot arena", true, true);
+    remove(path.c_str());
+    cout << "(tambahItem tetep bikin string ID/judul sementara per item di sisi pemanggil)" << endl;
+#if !PERPUS_HITUNG_ALOKASI
+    cout << "(malloc/item cuma kehitung kalo dibuild pake -DPERPUS_HITUNG_ALOKASI=1)" << endl;
+#endif
+}
+
+// simulasi 2 tahun transaksi pake jam palsu, terus bandingin query rentang
+// lewat ember vs nyapu ulang daftar transaksi mentah
+void benchmarkLaporan() {
+    const int nItem = 20000, nMember = 500, perHari = 2000, nHari = 730;
+    cout << "\n⏱️  === BENCHMARK LAPORAN RENTANG ===" << endl;
+
+    Perpustakaan perpus;
+    int32_t hariIni = hariDariTanggal(2024, 1, 1);
+    perpus.setJam([&] { return hariIni; });
+    for (int i = 0; i < nItem; i++) {
+        if (i % 2) perpus.tambahItem(Book("B" + to_string(i), "Buku", "Anon"));
+        else perpus.tambahItem(DVD("D" + to_string(i), "Film", "Anon"));
+    }
+    for (int i = 0; i < nMember; i++) perpus.registerMember(make_unique<Member>("M" + to_string(i), "Anon"));
+
+    struct Mentah {
+        int32_t hari;
+        bool pinjam;
+        double denda;
+    };
+    vector<Mentah> mentah;
+    mentah.reserve(size_t(nHari) * perHari * 2);
+
+    mt19937 rng(11);
+    vector<string> idItem(nItem), idMember(nMember);
+    for (int i = 0; i < nItem; i++) idItem[i] = (i % 2 ? "B" : "D") + to_string(i);
+    for (int i = 0; i < nMember; i++) idMember[i] = "M" + to_string(i);
+
+    double tSimulasi = ukurDetik([&] {
+        vector<PermintaanTransaksi> pinjam(perHari), kembali(perHari);
+        for (int h = 0; h < nHari; h++, hariIni++) {
+            for (int i = 0; i < perHari; i++) {
+                int item = (h * perHari + i) % nItem;
+                const string& mem = idMember[rng() % nMember];
+                pinjam[i] = {PermintaanTransaksi::PINJAM, false, 3, mem, idItem[item]};
+                kembali[i] = {PermintaanTransaksi::KEMBALI, false, int32_t(1 + rng() % 8), mem, idItem[item]};
+            }
+            for (const auto& r : perpus.prosesBatch(pinjam)) {
+                if (r.ok()) mentah.push_back({hariIni, true, 0.0});
+            }
+            for (const auto& r : perpus.prosesBatch(kembali)) {
+                if (r.ok()) mentah.push_back({hariIni, false, r.denda});
+            }
+        }
+    });
+    cout << nHari << " hari, " << mentah.size() << " transaksi disimulasi dalam "
+         << fixed << setprecision(0) << tSimulasi * 1e3 << " ms" << endl;
+
+    int32_t akhir = hariIni - 1;
+    cout << setw(24) << left << "rentang" << right << setw(12) << "ember (us)" << setw(14) << "scan (us)"
+         << setw(10) << "pinjam" << "  cocok" << endl;
+    for (int panjang : {1, 30, 365}) {
+        int32_t dari = akhir - panjang + 1;
+        AgregatLaporan a;
+        const int ulang = 200;
+        double tEmber = ukurDetik([&] {
+            for (int u = 0; u < ulang; u++) a = perpus.laporanRentang(dari, akhir);
+        });
+        size_t nPinjam = 0;
+        double denda = 0.0;
+        double tScan = ukurDetik([&] {
+            for (int u = 0; u < ulang; u++) {
+                nPinjam = 0;
+                denda = 0.0;
+                for (const Mentah& m : mentah) {
+                    if (m.hari < dari || m.hari > akhir) continue;
+                    nPinjam += m.pinjam;
+                    denda += m.denda;
+                }
+            }
+        });
+        bool cocok = nPinjam == a.totalPinjam() && abs(denda - a.totalDenda()) < 1e-6 * (denda + 1);
+        cout << setw(24) << left << (formatTanggal(dari) + " +" + to_string(panjang)) << right
+             << setw(12) << setprecision(1) << tEmber * 1e6 / ulang << setw(14) << tScan * 1e6 / ulang
+             << setw(10) << a.totalPinjam() << "  " << (cocok ? "ya" : "❌ beda") << endl;
+    }
+}
+
+// ~1M pinjaman aktif (kebanyakan udah lama telat, belum balik), tiap hari
+// ada 1000 pinjaman baru. tiap hari ditanya "siapa yang baru telat" + "total
+// denda berjalan": lewat heap (O(yang kadaluarsa)) vs nyapu semua pinjaman
+void benchmarkJatuhTempo() {
+    const int n = 1000000, baruPerHari = 1000, nHari = 30;
+    const int nAwal = n - baruPerHari * nHari;
+    cout << "\n⏱️  === BENCHMARK JATUH TEMPO ===" << endl;
+
+    Perpustakaan perpus;
+    int32_t hariIni = hariDariTanggal(2025, 1, 1);
+    perpus.setJam([&] { return hariIni; });
+    perpus.reserve(n, 100);
+    vector<string> ids, idMember;
+    for (int i = 0; i < n; i++) {
+        string id = to_string(i);
+        if (i % 3 == 0) ids.push_back("D" + id), perpus.tambahItem(DVD(ids.back(), "Film", "Anon"));
+        else if (i % 3 == 1) ids.push_back("M" + id), perpus.tambahItem(Magazine(ids.back(), "Majalah", "1"));
+        else ids.push_back("B" + id), perpus.tambahItem(Book(ids.back(), "Buku", "Anon", i % 10 == 2));
+    }
+    for (int i = 0; i < 100; i++) {
+        idMember.push_back("U" + to_string(i));
+        perpus.registerMember(make_unique<Member>(idMember.back(), "Anon"));
+    }
+
+    // salinan mentah buat pembanding scan: jatuh tempo + tarif per pinjaman
+    vector<pair<int32_t, double>> mentah;
+    mentah.reserve(n);
+    auto pinjamRentang = [&](int dari, int sampai) {
+        vector<PermintaanTransaksi> req;
+        for (int i = dari; i < sampai; i++) {
+            req.push_back({PermintaanTransaksi::PINJAM, false, 1, idMember[i % 100], ids[i]});
+        }
+        vector<HasilTransaksi> hasil = perpus.prosesBatch(req);
+        for (int i = dari; i < sampai; i++) {
+            if (!hasil[i - dari].ok()) continue;
+            Item item = perpus.getKolom().lihat(static_cast<uint32_t>(i));
+            mentah.push_back({hariIni + item.maxHariPinjam(), item.hitungDenda(1)});
+        }
+    };
+
+    // tumpukan awal - dipinjem sebulan lalu, semuanya udah telat
+    pinjamRentang(0, nAwal);
+    hariIni += 30;
+    perpus.cekJatuhTempo();
+    cout << perpus.jumlahPinjamanAktif() << " pinjaman aktif, " << baruPerHari << " pinjaman baru per hari" << endl;
+    cout << setw(12) << left << "hari" << right << setw(12) << "baru telat" << setw(12) << "heap (us)"
+         << setw(12) << "scan (us)" << setw(16) << "denda (Rp)" << "  cocok" << endl;
+
+    double totalHeap = 0.0, totalScan = 0.0;
+    bool semuaCocok = true;
+    for (int h = 0; h < nHari; h++) {
+        pinjamRentang(nAwal + h * baruPerHari, nAwal + (h + 1) * baruPerHari);
+        hariIni++;
+
+        size_t baru = 0;
+        double denda = 0.0;
+        double tHeap = ukurDetik([&] {
+            baru = perpus.cekJatuhTempo().size();
+            denda = perpus.dendaTerakru();
+        });
+        size_t baruScan = 0;
+        double dendaScan = 0.0;
+        double tScan = ukurDetik([&] {
+            for (const auto& m : mentah) {
+                if (m.first == hariIni - 1) baruScan++;
+                if (m.first < hariIni) dendaScan += (hariIni - m.first) * m.second;
+            }
+        });
+        totalHeap += tHeap;
+        totalScan += tScan;
+        bool cocok = baru == baruScan && abs(denda - dendaScan) < 1e-6 * (dendaScan + 1);
+        semuaCocok = semuaCocok && cocok;
+        if (h % 5 == 0 || !cocok) {
+            cout << setw(12) << left << formatTanggal(hariIni) << right << setw(12) << baru
+                 << setw(12) << fixed << setprecision(1) << tHeap * 1e6 << setw(12) << tScan * 1e6
+                 << setw(16) << setprecision(0) << denda << "  " << (cocok ? "ya" : "❌ beda") << endl;
+        }
+    }
+    cout << "rata2 per hari: heap " << setprecision(1) << totalHeap * 1e6 / nHari << " us, scan "
+         << totalScan * 1e6 / nHari << " us" << (semuaCocok ? "" : "  ❌ ada yang beda!") << endl;
+}
+
+// hitung denda pas balik dua langkah (maxHariPinjam + hitungDenda, kaya
+// aturan lama) vs jalur inline ke tabel vs switch ke KebijakanTetap<KODE>.
+// katalog-nya campur 4 tipe diacak biar branch predictor ga kebantu
+void benchmarkKebijakan() {
+    const size_t n = 1000000;
+    const int ulang = 10;
+    cout << "\n⏱️  === BENCHMARK MESIN KEBIJAKAN ===" << endl;
+
+    KatalogKolom katalog;
+    katalog.reserve(n);
+    mt19937 rng(42);
+    for (size_t i = 0; i < n; i++) {
+        string id = to_string(i);
+        switch (rng() % 4) {
+            case 0: katalog.tambah(Book("B" + id, "Buku " + id, "Anon", rng() % 10 == 0)); break;
+            case 1: katalog.tambah(Magazine("M" + id, "Majalah " + id, "Edisi 1")); break;
+            case 2: katalog.tambah(DVD("D" + id, "Film " + id, "Anon")); break;
+            default: katalog.tambah(Alat("A" + id, "Alat " + id, rng() % 2 == 0, "-")); break;
+        }
+    }
+    vector<int> hari(n);
+    for (int& h : hari) h = 1 + rng() % 20;
+
+    double dendaDua = 0.0, dendaTabel = 0.0, dendaTetap = 0.0;
+    double tDua = ukurDetik([&] {
+        for (int u = 0; u < ulang; u++) {
+            for (uint32_t i = 0; i < n; i++) {
+                Item item = katalog.lihat(i);
+                int telat = hari[i] - item.maxHariPinjam();
+                if (telat > 0) dendaDua += item.hitungDenda(telat);
+            }
+        }
+    });
+    double tTabel = ukurDetik([&] {
+        for (int u = 0; u < ulang; u++)
+            for (uint32_t i = 0; i < n; i++) dendaTabel += katalog.lihat(i).dendaKembali(hari[i]);
+    });
+    double tTetap = ukurDetik([&] {
+        for (int u = 0; u < ulang; u++) {
+            for (uint32_t i = 0; i < n; i++) {
+                Item item = katalog.lihat(i);
+                bool v = item.getVarian();
+                switch (item.kodeTipe()) {
+                    case Book::KODE: dendaTetap += KebijakanTetap<Book::KODE>::dendaKembali(hari[i], v); break;
+                    case Magazine::KODE: dendaTetap += KebijakanTetap<Magazine::KODE>::dendaKembali(hari[i], v); break;
+                    case DVD::KODE: dendaTetap += KebijakanTetap<DVD::KODE>::dendaKembali(hari[i], v); break;
+                    case Alat::KODE: dendaTetap += KebijakanTetap<Alat::KODE>::dendaKembali(hari[i], v); break;
+                }
+            }
+        }
+    });
+
+    double total = double(n) * ulang;
+    auto baris = [&](const char* nama, double t, bool cocok) {
+        cout << setw(26) << left << nama << right << setw(10) << fixed << setprecision(2)
+             << t * 1e9 / total << " ns/op" << setw(9) << setprecision(1) << tDua / t << "x"
+             << (cocok ? "" : "   ❌ hasil beda!") << endl;
+    };
+    cout << n << " item campur, " << ulang << " kali ulang" << endl;
+    baris("dua langkah (aturan lama)", tDua, true);
+    baris("inline tabel aktif", tTabel, dendaTabel == dendaDua);
+    // KebijakanTetap selalu pake aturan bawaan, kalo ada file kebijakan ya wajar beda
+    baris("switch KebijakanTetap", tTetap, dendaTetap == dendaDua);
+    cout << "total denda: " << fixed << setprecision(0) << dendaDua << endl;
+}
+
+// latensi query pencarian di 1 juta item: indeks (kata, AND, awalan,
+// awalan + tersedia) vs scan string::find di semua item. hasil indeks dicek
+// ulang pake brute force buat beberapa query
+void benchmarkCari() {
+    const size_t n = 1000000;
+    cout << "\n⏱️  === BENCHMARK PENCARIAN TEKS ===" << endl;
+
+    // kosakata sintetis dari suku kata, dipake pake distribusi zipf biar ada
+    // kata umum (posting panjang) sama kata langka (posting pendek)
+    static const char* SUKU[] = {"ka", "ri", "mu", "sa", "to", "be", "la", "ni", "go", "pe",
+                                 "da", "ru", "si", "wa", "ma", "te", "lo", "ba", "ne", "ju"};
+    mt19937 rng(11);
+    vector<string> kosakata(20000);
+    for (string& k : kosakata) {
+        int panjang = 2 + rng() % 3;
+        for (int i = 0; i < panjang; i++) k += SUKU[rng() % 20];
+    }
+    vector<double> bobot(kosakata.size());
+    for (size_t i = 0; i < bobot.size(); i++) bobot[i] = 1.0 / (i + 1);
+    discrete_distribution<size_t> zipf(bobot.begin(), bobot.end());
+    auto kalimat = [&](int nKata) {
+        string s;
+        for (int i = 0; i < nKata; i++) {
+            if (i) s += ' ';
+            s += kosakata[zipf(rng)];
+            if (i == 0) s[0] = static_cast<char>(s[0] - 32);
+        }
+        return s;
+    };
+
+    Perpustakaan perpus;
+    perpus.reserve(n);
+    double tTambah = ukurDetik([&] {
+        for (size_t i = 0; i < n; i++) {
+            string id = to_string(i);
+            DataItem item;
+            switch (i % 4) {
+                case 0: item = Book("B" + id, kalimat(3 + rng() % 3), kalimat(2)); break;
+                case 1: item = Magazine("M" + id, kalimat(2), "Edisi " + id); break;
+                case 2: item = DVD("D" + id, kalimat(2 + rng() % 2), kalimat(2)); break;
+                default: item = Alat("A" + id, kalimat(2), i % 8 == 3, "-"); break;
+            }
+            item.setTersedia(rng() % 3 != 0);
+            perpus.tambahItem(item);
+        }
+    });
+
+    // bangun ulang indeks doang dari kolom, biar keliatan ongkos indeksnya sendiri
+    const KatalogKolom& kolom = perpus.getKolom();
+    IndeksCari indeks;
+    double tIndeks = ukurDetik([&] {
+        for (uint32_t slot = 0; slot < kolom.size(); slot++) indeks.tambah(slot, kolom);
+    });
+    cout << n << " item, " << indeks.jumlahKata() << " kata unik" << endl;
+    cout << "tambahItem total: " << fixed << setprecision(2) << tTambah << " s, bangun indeks doang: "
+         << tIndeks << " s, memori indeks: " << indeks.ukuranMemori() / (1024 * 1024) << " MB" << endl;
+
+    auto kataAcak = [&] { return kosakata[zipf(rng)]; };
+    struct Skenario {
+        const char* nama;
+        function<string()> query;
+        bool awalan;
+        bool hanyaTersedia;
+    };
+    vector<Skenario> skenario = {
+        {"1 kata", kataAcak, false, false},
+        {"2 kata (AND)", [&] { return kataAcak() + " " + kataAcak(); }, false, false},
+        {"awalan 3 huruf", [&] { return kataAcak().substr(0, 3); }, true, false},
+        {"2 kata + awalan, tersedia", [&] { return kataAcak() + " " + kataAcak().substr(0, 3); }, true, true},
+    };
+
+    const int nQuery = 2000;
+    cout << setw(28) << left << "query" << right << setw(10) << "p50 us" << setw(10) << "p99 us"
+         << setw(10) << "max us" << setw(12) << "rata2 hit" << endl;
+    for (const Skenario& sk : skenario) {
+        IndeksCari::Opsi opsi;
+        opsi.awalan = sk.awalan;
+        opsi.hanyaTersedia = sk.hanyaTersedia;
+        vector<double> lat(nQuery);
+        size_t hit = 0;
+        for (int q = 0; q < nQuery; q++) {
+            string query = sk.query();
+            lat[q] = ukurDetik([&] { hit += perpus.cariItem(query, opsi).size(); });
+        }
+        sort(lat.begin(), lat.end());
+        cout << setw(28) << left << sk.nama << right << fixed << setprecision(1)
+             << setw(10) << lat[nQuery / 2] * 1e6 << setw(10) << lat[nQuery * 99 / 100] * 1e6
+             << setw(10) << lat.back() * 1e6 << setw(12) << double(hit) / nQuery << endl;
+    }
+
+    // pembanding: scan semua item pake string::find (case-sensitive pun udah segini)
+    const int nScan = 20;
+    size_t hitScan = 0;
+    double tScan = ukurDetik([&] {
+        for (int q = 0; q < nScan; q++) {
+            string kata = kataAcak();
+            size_t ketemu = 0;
+            for (uint32_t slot = 0; slot < kolom.size(); slot++) {
+                if (kolom.getJudul(slot).find(kata) != string_view::npos) {
+                    if (++ketemu == 20) break;
+                }
+            }
+            hitScan += ketemu;
+        }
+    });
+    cout << "scan string::find (stop di 20 hit): " << fixed << setprecision(1) << tScan * 1e6 / nScan
+         << " us/query (rata2 hit " << double(hitScan) / nScan << ")" << endl;
+
+    // cek kebenaran: AND 2 kata tanpa batas vs brute force per item
+    bool semuaCocok = true;
+    for (int q = 0; q < 5; q++) {
+        string a = kataAcak(), b = kataAcak();
+        IndeksCari::Opsi opsi;
+        opsi.awalan = false;
+        opsi.maks = n;
+        vector<uint32_t> dariIndeks = indeks.cari(a + " " + b, kolom, opsi);
+        vector<uint32_t> brute;
+        for (uint32_t slot = 0; slot < kolom.size(); slot++) {
+            bool adaA = false, adaB = false;
+            auto cek = [&](string_view k) { adaA |= k == a; adaB |= k == b; };
+            pecahKata(kolom.getJudul(slot), cek);
+            uint8_t tag = kolom.getTag(slot);
+            if (tag == Book::KODE || tag == DVD::KODE) pecahKata(kolom.getDetail(slot), cek);
+            if (adaA && adaB) brute.push_back(slot);
+        }
+        semuaCocok &= dariIndeks == brute;
+    }
+    cout << "cek brute force: " << (semuaCocok ? "✅ cocok" : "❌ ada yang beda!") << endl;
+}
+
+// indeks terurut: biaya jaga indeks pas tambahItem vs sortKatalog model
+// lama (std::sort lewat pointer tiap kali menu sort), plus latensi rentang ID
+// dan halaman katalog di tengah2 1 juta item
+void benchmarkUrut() {
+    const size_t n = 1000000;
+    cout << "\n⏱️  === BENCHMARK INDEKS TERURUT ===" << endl;
+
+    // ID diacak biar urutan masuk != urutan ID
+    vector<uint32_t> nomor(n);
+    for (size_t i = 0; i < n; i++) nomor[i] = static_cast<uint32_t>(i);
+    mt19937 rng(5);
+    shuffle(nomor.begin(), nomor.end(), rng);
+
+    Perpustakaan perpus;
+    perpus.reserve(n);
+    double tTambah = ukurDetik([&] {
+        for (size_t i = 0; i < n; i++) {
+            string id = to_string(nomor[i]);
+            Book item("B" + id, "Judul " + to_string(rng() % 50000), "Anon");
+            item.setTersedia(rng() % 3 != 0);
+            perpus.tambahItem(item);
+        }
+    });
+
+    // ongkos indeks doang: tambah satu2 vs bangun sekaligus, dibandingin
+    // sama std::sort salinan katalog (view Item) kaya sortKatalog lama
+    const KatalogKolom& kolom = perpus.getKolom();
+    IndeksUrut<BandingId> indeks(kolom);
+    double tIncremental = ukurDetik([&] {
+        for (uint32_t slot = 0; slot < kolom.size(); slot++) indeks.tambah(slot);
+    });
+    IndeksUrut<BandingId> indeksBulk(kolom);
+    double tBulk = ukurDetik([&] { indeksBulk.bangun(static_cast<uint32_t>(kolom.size())); });
+    vector<Item> salinan;
+    for (uint32_t slot = 0; slot < kolom.size(); slot++) salinan.push_back(kolom.lihat(slot));
+    double tSortLama = ukurDetik([&] { sort(salinan.begin(), salinan.end()); });
+
+    bool urutCocok = true;
+    for (const IndeksUrut<BandingId>* x : {&indeks, &indeksBulk}) {
+        size_t i = 0;
+        x->jelajah(x->awal(), [&](uint32_t slot) {
+            urutCocok &= kolom.getId(slot) == salinan[i++].getId();
+            return urutCocok;
+        });
+        urutCocok &= i == n;
+        // lompat ke posisi ke-k lewat jumlah per anak harus kena entri yang sama
+        for (size_t k = 0; urutCocok && k < n; k += 997) {
+            x->jelajah(x->posisiKe(k), [&](uint32_t slot) {
+                urutCocok &= kolom.getId(slot) == salinan[k].getId();
+                return false;
+            });
+        }
+    }
+
+    cout << n << " item" << endl;
+    cout << "tambahItem total (3 indeks urut ikut): " << fixed << setprecision(2) << tTambah << " s" << endl;
+    cout << "indeks ID tambah satu2: " << tIncremental * 1e9 / n << " ns/item, bangun bulk: "
+         << tBulk * 1e3 << " ms, memori: " << indeks.ukuranMemori() / (1024 * 1024) << " MB" << endl;
+    cout << "sortKatalog lama (sekali): " << tSortLama * 1e3 << " ms"
+         << (urutCocok ? "   ✅ urutan sama" : "   ❌ urutan beda!") << endl;
+
+    const int nQuery = 2000;
+    auto ukurQuery = [&](const char* nama, auto&& query) {
+        vector<double> lat(nQuery);
+        size_t hit = 0;
+        for (int q = 0; q < nQuery; q++) lat[q] = ukurDetik([&] { hit += query(q); });
+        sort(lat.begin(), lat.end());
+        cout << setw(34) << left << nama << right << fixed << setprecision(1) << setw(10)
+             << lat[nQuery / 2] * 1e6 << " us p50" << setw(10) << lat[nQuery * 99 / 100] * 1e6
+             << " us p99   (rata2 " << double(hit) / nQuery << " hasil)" << endl;
+    };
+    uniform_int_distribution<uint32_t> acak(0, static_cast<uint32_t>(n / 100) - 1);
+    ukurQuery("rentang ID B<k>00..B<k>99", [&](int) {
+        string dasar = "B" + to_string(acak(rng));
+        return perpus.rentangId(dasar + "00", dasar + "99", 100).size();
+    });
+    ukurQuery("halaman acak (20/hal) urut ID", [&](int) {
+        return perpus.halamanKatalog(UrutKatalog::ID, acak(rng) % (n / 20), 20).size();
+    });
+    ukurQuery("halaman acak urut judul", [&](int) {
+        return perpus.halamanKatalog(UrutKatalog::JUDUL, acak(rng) % (n / 20), 20).size();
+    });
+    ukurQuery("halaman 100 urut ID, tersedia", [&](int) {
+        return perpus.halamanKatalog(UrutKatalog::ID, 100, 20, 0, true).size();
+    });
+
+    // halaman dari indeks harus sama kaya potongan hasil sort lama
+    bool halamanCocok = true;
+    for (int q = 0; q < 50; q++) {
+        size_t hal = acak(rng) % (n / 20);
+        vector<string> ids = perpus.halamanKatalog(UrutKatalog::ID, hal, 20);
+        for (size_t k = 0; k < ids.size(); k++) halamanCocok &= ids[k] == salinan[hal * 20 + k].getId();
+        halamanCocok &= ids.size() == 20;
+    }
+    cout << "cek halaman vs sort lama: " << (halamanCocok ? "✅ cocok" : "❌ ada yang beda!") << endl;
+}
+
+// listing 500 ribu item: cara lama (tampilInfo, endl tiap baris) vs
+// streaming lewat satu buffer (teks, CSV, JSONL), plus paging pake kursor.
+// semua nulis ke file beneran biar flush-nya kerasa
+void benchmarkListing() {
+    const size_t n = 500000;
+    const string path = "bench_listing.txt";
+    cout << "\n⏱️  === BENCHMARK LISTING & EKSPOR ===" << endl;
+
+    Perpustakaan perpus;
+    perpus.reserve(n, n / 5);
+    mt19937 rng(3);
+    for (size_t i = 0; i < n; i++) {
+        string id = to_string(i);
+        DataItem item;
+        switch (i % 4) {
+            case 0: item = Book("B" + id, "Buku \"Seru\" " + id, "Penulis, Anon", i % 10 == 0); break;
+            case 1: item = Magazine("M" + id, "Majalah " + id, "Edisi " + id); break;
+            case 2: item = DVD("D" + id, "Film " + id, "Sutradara Kondang"); break;
+            default: item = Alat("A" + id, "Alat " + id, i % 8 == 3, "220"); break;
+        }
+        item.setTersedia(rng() % 3 != 0);
+        perpus.tambahItem(item);
+    }
+    for (size_t i = 0; i < n / 5; i++) perpus.registerMember(make_unique<Member>("U" + to_string(i), "Member Setia"));
+
+    auto ukuranFile = [&] {
+        ifstream in(path, ios::binary | ios::ate);
+        return static_cast<size_t>(in.tellg());
+    };
+    auto baris = [&](const char* nama, double t, size_t byte) {
+        cout << setw(30) << left << nama << right << fixed << setprecision(1) << setw(9) << t * 1e3 << " ms"
+             << setw(9) << byte / (1024.0 * 1024.0) << " MB" << setw(10) << byte / (1024.0 * 1024.0) / t
+             << " MB/s" << endl;
+    };
+
+    // file lama dihapus dulu biar ongkos truncate ga ikut keukur
+    // cara lama: tiap baris endl = flush ke file
+    remove(path.c_str());
+    double tLama = ukurDetik([&] {
+        ofstream out(path, ios::binary);
+        streambuf* asli = cout.rdbuf(out.rdbuf());
+        const KatalogKolom& kolom = perpus.getKolom();
+        for (uint32_t slot = 0; slot < kolom.size(); slot++) {
+            Item item = kolom.lihat(slot);
+            cout << "ID: " << item.getId() << " | Judul: " << item.getJudul()
+                 << " | Status: " << (item.isTersedia() ? "Tersedia" : "Dipinjam") << endl;
+            cout << "  ..." << endl;
+            cout << "---" << endl;
+        }
+        cout.rdbuf(asli);
+    });
+    baris("teks, endl per baris (lama)", tLama, ukuranFile());
+
+    for (auto [nama, fmt] : {pair<const char*, FormatListing>{"teks, buffer 1 MB", FormatListing::TEKS},
+                             {"CSV", FormatListing::CSV},
+                             {"JSON Lines", FormatListing::JSONL}}) {
+        remove(path.c_str());
+        double t = ukurDetik([&] { perpus.eksporKatalog(path, fmt); });
+        baris(nama, t, ukuranFile());
+    }
+    remove(path.c_str());
+    double tMember = ukurDetik([&] { perpus.eksporMember(path, FormatListing::CSV); });
+    baris("member CSV", tMember, ukuranFile());
+
+    // halaman 1000 item tersedia urut ID pake kursor - gabungan semua
+    // halaman harus sama persis kaya ekspor sekali jalan
+    FilterListing filter;
+    filter.urut = UrutKatalog::ID;
+    filter.hanyaTersedia = true;
+    perpus.eksporKatalog(path, FormatListing::CSV, filter);
+    string sekaliJalan;
+    {
+        ifstream in(path, ios::binary);
+        sekaliJalan.assign(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+    }
+    string gabungan;
+    size_t nHalaman = 0;
+    double tHalaman = ukurDetik([&] {
+        uint32_t kursor = KURSOR_AWAL;
+        do {
+            BufferKeluaran out(nullptr);
+            kursor = perpus.streamKatalog(out, FormatListing::CSV, filter, kursor, 1000);
+            gabungan += out.isi();
+            out.isi().clear();
+            nHalaman++;
+        } while (kursor != KURSOR_HABIS);
+    });
+    cout << nHalaman << " halaman x 1000 (tersedia, urut ID): " << fixed << setprecision(1)
+         << tHalaman * 1e6 / nHalaman << " us/halaman"
+         << (gabungan == sekaliJalan ? "   ✅ sama kaya ekspor sekali jalan" : "   ❌ hasil beda!") << endl;
+    remove(path.c_str());
+}
+
+// ongkos instrumentasi: siklus pinjam+kembali dengan latensi diukur vs cuma
+// counter, ongkos mentah satu PengukurMetrik, counter per thread vs satu
+// atomic bareng, sama berapa lama baca() ngegabungin semua blok
+void benchmarkMetrik() {
+    cout << "\n⏱️  === BENCHMARK METRIK ===" << endl;
+    const size_t nItem = 10000, nSiklus = 1000000;
+    Perpustakaan perpus;
+    for (size_t i = 0; i < nItem; i++) {
+        perpus.tambahItem(Book("B" + to_string(i), "Judul", "Penulis"));
+    }
+    perpus.registerMember(make_unique<Member>("U1", "Bench"));
+    vector<string> id(nItem);
+    for (size_t i = 0; i < nItem; i++) id[i] = "B" + to_string(i);
+
+    uint32_t awal = metrik.periodeSampel();
+    auto siklus = [&](uint32_t periode) {
+        metrik.setPeriodeSampel(periode);
+        return ukurDetik([&] {
+            for (size_t k = 0; k < nSiklus; k++) {
+                perpus.prosesPinjam("U1", id[k % nItem], 3);
+                perpus.prosesKembali("U1", id[k % nItem], 3);
+            }
+        }) * 1e9 / (2 * nSiklus);
+    };
+    siklus(1);  // pemanasan
+    double nsMati = siklus(0), nsSampel = siklus(Metrik::PERIODE_BAWAAN), nsSemua = siklus(1);
+
+    const size_t nMentah = 20000000;
+    auto mentah = [&](uint32_t periode) {
+        metrik.setPeriodeSampel(periode);
+        return ukurDetik([&] {
+            for (size_t k = 0; k < nMentah; k++) {
+                PengukurMetrik u(OpMetrik::CARI_ITEM);
+                u.selesai(StatusTransaksi::SUKSES);
+            }
+        }) * 1e9 / nMentah;
+    };
+    double mentahMati = mentah(0), mentahSampel = mentah(Metrik::PERIODE_BAWAAN), mentahSemua = mentah(1);
+    metrik.setPeriodeSampel(awal);
+
+    // 4 thread nambah counter barengan
+    const unsigned nThread = 4;
+    const size_t perThread = 5000000;
+    atomic<uint64_t> bareng(0);
+    auto paralel = [&](auto&& f) {
+        return ukurDetik([&] {
+            vector<thread> th;
+            for (unsigned t = 0; t < nThread; t++) th.emplace_back([&] {
+                for (size_t k = 0; k < perThread; k++) f();
+            });
+            for (auto& t : th) t.join();
+        }) * 1e9 / (nThread * perThread);
+    };
+    uint64_t sebelum = metrik.baca().op[static_cast<size_t>(OpMetrik::CARI_MEMBER)].jumlah();
+    double nsBareng = paralel([&] { bareng.fetch_add(1, memory_order_relaxed); });
+    double nsPerThread = paralel([&] { metrik.catat(OpMetrik::CARI_MEMBER, StatusTransaksi::SUKSES); });
+    uint64_t sesudah = metrik.baca().op[static_cast<size_t>(OpMetrik::CARI_MEMBER)].jumlah();
+
+    RingkasanMetrik r;
+    double usBaca = ukurDetik([&] { for (int k = 0; k < 100; k++) r = metrik.baca(); }) * 1e6 / 100;
+    double usPrometheus = ukurDetik([&] { for (int k = 0; k < 100; k++) formatPrometheus(r); }) * 1e6 / 100;
+
+    cout << fixed << setprecision(1);
+    cout << "pinjam/kembali, cuma counter:        " << nsMati << " ns/op" << endl;
+    cout << "pinjam/kembali, latensi 1/" << Metrik::PERIODE_BAWAAN << ":         " << nsSampel << " ns/op (+"
+         << nsSampel - nsMati << ")" << endl;
+    cout << "pinjam/kembali, latensi semua:       " << nsSemua << " ns/op (+" << nsSemua - nsMati << ")" << endl;
+    cout << "PengukurMetrik mentah: counter " << mentahMati << " ns, 1/" << Metrik::PERIODE_BAWAAN << " "
+         << mentahSampel << " ns, semua " << mentahSemua << " ns" << endl;
+    cout << nThread << " thread, satu atomic bareng:      " << nsBareng << " ns/inc" << endl;
+    cout << nThread << " thread, blok per thread:         " << nsPerThread << " ns/inc (jumlah "
+         << (sesudah - sebelum == nThread * perThread ? "cocok" : "BEDA!") << ")" << endl;
+    cout << "baca() gabung blok: " << usBaca << " us, format Prometheus: " << usPrometheus << " us" << endl;
+}
+
+// replay log perintah harian: mode headless (teks & biner) vs cara lama -
+// prosesX satu2 dengan SinkTeks yang flush tiap event kaya menu. log-nya
+// digenerate dari seed: setup katalog + member, terus campuran pinjam/
+// kembali/kembalidvd (item dipilih zipf). opsi: --item --member --ops --seed
+void benchmarkHeadless(const OpsiBench& opsi) {
+    const size_t nItem = max<long long>(1, opsi.angka("item", 100000));
+    const size_t nMember = max<long long>(1, opsi.angka("member", 10000));
+    const size_t nOps = max<long long>(1, opsi.angka("ops", 1000000));
+    const uint64_t seed = static_cast<uint64_t>(opsi.angka("seed", 42));
+    const string pathTeks = "bench_headless.txt", pathBiner = "bench_headless.bin";
+    const string pathKeluar = "bench_headless.out";
+    cout << "\n⏱️  === BENCHMARK HEADLESS (" << nItem << " item, " << nMember << " member, " << nOps
+         << " transaksi) ===" << endl;
+
+    // generate log-nya sekali, ditulis dua versi
+    struct Op {
+        Perintah::Kode kode;
+        uint32_t item, member;
+        int32_t hari;
+        bool flag;
+    };
+    mt19937_64 rng(seed);
+    vector<Op> ops;
+    vector<uint8_t> kodeItem(nItem);
+    ops.reserve(nItem + nMember + nOps);
+    for (uint32_t i = 0; i < nItem; i++) {
+        uint64_t r = rng() % 10;
+        Perintah::Kode k = r < 5 ? Perintah::TAMBAH_BOOK : r < 8 ? Perintah::TAMBAH_MAJALAH : Perintah::TAMBAH_DVD;
+        kodeItem[i] = k;
+        ops.push_back({k, i, 0, 0, rng() % 20 == 0});
+    }
+    for (uint32_t m = 0; m < nMember; m++) ops.push_back({Perintah::REGISTER_MEMBER, 0, m, 0, false});
+    GeneratorZipf zipf(nItem, 0.99, seed + 1);
+    vector<pair<uint32_t, uint32_t>> pinjaman;
+    for (size_t k = 0; k < nOps; k++) {
+        if (!pinjaman.empty() && (rng() % 100 < 45 || pinjaman.size() >= nItem / 4)) {
+            size_t idx = rng() % pinjaman.size();
+            auto [i, m] = pinjaman[idx];
+            pinjaman[idx] = pinjaman.back();
+            pinjaman.pop_back();
+            int32_t hari = 1 + static_cast<int32_t>(rng() % 14);
+            if (kodeItem[i] == Perintah::TAMBAH_DVD) ops.push_back({Perintah::KEMBALI_DVD, i, m, hari, rng() % 20 == 0});
+            else ops.push_back({Perintah::KEMBALI, i, m, hari, false});
+        } else {
+            uint32_t i = zipf.ambil(rng), m = static_cast<uint32_t>(rng() % nMember);
+            ops.push_back({Perintah::PINJAM, i, m, 1 + static_cast<int32_t>(rng() % 7), rng() % 10 == 0});
+            pinjaman.push_back({i, m});
+        }
+    }
+
+    auto idItem = [&](uint32_t i) { return string(1, "?BMD"[kodeItem[i]]) + to_string(i); };
+    string teks;
+    PenulisBiner biner;
+    for (const Op& o : ops) {
+        string a, b, c;
+        if (o.kode == Perintah::REGISTER_MEMBER) {
+            a = "U" + to_string(o.member);
+            b = "Member " + to_string(o.member);
+        } else if (o.kode <= Perintah::TAMBAH_DVD) {
+            a = idItem(o.item);
+            b = "Judul " + to_string(o.item);
+            c = "Orang " + to_string(o.item % 997);
+        } else {
+            a = "U" + to_string(o.member);
+            b = idItem(o.item);
+        }
+        const char* pola = SPES_PERINTAH[o.kode].pola;
+        teks += SPES_PERINTAH[o.kode].nama;
+        size_t awalFrame = biner.posisi();
+        biner.tulis<uint32_t>(0);
+        biner.tulis<uint8_t>(o.kode);
+        const string* kolom[3] = {&a, &b, &c};
+        size_t nTeks = 0;
+        for (const char* p = pola; *p; p++) {
+            teks += '|';
+            if (*p == 's') {
+                teks += *kolom[nTeks];
+                biner.tulisString(*kolom[nTeks++]);
+            } else if (*p == 'i') {
+                teks += to_string(o.hari);
+                biner.tulis<int32_t>(o.hari);
+            } else {
+                teks += o.flag ? '1' : '0';
+                biner.tulis<uint8_t>(o.flag);
+            }
+        }
+        teks += '\n';
+        biner.timpa<uint32_t>(awalFrame, static_cast<uint32_t>(biner.posisi() - awalFrame - sizeof(uint32_t)));
+    }
+    ofstream(pathTeks, ios::binary) << teks;
+    ofstream(pathBiner, ios::binary) << biner.data();
+
+    // jalur headless: file -> file, yang sukses dihitung dari jawabannya
+    auto jalankan = [&](const string& path, bool modeBiner, size_t& sukses) {
+        Perpustakaan perpus;
+        FILE* masuk = fopen(path.c_str(), "rb");
+        FILE* keluar = fopen(pathKeluar.c_str(), "wb");
+        HasilHeadless h;
+        double t = ukurDetik([&] { h = jalankanHeadless(perpus, masuk, keluar, modeBiner); });
+        fclose(masuk);
+        fclose(keluar);
+        sukses = h.perintah - h.error;
+        return t;
+    };
+    size_t suksesTeks = 0, suksesBiner = 0, suksesLama = 0;
+    double tTeks = jalankan(pathTeks, false, suksesTeks);
+    double tBiner = jalankan(pathBiner, true, suksesBiner);
+
+    // cara lama: satu transaksi satu panggilan, pesannya di-flush tiap event
+    double tLama;
+    {
+        Perpustakaan perpus;
+        ofstream keluar(pathKeluar, ios::binary);
+        SinkTeks sink(keluar, true);
+        perpus.pasangSink(&sink);
+        tLama = ukurDetik([&] {
+            for (const Op& o : ops) {
+                string a = "U" + to_string(o.member), b = idItem(o.item);
+                switch (o.kode) {
+                    case Perintah::TAMBAH_BOOK:
+                        suksesLama += perpus.tambahItem(Book(b, "Judul " + to_string(o.item),
+                                                             "Orang " + to_string(o.item % 997), o.flag));
+                        break;
+                    case Perintah::TAMBAH_MAJALAH:
+                        suksesLama += perpus.tambahItem(Magazine(b, "Judul " + to_string(o.item),
+                                                                 "Orang " + to_string(o.item % 997)));
+                        break;
+                    case Perintah::TAMBAH_DVD:
+                        suksesLama += perpus.tambahItem(DVD(b, "Judul " + to_string(o.item),
+                                                            "Orang " + to_string(o.item % 997)));
+                        break;
+                    case Perintah::REGISTER_MEMBER:
+                        suksesLama += perpus.registerMember(make_unique<Member>(a, "Member " + to_string(o.member)));
+                        break;
+                    case Perintah::PINJAM: suksesLama += perpus.prosesPinjam(a, b, o.hari, o.flag).ok(); break;
+                    case Perintah::KEMBALI: suksesLama += perpus.prosesKembali(a, b, o.hari).ok(); break;
+                    default: suksesLama += perpus.prosesKembaliDVD(a, b, o.hari, o.flag).ok();
+                }
+            }
+        });
+    }
+    remove(pathTeks.c_str());
+    remove(pathBiner.c_str());
+    remove(pathKeluar.c_str());
+
+    double n = static_cast<double>(ops.size());
+    cout << fixed << setprecision(1);
+    cout << "log: " << ops.size() << " perintah, teks " << teks.size() / 1e6 << " MB, biner "
+         << biner.posisi() / 1e6 << " MB" << endl;
+    cout << "satu2 + flush tiap event: " << tLama * 1e3 << " ms (" << n / tLama / 1e6 << " jt perintah/s)" << endl;
+    cout << "headless teks:            " << tTeks * 1e3 << " ms (" << n / tTeks / 1e6 << " jt perintah/s)" << endl;
+    cout << "headless biner:           " << tBiner * 1e3 << " ms (" << n / tBiner / 1e6 << " jt perintah/s)" << endl;
+    cout << "sukses: " << suksesLama << " / " << suksesTeks << " / " << suksesBiner
+         << (suksesLama == suksesTeks && suksesTeks == suksesBiner ? " (cocok)" : " (BEDA!)") << endl;
+}
+
+#ifdef PERPUS_EPOLL
+// generator beban sisi klien buat mode server: nKoneksi socket non-blocking
+// dibagi ke beberapa thread (masing2 epoll sendiri), tiap koneksi jaga
+// `kedalaman` request yang lagi jalan. koneksi c cuma minjem item bagiannya
+// sendiri (i % nKoneksi == c) bergantian pinjam -> kembali, jadi semuanya
+// harusnya sukses. latensi = dari request ditulis sampe jawabannya utuh
+struct KonfigKlien {
+    size_t koneksi = 256;
+    size_t kedalaman = 4;
+    size_t request = 1000000;
+    size_t item = 100000;
+    size_t member = 10000;
+    unsigned thread = 2;
+    int laporanPermil = 1;  // sisanya pinjam/kembali
+};
+
+struct HasilKlien {
+    enum Op { PINJAM, KEMBALI, KEMBALI_DVD, LAPORAN, JUMLAH_OP };
+    array<vector<uint32_t>, JUMLAH_OP> lat;  // ns
+    size_t error = 0;
+    size_t koneksiGagal = 0;
+    double detik = 0.0;
+};
+
+// id item/member sintetis yang dipake klien; setiap item ke-5 DVD
+inline string idItemKlien(size_t i) { return (i % 5 == 0 ? "LD" : "LB") + to_string(i); }
+inline string idMemberKlien(size_t m) { return "LU" + to_string(m); }
+
+// isi server pake item + member sintetis lewat satu koneksi, dikirim per
+// potongan biar socket-nya ga macet nunggu jawaban yang ga dibaca
+bool siapkanDataKlien(const AlamatServer& alamat, const KonfigKlien& konfig) {
+    int fd = sambungKe(alamat);
+    if (fd < 0) return false;
+    const size_t total = konfig.item + konfig.member, potongan = 2048;
+    bool ok = true;
+    for (size_t mulai = 0; mulai < total && ok; mulai += potongan) {
+        string kirim;
+        size_t akhir = min(total, mulai + potongan);
+        for (size_t j = mulai; j < akhir; j++) {
+            if (j < konfig.item) {
+                kirim += (j % 5 == 0 ? "dvd|" : "book|") + idItemKlien(j) + "|Judul " + to_string(j) + "|Orang " +
+                         to_string(j % 997) + (j % 5 == 0 ? "\n" : "|0\n");
+            } else {
+                size_t m = j - konfig.item;
+                kirim += "member|" + idMemberKlien(m) + "|Member " + to_string(m) + "\n";
+            }
+        }
+        ok = send(fd, kirim.data(), kirim.size(), MSG_NOSIGNAL) == static_cast<ssize_t>(kirim.size());
+        size_t baris = 0;  // tunggu semua jawabannya (ID dobel dari run sebelumnya gapapa)
+        char tmp[1 << 16];
+        while (ok && baris < akhir - mulai) {
+            ssize_t n = read(fd, tmp, sizeof(tmp));
+            if (n <= 0) ok = false;
+            else baris += count(tmp, tmp + n, '\n');
+        }
+    }
+    close(fd);
+    return ok;
+}
+
+HasilKlien jalankanKlien(const AlamatServer& alamat, const KonfigKlien& konfig, uint64_t seed) {
+    using Jam = chrono::steady_clock;
+    struct Tunggu {
+        Jam::time_point mulai;
+        HasilKlien::Op op;
+    };
+    struct KoneksiKlien {
+        int fd = -1;
+        size_t nomor = 0;  // nomor koneksi global
+        string keluar, masuk;
+        size_t posKeluar = 0;
+        vector<Tunggu> tunggu;  // ring sebesar kedalaman
+        size_t kepala = 0, jumlahTunggu = 0;
+        size_t jatah = 0, terkirim = 0, beres = 0;
+        size_t itemKe = 0;      // item ke-berapa dari bagian koneksi ini
+        bool lagiPinjam = false;
+        size_t sisaTeks = 0;    // baris TEKS yang masih harus dilewatin
+        mt19937_64 rng;
+    };
+
+    HasilKlien hasil;
+    const size_t nKoneksi = max<size_t>(1, konfig.koneksi);
+    const unsigned nThread = static_cast<unsigned>(min<size_t>(max(1u, konfig.thread), nKoneksi));
+    vector<HasilKlien> perThread(nThread);
+    atomic<size_t> gagalSambung(0);
+
+    auto kerja = [&](unsigned t) {
+        HasilKlien& h = perThread[t];
+        vector<KoneksiKlien> daftar;
+        for (size_t c = t; c < nKoneksi; c += nThread) {
+            KoneksiKlien k;
+            k.nomor = c;
+            k.jatah = konfig.request / nKoneksi + (c < konfig.request % nKoneksi);
+            k.tunggu.resize(max<size_t>(1, konfig.kedalaman));
+            k.rng.seed(seed * 7919 + c);
+            k.fd = sambungKe(alamat);
+            if (k.fd < 0) {
+                gagalSambung++;
+                continue;
+            }
+            fcntl(k.fd, F_SETFL, fcntl(k.fd, F_GETFL) | O_NONBLOCK);
+            daftar.push_back(move(k));
+        }
+        int ep = epoll_create1(EPOLL_CLOEXEC);
+        for (size_t i = 0; i < daftar.size(); i++) {
+            epoll_event e{};
+            e.events = EPOLLIN | EPOLLOUT;
+            e.data.u64 = i;
+            epoll_ctl(ep, EPOLL_CTL_ADD, daftar[i].fd, &e);
+        }
+
+        const size_t bagian = max<size_t>(1, konfig.item / nKoneksi);
+        auto isi = [&](KoneksiKlien& k) {
+            while (k.jumlahTunggu < k.tunggu.size() && k.terkirim < k.jatah) {
+                HasilKlien::Op op;
+                size_t i = (k.nomor + (k.itemKe % bagian) * nKoneksi) % konfig.item;
+                string m = idMemberKlien(k.nomor % konfig.member);
+                if (static_cast<int>(k.rng() % 1000) < konfig.laporanPermil) {
+                    op = HasilKlien::LAPORAN;
+                    k.keluar += "laporan\n";
+                } else if (!k.lagiPinjam) {
+                    op = HasilKlien::PINJAM;
+                    k.keluar += "pinjam|" + m + "|" + idItemKlien(i) + "|3|0\n";
+                    k.lagiPinjam = true;
+                } else {
+                    int hari = 1 + static_cast<int>(k.rng() % 10);
+                    if (i % 5 == 0) {
+                        op = HasilKlien::KEMBALI_DVD;
+                        k.keluar += "kembalidvd|" + m + "|" + idItemKlien(i) + "|" + to_string(hari) + "|0\n";
+                    } else {
+                        op = HasilKlien::KEMBALI;
+                        k.keluar += "kembali|" + m + "|" + idItemKlien(i) + "|" + to_string(hari) + "\n";
+                    }
+                    k.lagiPinjam = false;
+                    k.itemKe++;
+                }
+                k.tunggu[(k.kepala + k.jumlahTunggu++) % k.tunggu.size()] = {Jam::now(), op};
+                k.terkirim++;
+            }
+            while (k.posKeluar < k.keluar.size()) {
+                ssize_t n = send(k.fd, k.keluar.data() + k.posKeluar, k.keluar.size() - k.posKeluar, MSG_NOSIGNAL);
+                if (n <= 0) break;
+                k.posKeluar += n;
+            }
+            if (k.posKeluar == k.keluar.size()) {
+                k.keluar.clear();
+                k.posKeluar = 0;
+            }
+        };
+        auto jawabanUtuh = [&](KoneksiKlien& k, bool error) {
+            Tunggu w = k.tunggu[k.kepala];
+            k.kepala = (k.kepala + 1) % k.tunggu.size();
+            k.jumlahTunggu--;
+            k.beres++;
+            h.error += error;
+            h.lat[w.op].push_back(static_cast<uint32_t>(
+                chrono::duration_cast<chrono::nanoseconds>(Jam::now() - w.mulai).count()));
+        };
+        auto baca = [&](KoneksiKlien& k) {
+            char tmp[1 << 16];
+            ssize_t n;
+            while ((n = read(k.fd, tmp, sizeof(tmp))) > 0) k.masuk.append(tmp, n);
+            if (n == 0) return false;
+            size_t pos = 0, nl;
+            while ((nl = k.masuk.find('\n', pos)) != string::npos) {
+                string_view baris(k.masuk.data() + pos, nl - pos);
+                pos = nl + 1;
+                if (k.sisaTeks > 0) {
+                    if (--k.sisaTeks == 0) jawabanUtuh(k, false);
+                } else if (baris.substr(0, 5) == "TEKS ") {
+                    int nBaris = 0;
+                    parseInt(baris.substr(5), nBaris);
+                    k.sisaTeks = nBaris;
+                    if (nBaris == 0) jawabanUtuh(k, false);
+                } else {
+                    jawabanUtuh(k, baris.substr(0, 2) != "OK");
+                }
+            }
+            k.masuk.erase(0, pos);
+            return true;
+        };
+
+        size_t aktif = daftar.size();
+        for (auto& k : daftar) {
+            if (k.jatah == 0) {
+                epoll_ctl(ep, EPOLL_CTL_DEL, k.fd, nullptr);
+                aktif--;
+                continue;
+            }
+            isi(k);
+        }
+        vector<epoll_event> ev(256);
+        while (aktif > 0) {
+            int n = epoll_wait(ep, ev.data(), static_cast<int>(ev.size()), 1000);
+            if (n < 0 && errno != EINTR) break;
+            if (n == 0) break;  // server diem sedetik - anggap macet
+            for (int j = 0; j < n; j++) {
+                KoneksiKlien& k = daftar[ev[j].data.u64];
+                if (k.beres == k.jatah) continue;
+                bool hidup = !(ev[j].events & EPOLLERR);
+                if (hidup && (ev[j].events & (EPOLLIN | EPOLLHUP))) hidup = baca(k);
+                if (hidup) isi(k);
+                if (!hidup || k.beres == k.jatah) {
+                    epoll_ctl(ep, EPOLL_CTL_DEL, k.fd, nullptr);
+                    aktif--;
+                    h.koneksiGagal += !hidup;
+                    continue;
+                }
+                epoll_event e{};
+                e.events = EPOLLIN | (k.keluar.empty() ? 0u : uint32_t(EPOLLOUT));
+                e.data.u64 = ev[j].data.u64;
+                epoll_ctl(ep, EPOLL_CTL_MOD, k.fd, &e);
+            }
+        }
+        h.koneksiGagal += aktif;
+        for (auto& k : daftar) close(k.fd);
+        close(ep);
+    };
+
+    hasil.detik = ukurDetik([&] {
+        vector<thread> th;
+        for (unsigned t = 0; t < nThread; t++) th.emplace_back(kerja, t);
+        for (auto& x : th) x.join();
+    });
+    for (HasilKlien& h : perThread) {
+        for (int op = 0; op < HasilKlien::JUMLAH_OP; op++) {
+            hasil.lat[op].insert(hasil.lat[op].end(), h.lat[op].begin(), h.lat[op].end());
+        }
+        hasil.error += h.error;
+        hasil.koneksiGagal += h.koneksiGagal;
+    }
+    hasil.koneksiGagal += gagalSambung;
+    return hasil;
+}
+
+// server + klien di satu proses (unix socket), atau --alamat buat nembak
+// server yang udah jalan. opsi: --koneksi --kedalaman --ops --item --member
+// --pekerja --thread --laporan (permil) --seed
+void benchmarkServer(const OpsiBench& opsi) {
+    KonfigKlien konfig;
+    konfig.koneksi = max<long long>(1, opsi.angka("koneksi", 256));
+    konfig.kedalaman = max<long long>(1, opsi.angka("kedalaman", 4));
+    konfig.request = max<long long>(1, opsi.angka("ops", 1000000));
+    konfig.item = max<long long>(1, opsi.angka("item", 100000));
+    konfig.member = max<long long>(1, opsi.angka("member", 10000));
+    konfig.thread = static_cast<unsigned>(max<long long>(1, opsi.angka("thread", 2)));
+    konfig.laporanPermil = static_cast<int>(opsi.angka("laporan", 1));
+    unsigned nPekerja = static_cast<unsigned>(max<long long>(1, opsi.angka("pekerja", thread::hardware_concurrency())));
+    uint64_t seed = static_cast<uint64_t>(opsi.angka("seed", 42));
+    string teksAlamat = opsi.teks("alamat", "");
+    bool lokal = teksAlamat.empty();
+    if (lokal) teksAlamat = "unix:bench_server.sock";
+
+    AlamatServer alamat;
+    if (!parseAlamat(teksAlamat, alamat)) {
+        cout << "❌ Alamat " << teksAlamat << " ga valid" << endl;
+        return;
+    }
+    cout << "\n⏱️  === BENCHMARK SERVER (" << teksAlamat << ", " << konfig.koneksi << " koneksi, kedalaman "
+         << konfig.kedalaman << ") ===" << endl;
+
+    signal(SIGPIPE, SIG_IGN);
+    Perpustakaan perpus;
+    unique_ptr<ServerPerpustakaan> server;
+    thread loop;
+    if (lokal) {
+        int fdListen = bukaSocketServer(alamat);
+        if (fdListen < 0) {
+            cout << "❌ Gagal buka socket: " << strerror(errno) << endl;
+            return;
+        }
+        server = make_unique<ServerPerpustakaan>(perpus, fdListen, nPekerja);
+        loop = thread([&] { server->jalan(); });
+        cout << "server lokal: " << server->jumlahPekerja() << " pekerja" << endl;
+    }
+
+    bool siap = false;
+    double tSiap = ukurDetik([&] { siap = siapkanDataKlien(alamat, konfig); });
+    HasilKlien hasil;
+    if (siap) hasil = jalankanKlien(alamat, konfig, seed);
+    else cout << "❌ Gagal nyiapin data di server " << teksAlamat << endl;
+    if (lokal) {
+        server->berhentikan();
+        loop.join();
+        ServerPerpustakaan::Statistik s = server->statistik();
+        cout << "server: " << s.perintah << " perintah dalam " << s.tugas << " tugas (rata2 " << fixed
+             << setprecision(1) << double(s.perintah) / max<size_t>(1, s.tugas) << " per tugas)" << endl;
+        server.reset();
+        remove(alamat.path.c_str());
+    }
+
+    static const char* NAMA_OP[HasilKlien::JUMLAH_OP] = {"pinjam", "kembali", "kembali_dvd", "laporan"};
+    size_t total = 0;
+    for (auto& v : hasil.lat) total += v.size();
+    if (!siap) return;
+    cout << "setup " << konfig.item << " item + " << konfig.member << " member: " << fixed << setprecision(0)
+         << tSiap * 1e3 << " ms" << endl;
+    cout << total << " request dalam " << setprecision(3) << hasil.detik << " s = " << setprecision(0)
+         << total / hasil.detik << " req/s, " << hasil.error << " ERR, " << hasil.koneksiGagal
+         << " koneksi gagal" << endl;
+    cout << setw(13) << left << "operasi" << right << setw(10) << "jumlah" << setw(10) << "p50 us" << setw(10)
+         << "p99 us" << setw(10) << "p999 us" << setw(10) << "max us" << endl;
+    for (int op = 0; op < HasilKlien::JUMLAH_OP; op++) {
+        vector<uint32_t>& v = hasil.lat[op];
+        sort(v.begin(), v.end());
+        cout << setw(13) << left << NAMA_OP[op] << right << setw(10) << v.size() << setprecision(1) << setw(10)
+             << persentil(v, 0.50) / 1e3 << setw(10) << persentil(v, 0.99) / 1e3 << setw(10)
+             << persentil(v, 0.999) / 1e3 << setw(10) << (v.empty() ? 0.0 : v.back() / 1e3) << endl;
+    }
+}
+#endif
+
+// beban sintetis yang bisa diulang: katalog Book/Magazine/DVD + member
+// sesuai ukuran, terus tiap thread muter pinjam/kembali/kembaliDVD dari
+// RNG ber-seed. item dipilih zipf (ada yang laris banget), member uniform.
+// opsi: --item --member --ops --thread --seed --zipf --log 0/1 --json <path|->
+// hasil JSON satu baris di-append ke file-nya, jadi bisa dilacak antar versi
+void benchmarkBeban(const OpsiBench& opsi) {
+    const size_t nItem = max<long long>(1, opsi.angka("item", 200000));
+    const size_t nMember = max<long long>(1, opsi.angka("member", 20000));
+    const size_t nOps = max<long long>(1, opsi.angka("ops", 1000000));
+    const unsigned nThread = static_cast<unsigned>(max<long long>(1, opsi.angka("thread", 1)));
+    const uint64_t seed = static_cast<uint64_t>(opsi.angka("seed", 42));
+    const double s = opsi.desimal("zipf", 0.99);
+    const bool pakeLog = opsi.angka("log", 0) != 0;
+    const string pathJson = opsi.teks("json", "");
+    const string pathLog = "bench_beban.wal";
+    cout << "\n⏱️  === BENCHMARK BEBAN (seed " << seed << ") ===" << endl;
+
+    // katalog: 50% Book (5% langka), 30% Magazine, 20% DVD
+    mt19937_64 rng(seed);
+    Perpustakaan perpus;
+    perpus.setJam([] { return int32_t(20000); });  // hari tetep biar laporan ikut deterministik
+    perpus.reserve(nItem, nMember);
+    vector<string> idItem(nItem), idMember(nMember);
+    vector<uint8_t> kodeItem(nItem);
+    vector<int> maxHari(nItem);
+    for (size_t i = 0; i < nItem; i++) {
+        string nomor = to_string(i);
+        uint64_t r = rng() % 100;
+        DataItem item;
+        if (r < 50) item = Book("B" + nomor, "Buku " + nomor, "Penulis " + to_string(i % 997), rng() % 20 == 0);
+        else if (r < 80) item = Magazine("M" + nomor, "Majalah " + nomor, "Edisi " + to_string(i % 12));
+        else item = DVD("D" + nomor, "Film " + nomor, "Sutradara " + to_string(i % 331));
+        idItem[i] = item.id;
+        kodeItem[i] = item.kode;
+        maxHari[i] = kebijakan().maxHari(item.kode, item.varian);
+        perpus.tambahItem(item);
+    }
+    for (size_t m = 0; m < nMember; m++) {
+        idMember[m] = "U" + to_string(m);
+        perpus.registerMember(make_unique<Member>(idMember[m], "Member " + to_string(m)));
+    }
+    if (pakeLog) {
+        remove(pathLog.c_str());
+        perpus.aktifkanLog(pathLog);
+    }
+    GeneratorZipf zipf(nItem, s, seed ^ 0x9E3779B97F4A7C15ULL);
+
+    enum Op { PINJAM, KEMBALI, KEMBALI_DVD, JUMLAH_OP };
+    static const char* NAMA_OP[JUMLAH_OP] = {"pinjam", "kembali", "kembali_dvd"};
+    struct HasilThread {
+        array<vector<uint32_t>, JUMLAH_OP> lat;  // ns per operasi
+        array<size_t, JUMLAH_OP> sukses{};
+    };
+    vector<HasilThread> hasil(nThread);
+
+    double detik = ukurDetik([&] {
+        vector<thread> pekerja;
+        for (unsigned t = 0; t < nThread; t++) {
+            pekerja.emplace_back([&, t] {
+                HasilThread& h = hasil[t];
+                mt19937_64 r(seed * 1000003 + t);
+                size_t jatah = nOps / nThread + (t < nOps % nThread);
+                for (auto& v : h.lat) v.reserve(jatah / 2);
+                // pinjaman thread ini yang belum balik: (item, member)
+                vector<pair<uint32_t, uint32_t>> pinjaman;
+                size_t batasPinjaman = max<size_t>(1, nItem / (4 * nThread));
+
+                for (size_t k = 0; k < jatah; k++) {
+                    bool balik = !pinjaman.empty() && (r() % 100 < 45 || pinjaman.size() >= batasPinjaman);
+                    if (!balik) {
+                        uint32_t i = zipf.ambil(r);
+                        uint32_t m = static_cast<uint32_t>(r() % nMember);
+                        int hari = 1 + static_cast<int>(r() % maxHari[i]);
+                        bool kredit = r() % 10 == 0;
+                        auto mulai = chrono::steady_clock::now();
+                        HasilTransaksi hs = perpus.prosesPinjam(idMember[m], idItem[i], hari, kredit);
+                        auto lama = chrono::steady_clock::now() - mulai;
+                        h.lat[PINJAM].push_back(static_cast<uint32_t>(chrono::duration_cast<chrono::nanoseconds>(lama).count()));
+                        if (hs.ok()) {
+                            h.sukses[PINJAM]++;
+                            pinjaman.push_back({i, m});
+                        }
+                        continue;
+                    }
+
+                    size_t idx = r() % pinjaman.size();
+                    auto [i, m] = pinjaman[idx];
+                    pinjaman[idx] = pinjaman.back();
+                    pinjaman.pop_back();
+                    int hariAktual = 1 + static_cast<int>(r() % (maxHari[i] + 5));  // sebagian telat
+                    Op op = kodeItem[i] == DVD::KODE ? KEMBALI_DVD : KEMBALI;
+                    auto mulai = chrono::steady_clock::now();
+                    HasilTransaksi hs = op == KEMBALI_DVD
+                                            ? perpus.prosesKembaliDVD(idMember[m], idItem[i], hariAktual, r() % 20 == 0)
+                                            : perpus.prosesKembali(idMember[m], idItem[i], hariAktual);
+                    auto lama = chrono::steady_clock::now() - mulai;
+                    h.lat[op].push_back(static_cast<uint32_t>(chrono::duration_cast<chrono::nanoseconds>(lama).count()));
+                    h.sukses[op] += hs.ok();
+                }
+            });
+        }
+        for (auto& p : pekerja) p.join();
+    });
+    if (pakeLog) remove(pathLog.c_str());  // log-nya ditutup pas perpus bubar
+
+    // gabung sampel semua thread per operasi
+    char tmp[256];
+    snprintf(tmp, sizeof(tmp),
+             "{\"bench\":\"beban\",\"item\":%zu,\"member\":%zu,\"ops\":%zu,\"thread\":%u,\"seed\":%llu,"
+             "\"zipf\":%.3f,\"log\":%d,\"detik\":%.4f,\"ops_per_detik\":%.0f,\"operasi\":{",
+             nItem, nMember, nOps, nThread, static_cast<unsigned long long>(seed), s, pakeLog ? 1 : 0, detik,
+             nOps / detik);
+    string json = tmp;
+    cout << nItem << " item, " << nMember << " member, " << nOps << " operasi, " << nThread << " thread, zipf "
+         << s << (pakeLog ? ", pake WAL" : "") << endl;
+    cout << "total: " << fixed << setprecision(3) << detik << " s, " << setprecision(0) << nOps / detik
+         << " op/s" << endl;
+    cout << setw(13) << left << "operasi" << right << setw(10) << "jumlah" << setw(9) << "sukses" << setw(10)
+         << "p50 us" << setw(10) << "p99 us" << setw(10) << "p999 us" << setw(10) << "max us" << endl;
+    for (int op = 0; op < JUMLAH_OP; op++) {
+        vector<uint32_t> semua;
+        size_t sukses = 0;
+        for (HasilThread& h : hasil) {
+            semua.insert(semua.end(), h.lat[op].begin(), h.lat[op].end());
+            sukses += h.sukses[op];
+        }
+        sort(semua.begin(), semua.end());
+        double p50 = persentil(semua, 0.50) / 1e3, p99 = persentil(semua, 0.99) / 1e3;
+        double p999 = persentil(semua, 0.999) / 1e3, maks = semua.empty() ? 0.0 : semua.back() / 1e3;
+        cout << setw(13) << left << NAMA_OP[op] << right << setw(10) << semua.size() << setw(9) << sukses
+             << setprecision(2) << setw(10) << p50 << setw(10) << p99 << setw(10) << p999 << setw(10) << maks << endl;
+        snprintf(tmp, sizeof(tmp),
+                 "%s\"%s\":{\"n\":%zu,\"sukses\":%zu,\"p50_us\":%.3f,\"p99_us\":%.3f,\"p999_us\":%.3f,\"max_us\":%.3f}",
+                 op ? "," : "", NAMA_OP[op], semua.size(), sukses, p50, p99, p999, maks);
+        json += tmp;
+    }
+    json += "}}\n";
+
+    if (pathJson == "-") {
+        cout << json;
+    } else if (!pathJson.empty()) {
+        FILE* f = fopen(pathJson.c_str(), "ab");
+        if (f) {
+            fwrite(json.data(), 1, json.size(), f);
+            fclose(f);
+            cout << "📝 Hasil di-append ke " << pathJson << endl;
+        } else {
+            cout << "❌ Gagal nulis " << pathJson << endl;
+        }
+    }
+}
+
+// contention judul laris: semua thread rebutan beberapa eksemplar satu judul.
+// mode coba-ulang: gagal pinjam -> yield -> pinjam lagi (badai retry, yang
+// hoki yang dapet). mode reservasi: gagal pinjam -> masuk antrean, tinggal
+// nunggu eksemplar diserahin pas ada yang balikin. sink-nya cuma nyalain
+// bendera thread penerima, dipasang di dua mode biar ongkos event-nya sama
+class SinkSerahan : public EventSink {
+private:
+    vector<atomic<bool>>& dapat;
+
+public:
+    explicit SinkSerahan(vector<atomic<bool>>& dapat) : dapat(dapat) {}
+
+    void terima(const Event& ev) override {
+        if (ev.idPenerima.size() < 2) return;
+        uint32_t t = 0;
+        from_chars(ev.idPenerima.data() + 1, ev.idPenerima.data() + ev.idPenerima.size(), t);
+        if (t < dapat.size()) dapat[t].store(true, memory_order_release);
+    }
+};
+
+void benchmarkEksemplar(const OpsiBench& opsi) {
+    const unsigned nThread = static_cast<unsigned>(max<long long>(2, opsi.angka("thread", 8)));
+    const size_t putaran = max<long long>(1, opsi.angka("ops", 20000));  // pinjaman sukses per thread
+    const uint32_t nEksemplar = static_cast<uint32_t>(max<long long>(1, opsi.angka("eksemplar", 2)));
+    const int tahan = static_cast<int>(max<long long>(0, opsi.angka("tahan", 2)));  // yield selama megang eksemplar
+    cout << "\n⏱️  === BENCHMARK JUDUL LARIS (" << nThread << " thread, " << nEksemplar << " eksemplar, "
+         << putaran << " pinjaman/thread) ===" << endl;
+    cout << setw(12) << left << "mode" << right << setw(10) << "pinjam/s" << setw(12) << "coba/dapet" << setw(10)
+         << "p50 us" << setw(10) << "p99 us" << setw(10) << "max us" << setw(12) << "rentang" << endl;
+
+    for (bool pakeReservasi : {false, true}) {
+        Perpustakaan perpus;
+        perpus.setJam([] { return int32_t(20000); });
+        perpus.tambahItem(Book("LARIS", "Judul Laris", "Penulis Laris"));
+        perpus.aturEksemplar("LARIS", nEksemplar);
+        vector<string> idMember(nThread);
+        for (unsigned t = 0; t < nThread; t++) {
+            idMember[t] = "T" + to_string(t);
+            perpus.registerMember(make_unique<Member>(idMember[t], "Thread " + to_string(t)));
+        }
+        vector<atomic<bool>> dapat(nThread);
+        SinkSerahan sink(dapat);
+        perpus.pasangSink(&sink);
+
+        // per thread: waktu dari coba pertama sampe megang eksemplar + jumlah percobaan
+        vector<vector<uint32_t>> tunggu(nThread);
+        vector<size_t> coba(nThread);
+        double detik = ukurDetik([&] {
+            vector<thread> pekerja;
+            for (unsigned t = 0; t < nThread; t++) {
+                pekerja.emplace_back([&, t] {
+                    const string& m = idMember[t];
+                    tunggu[t].reserve(putaran);
+                    for (size_t k = 0; k < putaran; k++) {
+                        auto mulai = chrono::steady_clock::now();
+                        while (true) {
+                            coba[t]++;
+                            if (perpus.prosesPinjam(m, "LARIS", 7).ok()) break;
+                            if (!pakeReservasi) {
+                                this_thread::yield();
+                                continue;
+                            }
+                            // rak kosong: ngantre. ITEM_TERSEDIA = keburu ada yang balik, pinjem lagi
+                            if (perpus.prosesReservasi(m, "LARIS").status != StatusTransaksi::SUKSES) continue;
+                            while (!dapat[t].load(memory_order_acquire)) this_thread::yield();
+                            dapat[t].store(false, memory_order_relaxed);
+                            break;
+                        }
+                        auto lama = chrono::steady_clock::now() - mulai;
+                        tunggu[t].push_back(
+                            static_cast<uint32_t>(chrono::duration_cast<chrono::nanoseconds>(lama).count()));
+                        for (int y = 0; y < tahan; y++) this_thread::yield();
+                        perpus.prosesKembali(m, "LARIS", 3);
+                    }
+                });
+            }
+            for (auto& p : pekerja) p.join();
+        });
+        perpus.pasangSink(nullptr);
+
+        vector<uint32_t> semua;
+        size_t totalCoba = 0;
+        // rentang = thread paling rajin dapet / paling sial, dari median tunggunya
+        double medMin = 1e300, medMaks = 0.0;
+        for (unsigned t = 0; t < nThread; t++) {
+            totalCoba += coba[t];
+            vector<uint32_t> v = tunggu[t];
+            sort(v.begin(), v.end());
+            medMin = min<double>(medMin, persentil(v, 0.5));
+            medMaks = max<double>(medMaks, persentil(v, 0.5));
+            semua.insert(semua.end(), v.begin(), v.end());
+        }
+        sort(semua.begin(), semua.end());
+        size_t total = semua.size();
+        cout << setw(12) << left << (pakeReservasi ? "reservasi" : "coba-ulang") << right << fixed << setprecision(0)
+             << setw(10) << total / detik << setprecision(2) << setw(12) << double(totalCoba) / total << setw(10)
+             << persentil(semua, 0.50) / 1e3 << setw(10) << persentil(semua, 0.99) / 1e3 << setw(10)
+             << semua.back() / 1e3 << setw(11) << (medMin > 0 ? medMaks / medMin : 0.0) << "x" << endl;
+        if (perpus.jumlahPinjamanAktif() != 0) cout << "  ❌ masih ada pinjaman nyangkut!" << endl;
+    }
+}
+
+// riwayat pinjaman kolom delta vs vector<Record> per member (AoS 16 byte).
+// pinjaman dibangkitin urut hari, member & item kepilih zipf
+void benchmarkRiwayat(const OpsiBench& opsi) {
+    const size_t nMember = max<long long>(1, opsi.angka("member", 100000));
+    const size_t nItem = max<long long>(1, opsi.angka("item", 200000));
+    const size_t nPinjam = max<long long>(1, opsi.angka("ops", 5000000));
+    const int32_t nHari = static_cast<int32_t>(max<long long>(1, opsi.angka("hari", 1095)));
+    const size_t k = max<long long>(1, opsi.angka("k", 10));
+    const uint64_t seed = static_cast<uint64_t>(opsi.angka("seed", 42));
+    const double s = opsi.desimal("zipf", 0.8);
+    cout << "\n⏱️  === BENCHMARK RIWAYAT MEMBER (" << nMember << " member, " << nItem << " item, " << nPinjam
+         << " pinjaman, " << nHari << " hari, zipf " << s << ") ===" << endl;
+
+    mt19937_64 rng(seed);
+    vector<uint8_t> tag(nItem);
+    for (uint8_t& t : tag) t = static_cast<uint8_t>(1 + rng() % (JUMLAH_KODE_TIPE - 1));
+    GeneratorZipf zipfMember(nMember, s, seed + 1), zipfItem(nItem, s, seed + 2);
+    struct Baris {
+        uint32_t slotMember;
+        RiwayatPinjaman::Record r;
+    };
+    vector<Baris> log(nPinjam);
+    for (size_t i = 0; i < nPinjam; i++) {
+        uint32_t telat = rng() % 10 == 0 ? static_cast<uint32_t>(1 + rng() % 14) : 0;
+        log[i] = {zipfMember.ambil(rng),
+                  {zipfItem.ambil(rng), static_cast<int32_t>(i * nHari / nPinjam), telat, telat * 1000}};
+    }
+    auto tagFn = [&](uint32_t slot) { return tag[slot]; };
+
+    RiwayatPinjaman riwayat;
+    riwayat.reserve(nMember);
+    for (size_t m = 0; m < nMember; m++) riwayat.tambahMember();
+    double tKolom = ukurDetik([&] {
+        for (const Baris& b : log) {
+            riwayat.catat(b.slotMember, b.r.slotItem, tag[b.r.slotItem], b.r.hari, b.r.hariTelat, b.r.denda);
+        }
+    });
+    // pembanding dikunci per shard juga, sama kaya RiwayatPinjaman yang dipanggil barengan dari banyak thread
+    vector<vector<RiwayatPinjaman::Record>> naif(nMember);
+    array<mutex, 16> kunciNaif;
+    double tNaif = ukurDetik([&] {
+        for (const Baris& b : log) {
+            lock_guard<mutex> lk(kunciNaif[b.slotMember % kunciNaif.size()]);
+            naif[b.slotMember].push_back(b.r);
+        }
+    });
+    RiwayatPinjaman::Memori mem = riwayat.memori();
+    size_t byteNaif = nMember * sizeof(vector<RiwayatPinjaman::Record>);
+    for (const auto& v : naif) byteNaif += v.capacity() * sizeof(RiwayatPinjaman::Record);
+
+    cout << setw(26) << left << "" << right << setw(14) << "kolom delta" << setw(14) << "vector AoS" << endl;
+    cout << setw(26) << left << "catat (juta/s)" << right << fixed << setprecision(2) << setw(14)
+         << nPinjam / tKolom / 1e6 << setw(14) << nPinjam / tNaif / 1e6 << endl;
+    cout << setw(26) << left << "byte/pinjaman" << right << setw(14)
+         << double(mem.byteArena + mem.byteRingkasan) / nPinjam << setw(14) << double(byteNaif) / nPinjam << endl;
+    cout << setw(26) << left << "total MB" << right << setw(14) << (mem.byteArena + mem.byteRingkasan) / 1e6
+         << setw(14) << byteNaif / 1e6 << endl;
+
+    // scan per member, 2000 member acak (berbobot zipf, jadi yang rajin lebih
+    // sering): semua riwayat + 90 hari terakhir. vector-nya urut hari, jadi
+    // rentangnya dicari pake lower_bound biar adil
+    vector<uint32_t> sampel(2000);
+    for (uint32_t& m : sampel) m = zipfMember.ambil(rng);
+    int32_t awal90 = nHari - 90;
+    auto bandingHari = [](const RiwayatPinjaman::Record& r, int32_t h) { return r.hari < h; };
+    for (int rentang = 0; rentang < 2; rentang++) {
+        int32_t dari = rentang ? awal90 : RiwayatPinjaman::AWAL_WAKTU;
+        uint64_t cekKolom = 0, cekNaif = 0;
+        double tScanKolom = ukurDetik([&] {
+            for (uint32_t m : sampel) {
+                riwayat.jelajah(m, dari, nHari, [&](const RiwayatPinjaman::Record& r) { cekKolom += r.slotItem + r.denda; });
+            }
+        });
+        double tScanNaif = ukurDetik([&] {
+            for (uint32_t m : sampel) {
+                auto it = lower_bound(naif[m].begin(), naif[m].end(), dari, bandingHari);
+                for (; it != naif[m].end(); ++it) cekNaif += it->slotItem + it->denda;
+            }
+        });
+        cout << setw(26) << left << (rentang ? "scan 90 hari (us/member)" : "scan member (us/member)") << right
+             << setw(14) << tScanKolom * 1e6 / sampel.size() << setw(14) << tScanNaif * 1e6 / sampel.size()
+             << (cekKolom == cekNaif ? "" : "  ❌ beda!") << endl;
+    }
+
+    // top-K: sepanjang masa, setahun terakhir, setahun terakhir tipe Book
+    auto naifTop = [&](uint8_t kode, int32_t dari, int32_t sampai) {
+        vector<pair<uint64_t, uint32_t>> hitung;
+        for (uint32_t m = 0; m < nMember; m++) {
+            uint64_t n = 0;
+            auto it = lower_bound(naif[m].begin(), naif[m].end(), dari, bandingHari);
+            for (; it != naif[m].end() && it->hari <= sampai; ++it) n += kode == 0 || tag[it->slotItem] == kode;
+            if (n) hitung.emplace_back(n, m);
+        }
+        size_t kk = min(k, hitung.size());
+        partial_sort(hitung.begin(), hitung.begin() + kk, hitung.end(),
+                     [](const auto& a, const auto& b) { return a.first != b.first ? a.first > b.first : a.second < b.second; });
+        hitung.resize(kk);
+        return hitung;
+    };
+    struct Kasus {
+        const char* nama;
+        uint8_t kode;
+        int32_t dari, sampai;
+    };
+    const Kasus kasus[] = {{"top-K sepanjang masa (ms)", 0, RiwayatPinjaman::AWAL_WAKTU, RiwayatPinjaman::AKHIR_WAKTU},
+                           {"top-K 365 hari (ms)", 0, nHari - 365, nHari},
+                           {"top-K 365 hari Book (ms)", Book::KODE, nHari - 365, nHari}};
+    for (const Kasus& c : kasus) {
+        vector<RiwayatPinjaman::Peringkat> top;
+        vector<pair<uint64_t, uint32_t>> topNaif;
+        double tTop = ukurDetik([&] { top = riwayat.top(k, c.kode, c.dari, c.sampai, tagFn); });
+        double tTopNaif = ukurDetik([&] { topNaif = naifTop(c.kode, c.dari, c.sampai); });
+        bool sama = top.size() == topNaif.size();
+        for (size_t i = 0; sama && i < top.size(); i++) {
+            sama = top[i].slotMember == topNaif[i].second && top[i].jumlah == topNaif[i].first;
+        }
+        cout << setw(26) << left << c.nama << right << setw(14) << tTop * 1e3 << setw(14) << tTopNaif * 1e3
+             << (sama ? "" : "  ❌ beda!") << endl;
+    }
+
+    // rasio telat populasi 90 hari terakhir
+    RiwayatPinjaman::Agregat a;
+    double tAgregat = ukurDetik([&] { a = riwayat.agregat(awal90, nHari, 0, tagFn); });
+    RiwayatPinjaman::Agregat b;
+    double tAgregatNaif = ukurDetik([&] {
+        for (const auto& v : naif) {
+            for (auto it = lower_bound(v.begin(), v.end(), awal90, bandingHari); it != v.end(); ++it) {
+                b.jumlah++;
+                b.telat += it->hariTelat > 0;
+                b.denda += it->denda;
+            }
+        }
+    });
+    cout << setw(26) << left << "rasio telat 90 hari (ms)" << right << setw(14) << tAgregat * 1e3 << setw(14)
+         << tAgregatNaif * 1e3 << (a.jumlah == b.jumlah && a.telat == b.telat && a.denda == b.denda ? "" : "  ❌ beda!")
+         << endl;
+    cout << "Rasio telat 90 hari: " << setprecision(1) << a.rasioTelat() << "% dari " << a.jumlah << " pinjaman" << endl;
+}
+
+// laporan/backup jalan barengan sama transaksi: simpan snapshot model lama
+// (lock exclusive dipegang selama nulis, sama kaya checkpoint) vs lewat
+// potret copy-on-write. thread transaksi pinjam/balikin terus selama
+// `detik`, satu thread reporter nyimpen snapshot berulang2. snapshot
+// terakhir dimuat ulang buat ngecek konsisten: pinjaman yang belum balik
+// menurut member == pinjaman aktif == item yang lagi ga di rak
+void benchmarkPotret(const OpsiBench& opsi) {
+    const size_t nItem = max<long long>(1, opsi.angka("item", 200000));
+    const size_t nMember = max<long long>(1, opsi.angka("member", 20000));
+    const unsigned nThread = static_cast<unsigned>(max<long long>(1, opsi.angka("thread", 2)));
+    const double detik = max(0.1, opsi.desimal("detik", 2.0));
+    const uint64_t seed = static_cast<uint64_t>(opsi.angka("seed", 42));
+    const unsigned nTumpang = static_cast<unsigned>(max<long long>(0, opsi.angka("tumpang", 1)));
+    const string pathSnap = "bench_potret.snap";
+    cout << "\n⏱️  === BENCHMARK POTRET (seed " << seed << ") ===" << endl;
+    cout << nItem << " item, " << nMember << " member, " << nThread << " thread transaksi, " << detik
+         << " s per mode" << endl;
+
+    vector<string> idItem(nItem), idMember(nMember);
+    for (size_t i = 0; i < nItem; i++) idItem[i] = "B" + to_string(i);
+    for (size_t m = 0; m < nMember; m++) idMember[m] = "U" + to_string(m);
+
+    enum Mode { TANPA, EXCLUSIVE, POTRET, JUMLAH_MODE };
+    static const char* NAMA_MODE[JUMLAH_MODE] = {"tanpa backup", "exclusive", "potret"};
+    cout << setw(14) << left << "mode" << right << setw(12) << "transaksi/s" << setw(10) << "p50 us" << setw(10)
+         << "p99 us" << setw(11) << "max us" << setw(8) << "simpan" << setw(11) << "ms/simpan" << "  konsisten"
+         << endl;
+
+    for (int mode = 0; mode < JUMLAH_MODE; mode++) {
+        Perpustakaan perpus;
+        perpus.setJam([] { return int32_t(20000); });
+        perpus.reserve(nItem, nMember);
+        mt19937_64 rng(seed);
+        for (size_t i = 0; i < nItem; i++) {
+            perpus.tambahItem(Book(idItem[i], "Buku " + idItem[i], "Penulis " + to_string(i % 997), rng() % 20 == 0));
+        }
+        for (size_t m = 0; m < nMember; m++) {
+            perpus.registerMember(make_unique<Member>(idMember[m], "Member " + to_string(m)));
+        }
+
+        atomic<bool> berhenti{false};
+        vector<vector<uint32_t>> lat(nThread);
+        vector<thread> pekerja;
+        for (unsigned t = 0; t < nThread; t++) {
+            pekerja.emplace_back([&, t] {
+                mt19937_64 r(seed * 1000003 + t);
+                vector<pair<uint32_t, uint32_t>> pinjaman;
+                size_t batasPinjaman = max<size_t>(1, nItem / (4 * nThread));
+                lat[t].reserve(1 << 20);
+                while (!berhenti.load(memory_order_relaxed)) {
+                    bool balik = !pinjaman.empty() && (r() % 100 < 45 || pinjaman.size() >= batasPinjaman);
+                    auto mulai = chrono::steady_clock::now();
+                    if (balik) {
+                        size_t idx = r() % pinjaman.size();
+                        auto [i, m] = pinjaman[idx];
+                        pinjaman[idx] = pinjaman.back();
+                        pinjaman.pop_back();
+                        perpus.prosesKembali(idMember[m], idItem[i], 1 + static_cast<int>(r() % 20));
+                    } else {
+                        uint32_t i = static_cast<uint32_t>(r() % nItem);
+                        uint32_t m = static_cast<uint32_t>(r() % nMember);
+                        if (perpus.prosesPinjam(idMember[m], idItem[i], 1 + static_cast<int>(r() % 7), false).ok()) {
+                            pinjaman.push_back({i, m});
+                        }
+                    }
+                    auto lama = chrono::steady_clock::now() - mulai;
+                    lat[t].push_back(static_cast<uint32_t>(chrono::duration_cast<chrono::nanoseconds>(lama).count()));
+                }
+            });
+        }
+
+        // mode potret: `tumpang` thread laporan tambahan yang selalu megang
+        // potret (yang baru dibikin dulu, baru yang lama dilepas) - dulu bikin
+        // potret jadi nunggu dan versi lamanya ga pernah dibuang
+        atomic<size_t> versiMaks{0};
+        vector<thread> pelapor;
+        for (unsigned t = 0; mode == POTRET && t < nTumpang; t++) {
+            pelapor.emplace_back([&] {
+                auto p = perpus.potret();
+                while (!berhenti.load(memory_order_relaxed)) {
+                    this_thread::sleep_for(chrono::milliseconds(20));
+                    p = perpus.potret();
+                    size_t v = perpus.jumlahVersiLama();
+                    if (v > versiMaks.load()) versiMaks.store(v);
+                }
+            });
+        }
+
+        size_t nSimpan = 0;
+        double waktuSimpan = 0.0;
+        bool ok = true;
+        auto awal = chrono::steady_clock::now();
+        auto lewat = [&] { return chrono::duration<double>(chrono::steady_clock::now() - awal).count(); };
+        if (mode == TANPA) {
+            this_thread::sleep_for(chrono::duration<double>(detik));
+        } else {
+            while (lewat() < detik) {
+                waktuSimpan += ukurDetik([&] {
+                    ok &= mode == POTRET ? perpus.simpanSnapshot(pathSnap) : perpus.checkpoint(pathSnap);
+                });
+                nSimpan++;
+            }
+        }
+        berhenti = true;
+        for (auto& p : pekerja) p.join();
+        for (auto& p : pelapor) p.join();
+        double total = lewat();
+
+        // snapshot terakhir diambil pas transaksi lagi jalan - cek invariannya
+        string konsisten = "-";
+        if (mode != TANPA) {
+            Perpustakaan cek;
+            if (!ok || !cek.muatSnapshot(pathSnap)) {
+                konsisten = "❌ gagal simpan/muat";
+            } else {
+                long long belumBalik = 0, ditempat = 0;
+                for (const string& id : idMember) {
+                    const Member* m = cek.cariMemberById(id);
+                    belumBalik += m->getTotalPinjaman() - m->getPinjamanSukses();
+                }
+                for (const string& id : idItem) ditempat += !cek.cariItemById(id).isTersedia();
+                long long aktif = static_cast<long long>(cek.jumlahPinjamanAktif());
+                konsisten = belumBalik == aktif && ditempat == aktif ? "✅ " + to_string(aktif) + " aktif"
+                                                                       : "❌ " + to_string(belumBalik) + "/" +
+                                                                             to_string(aktif) + "/" + to_string(ditempat);
+            }
+            remove(pathSnap.c_str());
+        }
+
+        vector<uint32_t> semua;
+        for (const auto& v : lat) semua.insert(semua.end(), v.begin(), v.end());
+        sort(semua.begin(), semua.end());
+        cout << setw(14) << left << NAMA_MODE[mode] << right << fixed << setprecision(0) << setw(12)
+             << semua.size() / total << setprecision(2) << setw(10) << persentil(semua, 0.50) / 1e3 << setw(10)
+             << persentil(semua, 0.99) / 1e3 << setw(11) << (semua.empty() ? 0.0 : semua.back() / 1e3) << setw(8)
+             << nSimpan << setw(11) << (nSimpan ? waktuSimpan * 1e3 / nSimpan : 0.0) << "  " << konsisten << endl;
+        if (!pelapor.empty()) {
+            cout << "  " << pelapor.size() << " laporan tumpang tindih, versi lama maks " << versiMaks.load()
+                 << ", sisa " << perpus.jumlahVersiLama() << endl;
+        }
+    }
+}
+
+// skala 1..N thread buat kerjaan sekatalog yang lewat KolamParalel: impor
+// alat (cek format paralel, masukin tetep serial), bangun 3 indeks urut
+// abis bulk load, batch pinjam + balikin (validasi paralel, nerapin
+// serial), agregat + top-K riwayat per tipe. tiap jumlah thread pake kolam
+// sendiri, hasilnya dicocokin sama yang 1 thread
+void benchmarkParalel(const OpsiBench& opsi) {
+    const size_t nItem = max<long long>(1, opsi.angka("item", 10000000));
+    const size_t nMember = max<long long>(1, opsi.angka("member", 100000));
+    const size_t nBatch = max<long long>(1, opsi.angka("batch", 1000000));
+    const size_t nRiwayat = max<long long>(1, opsi.angka("riwayat", 5000000));
+    const unsigned maksThread = static_cast<unsigned>(
+        max<long long>(1, opsi.angka("thread", max(4u, thread::hardware_concurrency()))));
+    const uint64_t seed = static_cast<uint64_t>(opsi.angka("seed", 42));
+    const string path = "bench_paralel.txt";
+    cout << "\n⏱️  === BENCHMARK PARALEL (" << nItem << " item, " << nMember << " member, batch " << nBatch
+         << ", riwayat " << nRiwayat << ", " << thread::hardware_concurrency() << " core) ===" << endl;
+
+    // ID + nama diacak biar urutan ID / judul ga sama kaya urutan masuk
+    mt19937_64 rng(seed);
+    vector<uint32_t> acak(nItem);
+    for (size_t i = 0; i < nItem; i++) acak[i] = static_cast<uint32_t>(i);
+    shuffle(acak.begin(), acak.end(), rng);
+    {
+        static const char* const NAMA[] = {"Mikroskop", "Osiloskop", "Multimeter", "Tabung", "Neraca", "Pipet"};
+        string isi;
+        isi.reserve(nItem * 40);
+        for (size_t i = 0; i < nItem; i++) {
+            bool elektronik = acak[i] & 1;
+            isi += elektronik ? "Elektronik " : "NonElektronik ";
+            isi += NAMA[acak[i] % 6];
+            isi += to_string(acak[(i * 7919) % nItem]);
+            isi += " A" + to_string(acak[i]);
+            isi += elektronik ? " 220 1\n" : " kaca 1\n";
+        }
+        ofstream(path, ios::binary) << isi;
+    }
+
+    vector<string> idMember(nMember), idBatch(nBatch);
+    for (size_t m = 0; m < nMember; m++) idMember[m] = "U" + to_string(m);
+    for (size_t i = 0; i < nBatch; i++) idBatch[i] = "A" + to_string(rng() % nItem);
+    vector<PermintaanTransaksi> pinjam(nBatch), balik(nBatch);
+    for (size_t i = 0; i < nBatch; i++) {
+        string_view m = idMember[rng() % nMember];
+        pinjam[i] = {PermintaanTransaksi::PINJAM, false, 7, m, idBatch[i]};
+        balik[i] = {PermintaanTransaksi::KEMBALI, false, 5, m, idBatch[i]};
+    }
+
+    // riwayat sintetis: tag item acak, hari naik pelan2
+    vector<uint8_t> tag(nItem);
+    for (uint8_t& t : tag) t = static_cast<uint8_t>(1 + rng() % (JUMLAH_KODE_TIPE - 1));
+    auto tagFn = [&](uint32_t slot) { return tag[slot]; };
+    RiwayatPinjaman riwayat;
+    riwayat.reserve(nMember);
+    for (size_t m = 0; m < nMember; m++) riwayat.tambahMember();
+    for (size_t i = 0; i < nRiwayat; i++) {
+        uint32_t slot = static_cast<uint32_t>(rng() % nItem);
+        uint32_t telat = rng() % 10 == 0 ? static_cast<uint32_t>(1 + rng() % 14) : 0;
+        riwayat.catat(static_cast<uint32_t>(rng() % nMember), slot, tag[slot],
+                      static_cast<int32_t>(i * 1095 / nRiwayat), telat, telat * 1000);
+    }
+
+    vector<unsigned> daftarThread;
+    for (unsigned t = 1; t < maksThread; t *= 2) daftarThread.push_back(t);
+    daftarThread.push_back(maksThread);
+
+    cout << setw(7) << "thread" << setw(10) << "impor s" << setw(10) << "indeks s" << setw(10) << "batch s"
+         << setw(11) << "denda ms" << setw(13) << "agregat ms" << setw(10) << "top ms"
+         << "   speedup (impor/indeks/batch/denda/agregat/top)" << endl;
+    array<double, 6> dasar{};
+    vector<string> halamanDasar;
+    size_t suksesDasar = 0;
+    double dendaDasar = 0.0;
+    RiwayatPinjaman::Agregat agregatDasar;
+    vector<RiwayatPinjaman::Peringkat> topDasar;
+    for (unsigned t : daftarThread) {
+        KolamParalel kolam(t);
+        array<double, 6> waktu{};
+        vector<string> halaman;
+        size_t sukses = 0;
+        double denda = 0.0;
+        RiwayatPinjaman::Agregat agregat;
+        vector<RiwayatPinjaman::Peringkat> top;
+        {
+            Perpustakaan perpus;
+            perpus.pakaiArena();
+            perpus.pasangKolamParalel(&kolam);
+            int32_t hari = 20000;
+            perpus.setJam([&hari] { return hari; });
+            waktu[0] = ukurDetik([&] { perpus.imporAlat(path); });
+            // halaman pertama urut judul = bangun indeks urut yang ketunda abis impor
+            waktu[1] = ukurDetik([&] { halaman = perpus.halamanKatalog(UrutKatalog::JUDUL, 0, 10); });
+            for (const string& id : idMember) perpus.registerMember(perpus.buatMember(id, "Member " + id));
+            waktu[2] = ukurDetik([&] {
+                for (const HasilTransaksi& h : perpus.prosesBatch(pinjam.data(), nBatch)) sukses += h.ok();
+            });
+            // sebulan kemudian semua pinjaman telat: denda pertama = pop semua
+            // jadwal jatuh tempo + jumlahin per shard
+            hari += 30;
+            waktu[3] = ukurDetik([&] { denda = perpus.dendaTerakru(); });
+            waktu[2] += ukurDetik([&] {
+                for (const HasilTransaksi& h : perpus.prosesBatch(balik.data(), nBatch)) sukses += h.ok();
+            });
+        }
+        waktu[4] = ukurDetik([&] { agregat = riwayat.agregat(RiwayatPinjaman::AWAL_WAKTU, RiwayatPinjaman::AKHIR_WAKTU,
+                                                             Book::KODE, tagFn, kolam); });
+        waktu[5] = ukurDetik([&] { top = riwayat.top(10, DVD::KODE, 365, 729, tagFn, kolam); });
+
+        bool sama = true;
+        if (t == 1) {
+            dasar = waktu;
+            halamanDasar = halaman;
+            suksesDasar = sukses;
+            dendaDasar = denda;
+            agregatDasar = agregat;
+            topDasar = top;
+        } else {
+            sama = halaman == halamanDasar && sukses == suksesDasar && denda == dendaDasar && agregat.jumlah == agregatDasar.jumlah &&
+                   agregat.telat == agregatDasar.telat && agregat.denda == agregatDasar.denda &&
+                   top.size() == topDasar.size();
+            for (size_t i = 0; sama && i < top.size(); i++) {
+                sama = top[i].slotMember == topDasar[i].slotMember && top[i].jumlah == topDasar[i].jumlah;
+            }
+        }
+        cout << setw(7) << t << fixed << setprecision(2) << setw(10) << waktu[0] << setw(10) << waktu[1] << setw(10)
+             << waktu[2] << setw(11) << waktu[3] * 1e3 << setw(13) << waktu[4] * 1e3 << setw(10) << waktu[5] * 1e3
+             << "   " << setprecision(2);
+        for (size_t k = 0; k < waktu.size(); k++) cout << (k ? "/" : "") << dasar[k] / waktu[k] << "x";
+        cout << (sama ? "" : "  ❌ hasil beda!") << endl;
+    }
+    remove(path.c_str());
+}
+
+// ID luar -> handle: cari ID pendek (dipadetin ke kunci hash, ga buka objek)
+// vs ID panjang (hash + bandingin string), terus pinjam+balik lewat ID string
+// vs lewat handle yang di-resolve sekali di depan
+void benchmarkHandle(const OpsiBench& opsi) {
+    const size_t nItem = max<long long>(2, opsi.angka("item", 500000));
+    const size_t nMember = max<long long>(1, opsi.angka("member", 10000));
+    const size_t nOp = max<long long>(1, opsi.angka("op", 2000000));
+    const uint64_t seed = static_cast<uint64_t>(opsi.angka("seed", 42));
+    cout << "\n⏱️  === BENCHMARK HANDLE ID (" << nItem << " item, " << nMember << " member, " << nOp
+         << " op) ===" << endl;
+
+    // slot genap ID pendek ("B123", <= 7 byte), slot ganjil ID panjang
+    vector<string> idItem(nItem), idMember(nMember);
+    for (size_t i = 0; i < nItem; i++) {
+        idItem[i] = (i & 1) ? "BUKU-LANGKA-" + to_string(i / 2) : "B" + to_string(i / 2);
+    }
+    for (size_t m = 0; m < nMember; m++) idMember[m] = "M" + to_string(m);
+
+    Perpustakaan perpus;
+    perpus.setJam([] { return int32_t(20000); });
+    perpus.reserve(nItem, nMember);
+    for (size_t i = 0; i < nItem; i++) {
+        perpus.tambahItem(Book(idItem[i], "Buku " + to_string(i), "Penulis " + to_string(i % 997)));
+    }
+    for (size_t m = 0; m < nMember; m++) perpus.registerMember(make_unique<Member>(idMember[m], "Member " + idMember[m]));
+
+    mt19937_64 rng(seed);
+    vector<uint32_t> acak(nOp);
+    for (auto& a : acak) a = static_cast<uint32_t>(rng() % nItem);
+
+    cout << setw(16) << left << "cari ID" << right << setw(10) << "ns/op" << endl;
+    for (size_t panjang = 0; panjang < 2; panjang++) {
+        size_t ketemu = 0;
+        double t = ukurDetik([&] {
+            for (uint32_t a : acak) {
+                ketemu += (perpus.handleItem(idItem[(a & ~1u) | panjang]) & Perpustakaan::SLOT_HANDLE) ==
+                          a - (a & 1) + panjang;
+            }
+        });
+        cout << setw(16) << left << (panjang ? "panjang (> 7)" : "pendek (<= 7)") << right << setw(10) << fixed
+             << setprecision(1) << t * 1e9 / nOp << (ketemu == nOp ? "" : "  ❌ handle salah!") << endl;
+    }
+
+    vector<Perpustakaan::Handle> hItem(nItem), hMember(nMember);
+    double tResolve = ukurDetik([&] {
+        for (size_t i = 0; i < nItem; i++) hItem[i] = perpus.handleItem(idItem[i]);
+        for (size_t m = 0; m < nMember; m++) hMember[m] = perpus.handleMember(idMember[m]);
+    });
+    cout << "resolve " << nItem + nMember << " handle sekali: " << setprecision(1) << tResolve * 1e3 << " ms" << endl;
+
+    // tiap op = pinjam + langsung balik, jadi item-nya selalu ada di rak lagi
+    size_t sukses[2] = {0, 0};
+    double t[2];
+    t[0] = ukurDetik([&] {
+        for (size_t q = 0; q < nOp; q++) {
+            const string& m = idMember[q % nMember];
+            sukses[0] += perpus.prosesPinjam(m, idItem[acak[q]], 7).ok();
+            sukses[0] += perpus.prosesKembali(m, idItem[acak[q]], 5).ok();
+        }
+    });
+    t[1] = ukurDetik([&] {
+        for (size_t q = 0; q < nOp; q++) {
+            Perpustakaan::Handle m = hMember[q % nMember];
+            sukses[1] += perpus.prosesPinjam(m, hItem[acak[q]], 7).ok();
+            sukses[1] += perpus.prosesKembali(m, hItem[acak[q]], 5).ok();
+        }
+    });
+    size_t totalPinjam = 0;
+    {
+        auto p = perpus.potret();
+        for (const auto& pair : p->getPinjamanPerTipe()) totalPinjam += pair.second;
+    }
+
+    cout << setw(16) << left << "pinjam+balik" << right << setw(10) << "ns/op" << setw(10) << "sukses" << endl;
+    cout << setw(16) << left << "lewat ID" << right << setw(10) << t[0] * 1e9 / nOp << setw(10) << sukses[0] << endl;
+    cout << setw(16) << left << "lewat handle" << right << setw(10) << t[1] * 1e9 / nOp << setw(10) << sukses[1]
+         << "   (" << t[0] / t[1] << "x)" << endl;
+    bool cocok = sukses[0] == 2 * nOp && sukses[1] == 2 * nOp && totalPinjam == 2 * nOp;
+    cout << (cocok ? "✅ hasil + statistik per tipe cocok" : "❌ hasil beda!") << endl;
+
+    // abis muat snapshot slot-nya keisi record yang sama lagi, tapi handle
+    // lama tetep harus ditolak - yang baru di-resolve ulang jalan normal
+    const string pathSnap = "bench_handle.snap";
+    bool basiDitolak = false;
+    if (perpus.simpanSnapshot(pathSnap) && perpus.muatSnapshot(pathSnap)) {
+        basiDitolak = perpus.prosesPinjam(hMember[0], hItem[0], 7).status == StatusTransaksi::MEMBER_TIDAK_ADA &&
+                      perpus.prosesPinjam(perpus.handleMember(idMember[0]), perpus.handleItem(idItem[0]), 7).ok();
+    }
+    remove(pathSnap.c_str());
+    cout << (basiDitolak ? "✅ handle basi ditolak abis muat snapshot" : "❌ handle basi lolos!") << endl;
+}
+
+int jalankanBenchmark(const string& nama, const OpsiBench& opsi = OpsiBench()) {
+    if (nama == "handle") {
+        benchmarkHandle(opsi);
+        return 0;
+    }
+    if (nama == "paralel") {
+        benchmarkParalel(opsi);
+        return 0;
+    }
+    if (nama == "potret") {
+        benchmarkPotret(opsi);
+        return 0;
+    }
+    if (nama == "riwayat") {
+        benchmarkRiwayat(opsi);
+        return 0;
+    }
+    if (nama == "eksemplar") {
+        benchmarkEksemplar(opsi);
+        return 0;
+    }
+    if (nama == "metrik") {
+        benchmarkMetrik();
+        return 0;
+    }
+#ifdef PERPUS_EPOLL
+    if (nama == "server") {
+        benchmarkServer(opsi);
+        return 0;
+    }
+#endif
+    if (nama == "headless") {
+        benchmarkHeadless(opsi);
+        return 0;
+    }
+    if (nama == "beban") {
+        benchmarkBeban(opsi);
+        return 0;
+    }
+    if (nama == "jatuhtempo") {
+        benchmarkJatuhTempo();
+        return 0;
+    }
+    if (nama == "laporan") {
+        benchmarkLaporan();
+        return 0;
+    }
+    if (nama == "arena") {
+        benchmarkArena();
+        return 0;
+    }
+    if (nama == "tersedia") {
+        benchmarkTersedia();
+        return 0;
+    }
+    if (nama == "kolom") {
+        benchmarkKolom();
+        return 0;
+    }
+    if (nama == "listing") {
+        benchmarkListing();
+        return 0;
+    }
+    if (nama == "urut") {
+        benchmarkUrut();
+        return 0;
+    }
+    if (nama == "cari") {
+        benchmarkCari();
+        return 0;
+    }
+    if (nama == "kebijakan") {
+        benchmarkKebijakan();
+        return 0;
+    }
+    if (nama == "batch") {
+        benchmarkBatch();
+        return 0;
+    }
+    if (nama == "stres") {
+        benchmarkStres();
+        return 0;
+    }
+    if (nama == "impor") {
+        benchmarkImpor();
+        return 0;
+    }
+    if (nama == "lookup") {
+        benchmarkLookup();
+        return 0;
+    }
+    if (nama == "snapshot") {
+        benchmarkSnapshot();
+        return 0;
+    }
+    cout << "❌ Benchmark '" << nama << "' ga dikenal. Pilihan: lookup, snapshot, impor, stres, batch, kolom, tersedia, arena, laporan, jatuhtempo, kebijakan, cari, urut, listing, beban, headless, server, metrik, eksemplar, riwayat, potret, paralel, handle" << endl;
+    return 1;
+}
+
+// ===========================
+// MAIN FUNCTION
+// ===========================
+int main(int argc, char* argv[]) {
+    string pathKebijakan = FILE_KEBIJAKAN;
+    bool kebijakanWajib = false;
+    const char* namaBench = nullptr;
+    const char* pathHeadless = nullptr;
+    const char* alamatServer = nullptr;
+    const char* pathEvent = nullptr;
+    unsigned nPekerja = max(1u, thread::hardware_concurrency());
+    bool headlessBiner = false, headlessPersisten = true;
+    OpsiBench opsiBench;  // --<kunci> <nilai> lainnya buat benchmark
+    for (int i = 1; i + 1 < argc; i += 2) {
+        string opsi = argv[i];
+        if (opsi == "--kebijakan") {
+            pathKebijakan = argv[i + 1];
+            kebijakanWajib = true;
+        } else if (opsi == "--bench") {
+            namaBench = argv[i + 1];
+        } else if (opsi == "--headless") {
+            pathHeadless = argv[i + 1];
+        } else if (opsi == "--format") {
+            headlessBiner = string(argv[i + 1]) == "biner";
+        } else if (opsi == "--persisten") {
+            headlessPersisten = string(argv[i + 1]) != "0";
+        } else if (opsi == "--server") {
+            alamatServer = argv[i + 1];
+        } else if (opsi == "--event") {
+            pathEvent = argv[i + 1];
+        } else if (opsi == "--metrik") {
+            metrik.setPeriodeSampel(static_cast<uint32_t>(max(0, atoi(argv[i + 1]))));
+        } else if (opsi == "--paralel") {
+            ukuranKolamParalel = static_cast<unsigned>(max(1, atoi(argv[i + 1])));
+        } else if (opsi == "--pekerja") {
+            nPekerja = static_cast<unsigned>(max(1, atoi(argv[i + 1])));
+        } else if (opsi.size() > 2 && opsi.compare(0, 2, "--") == 0) {
+            opsiBench.nilai.insert_or_assign(opsi.substr(2), argv[i + 1]);
+        }
+    }
+
+    // tabel kebijakan harus udah final sebelum ada item/transaksi. file-nya
+    // ada tapi salah format = mending berhenti daripada denda ngaco
+    ifstream cekKebijakan(pathKebijakan);
+    if (kebijakanWajib || cekKebijakan.good()) {
+        string pesan;
+        if (!muatKebijakan(pathKebijakan, kebijakanAktif, pesan)) {
+            (pathHeadless ? cerr : cout) << "❌ Kebijakan " << pathKebijakan << " gagal dimuat - " << pesan << endl;
+            return 1;
+        }
+        // mode headless: stdout cuma buat jawaban
+        (pathHeadless ? cerr : cout) << "⚖️  Kebijakan denda dimuat dari " << pathKebijakan << endl;
+    }
+
+    // mode benchmark: ./sistem --bench <nama>
+    if (namaBench) {
+        return jalankanBenchmark(namaBench, opsiBench);
+    }
+
+    // mode headless: ./sistem --headless <path|->
+    if (pathHeadless) {
+        return modeHeadless(pathHeadless, headlessBiner, headlessPersisten, pathEvent);
+    }
+
+    // mode server: ./sistem --server unix:/tmp/perpus.sock
+    if (alamatServer) {
+#ifdef PERPUS_EPOLL
+        return modeServer(alamatServer, nPekerja, headlessPersisten);
+#else
+        cout << "❌ Mode server butuh epoll (Linux)" << endl;
+        return 1;
+#endif
+    }
+
+    Perpustakaan perpus;
+    int pilihan;
+
+    // menu interaktif: pesan tiap transaksi langsung tampil ke layar
+    SinkTeks sinkKonsol(cout, true);
+    perpus.pasangSink(&sinkKonsol);
+
+    // Auto-run test cases
+    cout << "Mau langsung run test cases? (1=Ya, 0=Tidak): ";
+    int runTest;
+    cin >> runTest;
+    cin.ignore();
+
+    // test case butuh katalog kosong (ID-nya fix, status pinjamnya diasumsiin
+    // dari awal) - jadi sesi test ga muat snapshot/WAL dan ga nyimpen pas
+    // keluar, data beneran di disk ga kesentuh
+    bool sesiTest = runTest == 1;
+    if (sesiTest) {
+        runTestCases(perpus);
+    } else {
+        // lanjutin data sesi sebelumnya kalo ada
+        if (perpus.muatSnapshot(FILE_SNAPSHOT)) {
+            cout << "📂 Data sesi sebelumnya berhasil dimuat dari " << FILE_SNAPSHOT << endl;
+        }
+        size_t dipulihkan = perpus.aktifkanLog(FILE_LOG);
+        if (dipulihkan > 0) {
+            cout << "🔁 " << dipulihkan << " transaksi dipulihin dari " << FILE_LOG << endl;
+        }
+    }
+
+    // Main menu loop
+    while (true) {
+        if (perpus.logRusak()) {
+            cout << "⚠️  " << FILE_LOG << " gagal ditulis - transaksi baru ga tahan crash, simpan (menu 11) dulu" << endl;
+        }
+        tampilkanMenu();
+        cin >> pilihan;
+        cin.ignore();
+
+        if (pilihan == 0) {
+            if (!sesiTest && !perpus.checkpoint(FILE_SNAPSHOT)) {
+                cout << "⚠️  Gagal nyimpen data ke " << FILE_SNAPSHOT << endl;
+            }
+            cout << "Makasih udah pake sistem perpustakaan! Bye~" << endl;
+            break;
+        }
+
+        switch (pilihan) {
+            case 1: {  // Tambah item
+                cout << "Tipe item (1=Book, 2=Magazine, 3=DVD, 4=Alat): ";
+                int tipe;
+                cin >> tipe;
+                cin.ignore();
+
+                string id, judul;
+                cout << "ID: "; getline(cin, id);
+                cout << "Judul: "; getline(cin, judul);
+
+                if (tipe == 1) {
+                    string penulis;
+                    bool langka;
+                    cout << "Penulis: "; getline(cin, penulis);
+                    cout << "Langka? (1=Ya, 0=Tidak): "; cin >> langka;
+                    perpus.tambahItem(Book(id, judul, penulis, langka));
+                } else if (tipe == 2) {
+                    string edisi;
+                    cout << "Edisi: "; getline(cin, edisi);
+                    perpus.tambahItem(Magazine(id, judul, edisi));
+                } else if (tipe == 3) {
+                    string sutradara;
+                    cout << "Sutradara: "; getline(cin, sutradara);
+                    perpus.tambahItem(DVD(id, judul, sutradara));
+                } else if (tipe == 4) {
+                    int elektronik;
+                    string spesifikasi;
+                    cout << "Elektronik? (1=Ya, 0=Tidak): "; cin >> elektronik;
+                    cin.ignore();
+                    cout << (elektronik == 1 ? "Daya: " : "Bahan: "); getline(cin, spesifikasi);
+                    perpus.tambahItem(Alat(id, judul, elektronik == 1, spesifikasi));
+                }
+                break;
+            }
+            case 2: {  // Register member
+                string id, nama;
+                cout << "ID Member: "; getline(cin, id);
+                cout << "Nama: "; getline(cin, nama);
+                perpus.registerMember(make_unique<Member>(id, nama));
+                break;
+            }
+            case 3:  // Tampilkan katalog
+                perpus.tampilkanKatalog();
+                break;
+            case 4:  // Tampilkan member
+                perpus.tampilkanMember();
+                break;
+            case 5: {  // Pinjam item
+                string idMember, idItem;
+                int hari, pakeKredit;
+                cout << "ID Member: "; getline(cin, idMember);
+                cout << "ID Item: "; getline(cin, idItem);
+                cout << "Berapa hari: "; cin >> hari;
+                cout << "Pake kredit gratis? (1=Ya, 0=Tidak): "; cin >> pakeKredit;
+                perpus.prosesPinjam(idMember, idItem, hari, pakeKredit == 1);
+                break;
+            }
+            case 6: {  // Kembalikan item
+                string idMember, idItem;
+                int hariAktual;
+                cout << "ID Member: "; getline(cin, idMember);
+                cout << "ID Item: "; getline(cin, idItem);
+                cout << "Berapa hari actual pinjam: "; cin >> hariAktual;
+                perpus.prosesKembali(idMember, idItem, hariAktual);
+                break;
+            }
+            case 7: {  // Kembalikan DVD dengan cek rusak
+                string idMember, idDVD;
+                int hariAktual, rusak;
+                cout << "ID Member: "; getline(cin, idMember);
+                cout << "ID DVD: "; getline(cin, idDVD);
+                cout << "Berapa hari actual: "; cin >> hariAktual;
+                cout << "Rusak? (1=Ya, 0=Tidak): "; cin >> rusak;
+                perpus.prosesKembaliDVD(idMember, idDVD, hariAktual, rusak == 1);
+                break;
+            }
+            case 8:  // Sort katalog
+                perpus.sortKatalog();
+                break;
+            case 9:  // Laporan bulanan
+                perpus.laporanBulanan();
+                break;
+            case 10:  // Reset statistik
+                perpus.resetStatistikBulanan();
+                break;
+            case 11:  // Simpan snapshot
+                if (sesiTest) {
+                    cout << "❌ Sesi test case ga disimpen, biar " << FILE_SNAPSHOT << " ga ketimpa data test" << endl;
+                } else if (perpus.checkpoint(FILE_SNAPSHOT)) {
+                    cout << "💾 Data tersimpan di " << FILE_SNAPSHOT << endl;
+                } else {
+                    cout << "❌ Gagal nyimpen data!" << endl;
+                }
+                break;
+            case 12: {  // Impor alat dari file
+                string path;
+                cout << "Path file (kosong = alat.txt): "; getline(cin, path);
+                if (path.empty()) path = "alat.txt";
+                HasilImpor hasil = perpus.imporAlat(path);
+                cout << "📥 " << hasil.sukses << " alat berhasil diimpor dari "
+                     << hasil.totalBaris << " baris" << endl;
+                for (const auto& e : hasil.error) {
+                    cout << "  ❌ baris " << e.baris << ": " << e.pesan << endl;
+                }
+                if (hasil.jumlahError > hasil.error.size()) {
+                    cout << "  ... dan " << (hasil.jumlahError - hasil.error.size())
+                         << " error lainnya" << endl;
+                }
+                break;
+            }
+            case 13:  // Riwayat laporan per bulan + arsip
+                perpus.laporanRiwayat();
+                break;
+            case 14:  // Pinjaman yang lewat jatuh tempo
+                perpus.tampilkanTerlambat();
+                break;
+            case 15: {  // Cari item lewat kata kunci
+                string query;
+                int hanyaTersedia;
+                cout << "Kata kunci: "; getline(cin, query);
+                cout << "Cuma yang tersedia? (1=Ya, 0=Tidak): "; cin >> hanyaTersedia;
+                perpus.tampilkanHasilCari(query, hanyaTersedia == 1);
+                break;
+            }
+            case 16: {  // Ekspor katalog / member buat diolah tool lain
+                int apa, format;
+                string path;
+                cout << "Ekspor apa? (1=Katalog, 2=Member): "; cin >> apa;
+                cout << "Format (1=CSV, 2=JSON Lines): "; cin >> format;
+                cin.ignore();
+                cout << "Nama file: "; getline(cin, path);
+                FormatListing fmt = format == 2 ? FormatListing::JSONL : FormatListing::CSV;
+                bool ok = apa == 2 ? perpus.eksporMember(path, fmt) : perpus.eksporKatalog(path, fmt);
+                if (ok) cout << "✅ Diekspor ke " << path << endl;
+                else cout << "❌ Gagal nulis " << path << endl;
+                break;
+            }
+            case 17: {  // Metrik operasi + dump Prometheus
+                tampilkanMetrik(metrik.baca());
+                string path;
+                cout << "Dump format Prometheus ke file (kosong = ga usah): "; getline(cin, path);
+                if (path.empty()) break;
+                if (dumpMetrikPrometheus(path)) cout << "✅ Metrik ditulis ke " << path << endl;
+                else cout << "❌ Gagal nulis " << path << endl;
+                break;
+            }
+            case 18: {  // Antrean reservasi + jumlah eksemplar per judul
+                int aksi;
+                string idItem;
+                cout << "1=Reservasi, 2=Atur jumlah eksemplar, 3=Lihat antrean: "; cin >> aksi;
+                cin.ignore();
+                cout << "ID Item: "; getline(cin, idItem);
+                if (aksi == 1) {
+                    string idMember;
+                    cout << "ID Member: "; getline(cin, idMember);
+                    perpus.prosesReservasi(idMember, idItem);
+                } else if (aksi == 2) {
+                    int total;
+                    cout << "Total eksemplar: "; cin >> total;
+                    perpus.aturEksemplar(idItem, static_cast<uint32_t>(max(0, total)));
+                } else {
+                    perpus.tampilkanAntrean(idItem);
+                }
+                break;
+            }
+            case 19: {  // Riwayat pinjaman per member + top peminjam + rasio telat
+                int aksi;
+                cout << "1=Riwayat member, 2=Top peminjam, 3=Rasio telat & memori: "; cin >> aksi;
+                cin.ignore();
+                if (aksi == 1) {
+                    string idMember;
+                    cout << "ID Member: "; getline(cin, idMember);
+                    perpus.tampilkanRiwayatMember(idMember);
+                } else if (aksi == 2) {
+                    int k, tipe;
+                    cout << "Berapa member: "; cin >> k;
+                    cout << "Tipe (0=Semua, 1=Book, 2=Magazine, 3=DVD, 4=Alat): "; cin >> tipe;
+                    if (tipe < 0 || tipe >= static_cast<int>(JUMLAH_KODE_TIPE)) tipe = 0;
+                    perpus.tampilkanTopPeminjam(static_cast<size_t>(max(1, k)), static_cast<uint8_t>(tipe));
+                } else {
+                    perpus.tampilkanAnalitikRiwayat();
+                }
+                break;
+            }
+            default:
+                cout << "Pilihan ga valid bro!" << endl;
+        }
+    }
+
+    return 0;
+}